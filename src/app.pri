@@ -31,12 +31,6 @@ USE_OGDF{
 }
 
 
-USE_BOOST{
-	LIBS += -L$$BOOST_LIB_PATH -l$$BOOST_LIB_NAME
-	INCLUDEPATH += $$BOOST_INCLUDE_PATH
-}
-
-
 win32{
     LIBS += -lopengl32 -lglu32 -lshell32 -luser32 -lpsapi
 }
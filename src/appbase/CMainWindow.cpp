@@ -508,6 +508,8 @@ bool CMainWindow::doOpenDocument(const QString &fileName)
 	}
 
     // open in place (fileDocType can be changed by this fn!)
+	m_openCanceled = false;
+
     if (openDocument(normalizedName, fileDocType))
     {
 		// restore settings for this instance
@@ -525,6 +527,12 @@ bool CMainWindow::doOpenDocument(const QString &fileName)
 		return true;
 	}
 
+	if (m_openCanceled)
+	{
+		statusBar()->showMessage(tr("Opening canceled: %1").arg(fileName));
+		return false;
+	}
+
 	// failure
 	statusBar()->showMessage(tr("Failed to open: %1").arg(fileName));
 
@@ -154,6 +154,7 @@ protected:
 	QString m_lastPath;
     QByteArray m_currentDocType;
     bool m_isChanged;
+	bool m_openCanceled = false;	// set by openDocument() when canceled by user
 	QString m_mainTitleText;
 	
 	QString m_stringPID;
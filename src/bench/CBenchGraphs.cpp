@@ -0,0 +1,123 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#include "CBenchGraphs.h"
+
+#include <qvgeio/CGraphGenerators.h>
+
+#include <QtMath>
+
+#include <random>
+
+
+// raw mt19937 output only: the distributions of std differ between the implementations
+static double randomCoord(std::mt19937& rng, double range)
+{
+	return (rng() % 1000000) * range / 1000000.0;
+}
+
+
+// generators
+
+QStringList CBenchGraphs::generators()
+{
+	return { "grid", "erdos-renyi", "scale-free", "dense-hubs", "tree", "planted-partition" };
+}
+
+
+bool CBenchGraphs::generate(const QString& name, int nodeCount, Graph& graph, quint32 seed)
+{
+	graph.clear();
+
+	nodeCount = qMax(nodeCount, 4);
+
+	if (name == "grid")
+	{
+		int side = qMax(2, int(qSqrt(nodeCount)));
+		CGraphGenerators::grid(side, nodeCount / side, graph);
+		return true;
+	}
+
+	if (name == "erdos-renyi")
+	{
+		CGraphGenerators::erdosRenyi(nodeCount, nodeCount * 2, graph, seed);
+		return true;
+	}
+
+	if (name == "scale-free")
+	{
+		CGraphGenerators::barabasiAlbert(nodeCount, 2, graph, seed);
+		return true;
+	}
+
+	if (name == "dense-hubs")
+	{
+		int hubCount = qMax(2, int(qSqrt(nodeCount) / 4));
+		denseHubs(hubCount, nodeCount / hubCount - 1, 3, graph, seed);
+		return true;
+	}
+
+	if (name == "tree")
+	{
+		CGraphGenerators::tree(nodeCount, 3, graph);
+		return true;
+	}
+
+	if (name == "planted-partition")
+	{
+		// about 4 edges per node, most of them inside of the groups
+		int groupSize = qMax(2, qMin(100, nodeCount / 4));
+		int groupCount = qMax(1, nodeCount / groupSize);
+		double pIn = qMin(1.0, 7.0 / groupSize);
+		double pOut = 1.0 / nodeCount;
+		CGraphGenerators::plantedPartition(groupCount, groupSize, pIn, pOut, graph, seed);
+		return true;
+	}
+
+	return false;
+}
+
+
+void CBenchGraphs::denseHubs(int hubCount, int leavesPerHub, int multiplicity, Graph& graph, quint32 seed)
+{
+	std::mt19937 rng(seed);
+
+	double hubRange = qSqrt(hubCount) * 1000;
+	int index = 0;
+
+	QVector<int> hubs;
+
+	for (int h = 0; h < hubCount; ++h)
+	{
+		double hx = randomCoord(rng, hubRange);
+		double hy = randomCoord(rng, hubRange);
+
+		int hub = index++;
+		CGraphGenerators::addNode(graph, hub, hx, hy);
+		hubs << hub;
+
+		for (int l = 0; l < leavesPerHub; ++l)
+		{
+			double angle = l * 2 * M_PI / leavesPerHub;
+			CGraphGenerators::addNode(graph, index, hx + 300 * qCos(angle), hy + 300 * qSin(angle));
+
+			for (int k = 0; k < multiplicity; ++k)
+				CGraphGenerators::addEdge(graph, hub, index);
+
+			++index;
+		}
+	}
+
+	// hubs are densely interconnected
+	for (int h1 = 0; h1 < hubs.size(); ++h1)
+		for (int h2 = h1 + 1; h2 < hubs.size(); ++h2)
+			for (int k = 0; k < multiplicity; ++k)
+				CGraphGenerators::addEdge(graph, hubs[h1], hubs[h2]);
+}
+
@@ -0,0 +1,31 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#pragma once
+
+#include <qvgeio/CGraphBase.h>
+
+#include <QStringList>
+
+
+// Deterministic synthetic graphs by name: the same parameters & seed always give the same graph.
+// The generic ones come from CGraphGenerators.
+
+class CBenchGraphs
+{
+public:
+	// known generator names
+	static QStringList generators();
+
+	// creates graph by generator name with about `nodeCount` nodes
+	static bool generate(const QString& name, int nodeCount, Graph& graph, quint32 seed = 1);
+
+	// few hubs with many leaves each, connected by `multiplicity` parallel edges
+	static void denseHubs(int hubCount, int leavesPerHub, int multiplicity, Graph& graph, quint32 seed = 1);
+};
@@ -0,0 +1,265 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#include "CBenchRunner.h"
+#include "CBenchGraphs.h"
+
+#include <qvgelib/CNodeEditorScene.h>
+#include <qvgelib/CNode.h>
+#include <qvgelib/CFileSerializerGraphML.h>
+#include <qvgelib/CFileSerializerGEXF.h>
+#include <qvgelib/CFileSerializerDOT.h>
+#include <qvgeio/CFormatDOT.h>
+
+#include <QGuiApplication>
+#include <QElapsedTimer>
+#include <QDataStream>
+#include <QDateTime>
+#include <QImage>
+#include <QPainter>
+#include <QTextStream>
+
+#include <algorithm>
+
+
+CBenchRunner::CBenchRunner(const Options& options):
+	m_options(options)
+{
+	if (m_options.graphs.isEmpty())
+		m_options.graphs = CBenchGraphs::generators();
+
+	m_options.repeat = qMax(1, m_options.repeat);
+}
+
+
+QJsonObject CBenchRunner::run()
+{
+	m_results = QJsonArray();
+
+	CNodeEditorScene scene;
+	m_scene = &scene;
+
+	for (int size : m_options.sizes)
+	{
+		for (const QString& graphName : m_options.graphs)
+		{
+			Graph graph;
+			if (!CBenchGraphs::generate(graphName, size, graph, m_options.seed))
+			{
+				QTextStream(stderr) << "Unknown graph generator: " << graphName << endl;
+				continue;
+			}
+
+			runGraph(graphName, graph);
+		}
+	}
+
+	m_scene = nullptr;
+
+	QJsonObject report;
+	report["benchmark"] = "qvgelib";
+	report["qt"] = QString(qVersion());
+	report["platform"] = QGuiApplication::platformName();
+#ifdef QT_DEBUG
+	report["build"] = "debug";
+#else
+	report["build"] = "release";
+#endif
+	report["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+	report["seed"] = qint64(m_options.seed);
+	report["repeat"] = m_options.repeat;
+	report["results"] = m_results;
+	return report;
+}
+
+
+// cases
+
+void CBenchRunner::runGraph(const QString& graphName, const Graph& graph)
+{
+	CNodeEditorScene& scene = *m_scene;
+
+	QTextStream(stderr) << graphName << ": " << graph.nodes.size() << " nodes, " << graph.edges.size() << " edges" << endl;
+
+
+	// model <> scene
+	if (!measure("fromGraph", graphName, graph, [&] { return scene.fromGraph(graph); }))
+		scene.fromGraph(graph);
+
+	measure("toGraph", graphName, graph, [&] { Graph g; return scene.toGraph(g); });
+
+
+	// native serialization
+	QByteArray state;
+	{
+		QDataStream ds(&state, QIODevice::WriteOnly);
+		scene.storeTo(ds, true);
+	}
+
+	measure("storeTo", graphName, graph, [&]
+	{
+		QByteArray data;
+		QDataStream ds(&data, QIODevice::WriteOnly);
+		return scene.storeTo(ds, true);
+	});
+
+	measure("restoreFrom", graphName, graph, [&]
+	{
+		QDataStream ds(&state, QIODevice::ReadOnly);
+		return scene.restoreFrom(ds, true);
+	}, QJsonObject{ { "bytes", state.size() } });
+
+
+	// undo: a single node moved per step
+	scene.setInitialState();
+
+	QList<CNode*> nodes = scene.getItems<CNode>();
+	int step = 0;
+
+	if (measure("addUndoState", graphName, graph, [&]
+		{
+			if (nodes.isEmpty())
+				return false;
+
+			nodes.at(step++ % nodes.size())->moveBy(10, 0);
+			scene.addUndoState();
+			return true;
+		}))
+	{
+		QJsonObject last = m_results.last().toObject();
+		last["undoMemory"] = scene.getUndoMemoryUsage();
+		m_results.replace(m_results.size() - 1, last);
+	}
+
+
+	// file formats
+	CFileSerializerGraphML graphML;
+	QString graphMLFile = tempFile(graphName + ".graphml");
+	if (!measure("graphml.save", graphName, graph, [&] { return graphML.save(graphMLFile, scene); }))
+		graphML.save(graphMLFile, scene);
+
+	measure("graphml.load", graphName, graph, [&] { return graphML.load(graphMLFile, scene); });
+
+	CFileSerializerGEXF gexf;
+	QString gexfFile = tempFile(graphName + ".gexf");
+	if (!measure("gexf.save", graphName, graph, [&] { return gexf.save(gexfFile, scene); }))
+		gexf.save(gexfFile, scene);
+
+	measure("gexf.load", graphName, graph, [&] { return gexf.load(gexfFile, scene); });
+
+	CFileSerializerDOT dot;
+	QString dotFile = tempFile(graphName + ".dot");
+	if (!measure("dot.save", graphName, graph, [&] { return dot.save(dotFile, scene); }))
+		dot.save(dotFile, scene);
+
+	measure("dot.load", graphName, graph, [&]
+	{
+		CFormatDOT dotFormat;
+		Graph g;
+		return dotFormat.load(dotFile, g) && scene.fromGraph(g);
+	});
+
+	// the loaded graphs may be incomplete: start from the generated one again
+	scene.fromGraph(graph);
+
+
+	// labels & painting
+	measure("layoutItemLabels", graphName, graph, [&] { scene.layoutItemLabels(); return true; });
+
+	QImage image(2048, 2048, QImage::Format_ARGB32_Premultiplied);
+	measure("render", graphName, graph, [&]
+	{
+		image.fill(Qt::white);
+		QPainter painter(&image);
+		painter.setRenderHint(QPainter::Antialiasing);
+		scene.render(&painter, QRectF(), scene.itemsBoundingRect());
+		return true;
+	});
+
+
+	// 10% of the nodes selected & moved
+	QList<CItem*> selection;
+	nodes = scene.getItems<CNode>();
+	for (int i = 0; i < nodes.size(); i += 10)
+		selection << nodes.at(i);
+
+	scene.selectItems(selection);
+
+	// selection updates are delivered queued
+	QCoreApplication::processEvents();
+
+	measure("moveSelection", graphName, graph, [&]
+	{
+		scene.moveSelectedItemsBy(5, 5);
+		return true;
+	}, QJsonObject{ { "selected", selection.size() } });
+
+	scene.deselectAll();
+	QCoreApplication::processEvents();
+}
+
+
+// timing
+
+bool CBenchRunner::measure(const QString& caseName, const QString& graphName, const Graph& graph,
+	std::function<bool()> op, const QJsonObject& extra)
+{
+	if (m_options.filter.size() && !caseName.contains(m_options.filter, Qt::CaseInsensitive))
+		return false;
+
+	QJsonObject result(extra);
+	result["case"] = caseName;
+	result["graph"] = graphName;
+	result["nodes"] = graph.nodes.size();
+	result["edges"] = graph.edges.size();
+
+	QList<double> times;
+	QElapsedTimer timer;
+
+	for (int i = 0; i < m_options.repeat; ++i)
+	{
+		timer.start();
+		bool ok = op();
+		qint64 ns = timer.nsecsElapsed();
+
+		if (!ok)
+		{
+			result["status"] = "failed";
+			m_results.append(result);
+			return false;
+		}
+
+		times << ns / 1000000.0;
+	}
+
+	std::sort(times.begin(), times.end());
+
+	double sum = 0;
+	for (double t : times)
+		sum += t;
+
+	result["status"] = "ok";
+	result["runs"] = times.size();
+	result["minMs"] = times.first();
+	result["medianMs"] = times.at(times.size() / 2);
+	result["meanMs"] = sum / times.size();
+	result["maxMs"] = times.last();
+
+	m_results.append(result);
+
+	QTextStream(stderr) << "  " << caseName << ": " << result["medianMs"].toDouble() << " ms" << endl;
+
+	return true;
+}
+
+
+QString CBenchRunner::tempFile(const QString& name) const
+{
+	return m_tempDir.filePath(name);
+}
@@ -0,0 +1,59 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#pragma once
+
+#include <qvgeio/CGraphBase.h>
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QTemporaryDir>
+
+#include <functional>
+
+class CNodeEditorScene;
+
+
+// Runs the hot paths of qvgelib/qvgeio on the synthetic graphs and collects timings as JSON.
+
+class CBenchRunner
+{
+public:
+	struct Options
+	{
+		QStringList graphs;			// generator names, all if empty
+		QList<int> sizes = { 1000, 10000 };
+		int repeat = 5;
+		QString filter;				// run only the cases containing this text
+		quint32 seed = 1;
+	};
+
+	explicit CBenchRunner(const Options& options);
+
+	// runs all the cases, returns the report
+	QJsonObject run();
+
+private:
+	void runGraph(const QString& graphName, const Graph& graph);
+
+	// runs `op` options.repeat times and stores the timings;
+	// false if filtered out or if `op` failed (stored with "failed" status then, callers may redo the step)
+	bool measure(const QString& caseName, const QString& graphName, const Graph& graph,
+		std::function<bool()> op, const QJsonObject& extra = QJsonObject());
+
+	QString tempFile(const QString& name) const;
+
+	Options m_options;
+	QTemporaryDir m_tempDir;
+	QJsonArray m_results;
+	CNodeEditorScene *m_scene = nullptr;
+};
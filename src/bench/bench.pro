@@ -0,0 +1,38 @@
+# This file is a part of
+# QVGE - Qt Visual Graph Editor
+#
+# (c) 2016-2020 Ars L. Masiuk (ars.masiuk@gmail.com)
+#
+# It can be used freely, maintaining the information above.
+
+
+TEMPLATE = app
+TARGET = qvgebench
+
+CONFIG += console
+CONFIG -= app_bundle
+
+
+include($$PWD/../config.pri)
+
+
+# app sources
+SOURCES += $$files($$PWD/*.cpp)
+HEADERS += $$files($$PWD/*.h)
+
+
+# includes & libs
+INCLUDEPATH += $$PWD $$PWD/..
+
+CONFIG(debug, debug|release){
+	DESTDIR = $$OUT_PWD/../bin.debug
+	LIBS += -L$$OUT_PWD/../lib.debug
+}
+else{
+	DESTDIR = $$OUT_PWD/../bin
+	LIBS += -L$$OUT_PWD/../lib
+}
+
+CONFIG += no_lflags_merge
+LIBS += -lqvgelib -lqvgeio
+
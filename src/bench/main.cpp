@@ -0,0 +1,84 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#include <QtWidgets/QApplication>
+#include <QCommandLineParser>
+#include <QJsonDocument>
+#include <QFile>
+#include <QTextStream>
+
+#include "CBenchRunner.h"
+#include "CBenchGraphs.h"
+
+
+int main(int argc, char *argv[])
+{
+	// headless by default
+	if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+		qputenv("QT_QPA_PLATFORM", "offscreen");
+
+	QApplication a(argc, argv);
+	a.setApplicationName("qvgebench");
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription("QVGE library benchmarks, the results are written as JSON");
+	parser.addHelpOption();
+
+	QCommandLineOption graphsOption("graphs",
+		QString("Comma-separated generators: %1 (all by default).").arg(CBenchGraphs::generators().join(",")), "names");
+	QCommandLineOption sizesOption("sizes", "Comma-separated node counts (1000,10000 by default).", "counts");
+	QCommandLineOption repeatOption("repeat", "Runs per case (5 by default).", "count");
+	QCommandLineOption filterOption("filter", "Run only the cases containing the text.", "text");
+	QCommandLineOption seedOption("seed", "Seed of the random generators (1 by default).", "seed");
+	QCommandLineOption outputOption({ "o", "output" }, "Output file (stdout by default).", "file");
+	parser.addOptions({ graphsOption, sizesOption, repeatOption, filterOption, seedOption, outputOption });
+
+	parser.process(a);
+
+	CBenchRunner::Options options;
+
+	if (parser.isSet(graphsOption))
+		options.graphs = parser.value(graphsOption).split(',', QString::SkipEmptyParts);
+
+	if (parser.isSet(sizesOption))
+	{
+		options.sizes.clear();
+		for (const QString& size : parser.value(sizesOption).split(',', QString::SkipEmptyParts))
+			options.sizes << size.toInt();
+	}
+
+	if (parser.isSet(repeatOption))
+		options.repeat = parser.value(repeatOption).toInt();
+
+	if (parser.isSet(seedOption))
+		options.seed = parser.value(seedOption).toUInt();
+
+	options.filter = parser.value(filterOption);
+
+	CBenchRunner runner(options);
+	QByteArray json = QJsonDocument(runner.run()).toJson();
+
+	if (parser.isSet(outputOption))
+	{
+		QFile outFile(parser.value(outputOption));
+		if (!outFile.open(QIODevice::WriteOnly) || outFile.write(json) != json.size())
+		{
+			QTextStream(stderr) << "Cannot write " << outFile.fileName() << endl;
+			return 1;
+		}
+	}
+	else
+	{
+		QFile out;
+		out.open(stdout, QIODevice::WriteOnly);
+		out.write(json);
+	}
+
+	return 0;
+}
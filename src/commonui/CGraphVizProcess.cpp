@@ -0,0 +1,158 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#include "CGraphVizProcess.h"
+
+#include <QProcess>
+#include <QProgressDialog>
+#include <QApplication>
+
+
+CGraphVizProcess::CGraphVizProcess(const QString& pathToGraphviz):
+	m_pathToGraphviz(pathToGraphviz),
+	m_pathToDot("dot")
+{
+	if (m_pathToGraphviz.size())
+		m_pathToDot = m_pathToGraphviz + "/dot";
+}
+
+
+QString CGraphVizProcess::errorCannotRun() const
+{
+	return tr("Cannot run %1. Check if GraphViz has been correctly installed.").arg(m_pathToDot);
+}
+
+
+QString CGraphVizProcess::errorCannotFinish() const
+{
+	return tr("Execution of %1 took too long and has been therefore cancelled by user.").arg(m_pathToDot);
+}
+
+
+bool CGraphVizProcess::run(const QString& engine, const QString& format, const Writer& writer, QByteArray& output, QString* lastError) const
+{
+	return doRun(engine, format, QString(), writer, output, lastError);
+}
+
+
+bool CGraphVizProcess::run(const QString& engine, const QString& format, const QString& dotFileName, QByteArray& output, QString* lastError) const
+{
+	return doRun(engine, format, dotFileName, Writer(), output, lastError);
+}
+
+
+bool CGraphVizProcess::version(QString& output, QString* lastError) const
+{
+	QProcess process;
+	process.setProcessChannelMode(QProcess::MergedChannels);
+	process.setWorkingDirectory(m_pathToGraphviz);
+	process.start(m_pathToDot, QStringList() << "-V");
+
+	if (!process.waitForFinished(5000))
+	{
+		if (lastError)
+			*lastError = errorCannotRun();
+
+		return false;
+	}
+
+	output = QString::fromLocal8Bit(process.readAll());
+	return true;
+}
+
+
+bool CGraphVizProcess::doRun(const QString& engine, const QString& format, const QString& dotFileName, const Writer& writer, QByteArray& output, QString* lastError) const
+{
+	QStringList args;
+	args << "-K" + engine << "-T" + format;
+	if (dotFileName.size())
+		args << dotFileName;
+
+	QProcess process;
+	process.setWorkingDirectory(m_pathToGraphviz);
+	process.start(m_pathToDot, args);
+
+	if (!process.waitForStarted(1000))
+	{
+		if (lastError)
+			*lastError = errorCannotRun();
+
+		return false;
+	}
+
+	// the engine reads the text while it is being written: the writer waits when too much is buffered.
+	// the output is collected by QProcess meanwhile
+	if (writer)
+	{
+		if (!writer(process, lastError))
+		{
+			// the engine failed to read the input: its own message tells why
+			if (lastError && process.state() == QProcess::NotRunning)
+			{
+				*lastError = errorCannotRun();
+
+				QString errorText = QString::fromLocal8Bit(process.readAllStandardError()).trimmed();
+				if (errorText.size())
+					*lastError += "\n\n" + errorText;
+			}
+
+			process.kill();
+			process.waitForFinished(1000);
+			return false;
+		}
+	}
+
+	process.closeWriteChannel();
+
+	QProgressDialog progressDialog(tr("Running dot takes longer than expected.\n\nAbort execution?"), tr("Abort"), 0, 100);
+	progressDialog.setWindowModality(Qt::ApplicationModal);
+	progressDialog.setAutoReset(false);
+	progressDialog.setMinimumDuration(1000);
+
+	while (process.state() != QProcess::NotRunning)
+	{
+		process.waitForFinished(100);
+		qApp->processEvents();
+
+		if (progressDialog.wasCanceled())
+		{
+			process.kill();
+			process.waitForFinished(1000);
+
+			if (lastError)
+				*lastError = errorCannotFinish();
+
+			return false;
+		}
+
+		if (progressDialog.isVisible()) {
+			progressDialog.setValue(progressDialog.value() + 1);
+			if (progressDialog.value() > 30)
+				progressDialog.setMaximum(progressDialog.maximum() + 1);
+		}
+	}
+
+	if (process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0)
+	{
+		if (lastError)
+		{
+			*lastError = errorCannotRun();
+
+			QString errorText = QString::fromLocal8Bit(process.readAllStandardError()).trimmed();
+			if (errorText.size())
+				*lastError += "\n\n" + errorText;
+		}
+
+		return false;
+	}
+
+	// run successful
+	output = process.readAllStandardOutput();
+	return true;
+}
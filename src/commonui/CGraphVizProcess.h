@@ -0,0 +1,50 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#pragma once
+
+#include <QCoreApplication>
+#include <QString>
+#include <QByteArray>
+
+#include <functional>
+
+class QIODevice;
+
+
+// Runs a GraphViz engine through the pipes: DOT goes to its stdin, the result is read from stdout,
+// so no temporary files are written. The GUI is kept alive while it runs, a long run can be aborted.
+// The writer is held back while the engine lags behind, so the pending text stays bounded.
+
+class CGraphVizProcess
+{
+	Q_DECLARE_TR_FUNCTIONS(CGraphVizProcess)
+
+public:
+	// writes DOT into the engine's stdin
+	typedef std::function<bool(QIODevice& input, QString* lastError)> Writer;
+
+	explicit CGraphVizProcess(const QString& pathToGraphviz = QString());
+
+	// format: -T value (plain-ext, svg...)
+	bool run(const QString& engine, const QString& format, const Writer& writer, QByteArray& output, QString* lastError = nullptr) const;
+	bool run(const QString& engine, const QString& format, const QString& dotFileName, QByteArray& output, QString* lastError = nullptr) const;
+
+	// dot -V
+	bool version(QString& output, QString* lastError = nullptr) const;
+
+	QString errorCannotRun() const;
+	QString errorCannotFinish() const;
+
+private:
+	bool doRun(const QString& engine, const QString& format, const QString& dotFileName, const Writer& writer, QByteArray& output, QString* lastError) const;
+
+	QString m_pathToGraphviz;
+	QString m_pathToDot;
+};
@@ -7,7 +7,7 @@
 
 #CONFIG += USE_OGDF
 CONFIG += USE_GVGRAPH
-#CONFIG += USE_BOOST
+#CONFIG += NO_PERF_TRACE
 
 
 # external OGDF
@@ -23,21 +23,16 @@ USE_OGDF{
     OGDF_INCLUDE_PATH = "w:\Projects\qvge_github\repo\qvge.0.7.old\src\3rdParty\ogdf-2020\include"
 }
 
-# external boost::graph
-USE_BOOST{
-    DEFINES += USE_BOOST
-
-    # system-specific Boost setup
-    BOOST_LIB_NAME = boost_graph
-    BOOST_LIB_PATH =
-    BOOST_INCLUDE_PATH = /usr/share/boost/include
-}
-
 # external GraphViz (only #define)
 USE_GVGRAPH{
     DEFINES += USE_GVGRAPH
 }
 
+# compile out performance tracing (see qvgelib/CPerfTrace.h)
+NO_PERF_TRACE{
+    DEFINES += QVGE_NO_PERF_TRACE
+}
+
 
 # compiler stuff
 win32-msvc*{
@@ -51,7 +46,7 @@ gcc{
 
 
 # common config
-QT += core gui widgets xml opengl network printsupport svg
+QT += core gui widgets xml opengl network printsupport svg concurrent
 CONFIG += c++14
 
 
@@ -1,12 +1,11 @@
 #include "CDOTPreviewPage.h"
 #include "ui_CDOTPreviewPage.h"
 
+#include <commonui/CGraphVizProcess.h>
+
 #include <QFile>
-#include <QTemporaryFile>
-#include <QDir>
 #include <QTextStream>
-#include <QProgressDialog>
-#include <QProcess>
+#include <QSvgRenderer>
 
 
 CDOTPreviewPage::CDOTPreviewPage(QWidget *parent) :
@@ -33,86 +32,25 @@ CDOTPreviewPage::~CDOTPreviewPage()
 }
 
 
-QString CDOTPreviewPage::errorNotWritable(const QString &path) const
-{
-	return QObject::tr("Cannot create GraphViz output in %1. Check if the directory is writable.").arg(path);
-}
-
-
-QString CDOTPreviewPage::errorCannotRun(const QString &path) const
-{
-	return QObject::tr("Cannot run %1. Check if GraphViz has been correctly installed.").arg(path);
-}
-
-
-QString CDOTPreviewPage::errorCannotFinish(const QString &path) const
+bool CDOTPreviewPage::runPreview(const QString &engine, QByteArray &svg, QString* lastError) const
 {
-	return QObject::tr("Execution of %1 took too long and has been therefore cancelled by user.").arg(path);
-}
-
-
-bool CDOTPreviewPage::runPreview(const QString &engine, const QString &dotFilePath, QString &svgFilePath, QString* lastError) const
-{
-	// run dot to convert filename.dot -> filename.temp.svg	
-	QTemporaryFile tempFile(QDir::tempPath() + "/qvge-XXXXXX.svg");
-	if (!tempFile.open())
-	{
-		if (lastError)
-			*lastError = errorNotWritable(QDir::tempPath());
-
-		return false;
-	}
+	CGraphVizProcess graphviz;
 
-	svgFilePath = tempFile.fileName();
-	tempFile.setAutoRemove(false);
-
-	QString pathToDot = "dot";
-	//if (m_pathToGraphviz.size())
-	//	pathToDot = m_pathToGraphviz + "/dot";
-
-	QString cmd = QString("\"%1\" -K\"%2\" -Tsvg \"%3\" -o\"%4\"").arg(pathToDot, engine).arg(dotFilePath).arg(svgFilePath);
-
-	QProgressDialog progressDialog(tr("Running dot takes longer than expected.\n\nAbort execution?"), tr("Abort"), 0, 100);
-	progressDialog.setWindowModality(Qt::ApplicationModal);
-	progressDialog.setAutoReset(false);
-	progressDialog.setMinimumDuration(1000);
-
-	QProcess process;
-	//process.setWorkingDirectory(m_pathToGraphviz);
-	process.start(cmd);
-	int res = 0;
-	process.waitForStarted(1000);
-	while (process.state() != QProcess::NotRunning)
+	// edited text goes through the pipe, else dot reads the file itself
+	bool isChanged = ui->DotEditor->document()->isUndoAvailable();
+	if (isChanged || m_dotFileName.isEmpty())
 	{
-		process.waitForFinished(100);
-		qApp->processEvents();
+		QByteArray text = ui->DotEditor->toPlainText().toUtf8();
 
-		if (progressDialog.wasCanceled())
+		auto writer = [&text](QIODevice& input, QString* /*writeError*/)
 		{
-			if (lastError)
-				*lastError = errorCannotFinish(pathToDot);
+			return input.write(text) == text.size();
+		};
 
-			return false;
-		}
-
-		if (progressDialog.isVisible()) {
-			progressDialog.setValue(progressDialog.value() + 1);
-			if (progressDialog.value() > 30)
-				progressDialog.setMaximum(progressDialog.maximum() + 1);
-		}
+		return graphviz.run(engine, "svg", writer, svg, lastError);
 	}
 
-	//int res = QProcess::execute(cmd);
-	if (res != 0)
-	{
-		if (lastError)
-			*lastError = errorCannotRun(pathToDot);
-
-		return false;
-	}
-
-	// run successful
-	return true;
+	return graphviz.run(engine, "svg", m_dotFileName, svg, lastError);
 }
 
 
@@ -147,25 +85,13 @@ void CDOTPreviewPage::on_LayoutButton_activated(QVariant data)
 	m_previewScene.clear();
 
 	QString engine = data.toString();
-	QString dotFileName = m_dotFileName;
-
-	bool isChanged = ui->DotEditor->document()->isUndoAvailable();
-	if (isChanged)
-	{
-		QTemporaryFile tempFile(QDir::tempPath() + "/qdot-XXXXXX.dot");
-		tempFile.open();
-		dotFileName = tempFile.fileName();
-		tempFile.setAutoRemove(false);
-
-		QString text = ui->DotEditor->toPlainText();
-		tempFile.write(text.toUtf8());
-	}
 
 	QString lastError;
-	QString svgFileName;
-	if (runPreview(engine, dotFileName, svgFileName, &lastError))
+	QByteArray svg;
+	if (runPreview(engine, svg, &lastError))
 	{
-		QGraphicsSvgItem *svgItem = new QGraphicsSvgItem(svgFileName);
+		QGraphicsSvgItem *svgItem = new QGraphicsSvgItem();
+		svgItem->setSharedRenderer(new QSvgRenderer(svg, svgItem));
 		m_previewScene.addItem(svgItem);
 		m_previewScene.setSceneRect(m_previewScene.itemsBoundingRect());
 
@@ -175,8 +101,4 @@ void CDOTPreviewPage::on_LayoutButton_activated(QVariant data)
 	{
 		//
 	}
-
-	QFile::remove(svgFileName);
-	if (isChanged)
-		QFile::remove(dotFileName);
 }
@@ -28,10 +28,7 @@ private Q_SLOTS:
 	void on_DotEditor_undoAvailable(bool available);
 
 private:
-	bool runPreview(const QString &engine, const QString &dotFilePath, QString &svgFilePath, QString* lastError = nullptr) const;
-	QString errorNotWritable(const QString &path) const;
-	QString errorCannotRun(const QString &path) const;
-	QString errorCannotFinish(const QString &path) const;
+	bool runPreview(const QString &engine, QByteArray &svg, QString* lastError = nullptr) const;
 
     Ui::CDOTPreviewPage *ui;
 	QGraphicsScene m_previewScene;
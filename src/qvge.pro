@@ -37,3 +37,6 @@ qvge.file = $$PWD/qvge/qvge.pro
 
 SUBDIRS += qdot
 qdot.file= $$PWD/qdot/qdot.pro
+
+SUBDIRS += bench
+bench.file = $$PWD/bench/bench.pro
@@ -8,13 +8,155 @@ It can be used freely, maintaining the information above.
 */
 
 #include <QtWidgets/QApplication>
+#include <QCommandLineParser>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QDir>
+#include <QFile>
+#include <QTextStream>
+
+#include <qvgeioui/CBatchConverter.h>
 
 #include "qvgeMainWindow.h"
+#include "qvgeVersion.h"
+
+
+// headless conversion: qvge --batch --to svg,png [options] files...
+static int runBatch(QApplication& a)
+{
+	// as in GUI: exporters write it into the files
+	QApplication::setApplicationName("Qt Visual Graph Editor");
+	QApplication::setApplicationVersion(qvgeVersionString);
+	QApplication::setApplicationDisplayName(QString("%1 %2").arg(QApplication::applicationName(), QApplication::applicationVersion()));
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription("Converts the graph files without GUI, the report is written as JSON");
+	parser.addHelpOption();
+
+	QCommandLineOption batchOption("batch", "Run in headless batch mode.");
+	QCommandLineOption toOption("to",
+		QString("Comma-separated output formats: %1.").arg(CBatchConverter::outputFormats().join(",")), "formats");
+	QCommandLineOption outputDirOption({ "d", "output-dir" }, "Output directory (next to the input files by default).", "dir");
+	QCommandLineOption jobsOption({ "j", "jobs" }, "Parallel workers (number of CPU cores by default).", "count");
+	QCommandLineOption csvOption("csv-delimiter", "Column separator of CSV input: ';' (default), ',' or 'tab'.", "char");
+	QCommandLineOption resolutionOption("resolution", "Resolution of the images, dpi.", "dpi");
+	QCommandLineOption noCutOption("no-cut", "Export the whole scene, not only its content.");
+	QCommandLineOption reportOption({ "o", "report" }, "Report file (stdout by default).", "file");
+	parser.addOptions({ batchOption, toOption, outputDirOption, jobsOption, csvOption, resolutionOption, noCutOption, reportOption });
+	parser.addPositionalArgument("files", QString("Input files: %1.").arg(CBatchConverter::inputFormats().join(",")), "files...");
+
+	parser.process(a);
+
+	QTextStream err(stderr);
+
+	CBatchConverter::Options options;
+	options.formats = parser.value(toOption).split(',', QString::SkipEmptyParts);
+	options.outputDir = parser.value(outputDirOption);
+	options.jobs = parser.value(jobsOption).toInt();
+	options.resolution = parser.value(resolutionOption).toInt();
+	options.cutContent = !parser.isSet(noCutOption);
+
+	QString delimiter = parser.value(csvOption);
+	if (delimiter.toLower() == "tab")
+		options.csvDelimiter = '\t';
+	else if (delimiter.size() == 1)
+		options.csvDelimiter = delimiter.at(0).toLatin1();
+
+	if (options.outputDir.size() && !QDir().mkpath(options.outputDir))
+	{
+		err << "Cannot create output directory: " << options.outputDir << endl;
+		return 1;
+	}
+
+	CBatchConverter converter(options);
+
+	QString lastError;
+	if (!converter.checkFormats(&lastError))
+	{
+		err << lastError << endl;
+		return 1;
+	}
+
+	QStringList files = parser.positionalArguments();
+	if (files.isEmpty())
+	{
+		err << "No input files" << endl;
+		return 1;
+	}
+
+	int done = 0;
+	converter.setProgressCallback([&](const CBatchConverter::Result& result)
+	{
+		err << QString("[%1/%2] %3: %4 ms%5")
+			.arg(++done).arg(files.size())
+			.arg(result.fileName)
+			.arg(result.totalMs, 0, 'f', 1)
+			.arg(result.ok ? QString() : " FAILED") << endl;
+	});
+
+	QElapsedTimer timer;
+	timer.start();
+
+	QList<CBatchConverter::Result> results = converter.run(files);
+
+	QJsonArray resultsJson;
+	int failed = 0;
+	for (const auto& result : results)
+	{
+		resultsJson.append(result.toJson());
+		if (!result.ok)
+			failed++;
+	}
+
+	QJsonObject report;
+	report["files"] = files.size();
+	report["failed"] = failed;
+	report["totalMs"] = timer.nsecsElapsed() / 1000000.0;
+	report["peakResidentBytes"] = CBatchConverter::peakResidentMemory();
+	report["results"] = resultsJson;
+
+	QByteArray json = QJsonDocument(report).toJson();
+
+	if (parser.isSet(reportOption))
+	{
+		QFile reportFile(parser.value(reportOption));
+		if (!reportFile.open(QIODevice::WriteOnly) || reportFile.write(json) != json.size())
+		{
+			err << "Cannot write " << reportFile.fileName() << endl;
+			return 1;
+		}
+	}
+	else
+	{
+		QFile out;
+		out.open(stdout, QIODevice::WriteOnly);
+		out.write(json);
+	}
+
+	return failed ? 2 : 0;
+}
 
 
 int main(int argc, char *argv[])
 {
+	bool batchMode = false;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (qstrcmp(argv[i], "--batch") == 0)
+			batchMode = true;
+	}
+
+	// no display needed
+	if (batchMode && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+		qputenv("QT_QPA_PLATFORM", "offscreen");
+
 	QApplication a(argc, argv);
+
+	if (batchMode)
+		return runBatch(a);
+
     Q_INIT_RESOURCE(qvgeui);
     Q_INIT_RESOURCE(appbase);
 	a.setWindowIcon(QIcon(":/Icons/AppIcon"));
@@ -26,4 +168,3 @@ int main(int argc, char *argv[])
 
 	return a.exec();
 }
-
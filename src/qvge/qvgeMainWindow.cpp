@@ -37,6 +37,7 @@ qvgeMainWindow::qvgeMainWindow(QWidget *parent):
 		.arg(QApplication::applicationName(), QApplication::applicationVersion(), bitString));
 
 	CDocumentFormat xgr = { "XGR binary graph format", "*.xgr", { "xgr" }, true, true };
+	CDocumentFormat xgrj = { "XGR journaled graph format (fast incremental saves)", "*.xgrj", { "xgrj" }, true, true };
 	CDocumentFormat gexf = { "GEXF", "*.gexf", {"gexf"}, true, true };
 	CDocumentFormat graphml = { "GraphML", "*.graphml", { "graphml" }, true, true };
     CDocumentFormat gml = { "GML", "*.gml", { "gml" }, false, true };
@@ -45,7 +46,7 @@ qvgeMainWindow::qvgeMainWindow(QWidget *parent):
 	CDocumentFormat dotplain = { "Plain DOT/GraphViz", "*.plain *.txt", { "plain", "txt" }, false, true };
 
     CDocument graph = { tr("Graph Document"), tr("Directed or undirected graph"), "graph", true,
-                        { xgr, gexf, graphml, gml, csv, dot, dotplain } };
+                        { xgr, xgrj, gexf, graphml, gml, csv, dot, dotplain } };
     addDocument(graph);
 
     //CDocumentFormat txt = { tr("Plain text file"), "*.txt", { "txt" }, true, true };
@@ -170,6 +171,12 @@ bool qvgeMainWindow::openDocument(const QString &fileName, QByteArray &docType)
 				return true;
 			}
 
+			if (m_graphEditController->isLoadCanceled())
+			{
+				m_openCanceled = true;
+				return false;
+			}
+
 			// terminate incomplete document
 			//destroyDocument();
 		}
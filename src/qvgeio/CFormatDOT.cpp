@@ -9,268 +9,988 @@ It can be used freely, maintaining the information above.
 
 #include "CFormatDOT.h"
 
+#include <QObject>
 #include <QFile>
 #include <QDebug>
-#include <QTextStream>
+#include <QColor>
 #include <QFont>
+#include <QHash>
+#include <QSet>
+#include <QPair>
+#include <QVector>
 
-#ifdef USE_BOOST
-    #include <boost/graph/adjacency_list.hpp>
-    #include <boost/graph/graphviz.hpp>
-#endif
+#include <cstring>
 
-struct DotVertex
+
+// DOT language reader: single pass over the file contents, tokens refer to the buffer.
+// See https://graphviz.org/doc/info/lang.html
+
+namespace
 {
-	std::string id;
-	// shape
-	std::string pos;
-	std::string fillcolor;
-	std::string shape;
-	float width = .0;
-	float height = .0;
-	// stroke
-	std::string color;
-	float penwidth = .0;
-	std::string style;
-
-	// label
-	std::string label;
-	std::string xlabel;
-	std::string fontcolor;
-	std::string fontname;
-	float fontsize = .0;
-};
 
-struct DotEdge
+// raw attributes of a statement, in order
+typedef QVector<QPair<QByteArray, QByteArray>> DotAttrs;
+
+
+struct DotToken
 {
-	std::string id;
-	std::string dir;
-	
-	std::string color;
-	std::string style;
-	float penwidth = .0;
-	float weight = .0;
-
-	// label
-	std::string label;
-	std::string xlabel;
-	std::string fontcolor;
-	std::string fontname;
-	float fontsize = .0;
+	enum Type
+	{
+		End, Id, String, Html,
+		LBrace, RBrace, LBracket, RBracket,
+		Equal, Semicolon, Comma, Colon, Plus, EdgeOp,
+		Error
+	};
+
+	Type type = End;
+	const char *text = nullptr;
+	int size = 0;
+	bool escaped = false;		// string contains escapes or line continuations
+	int line = 1;
 };
 
-#ifdef USE_BOOST
-    typedef boost::adjacency_list<boost::vecS, boost::vecS, boost::directedS, DotVertex, DotEdge> graph_t;
-#endif
 
+class DotLexer
+{
+public:
+	DotLexer(const char *data, qint64 size):
+		m_ptr(data), m_end(data + size)
+	{
+	}
+
+	DotToken next()
+	{
+		skipSpaces();
+
+		DotToken token;
+		token.line = m_line;
+
+		if (m_ptr >= m_end)
+			return token;
+
+		const char c = *m_ptr;
+		token.text = m_ptr;
+
+		switch (c)
+		{
+		case '{':	return single(token, DotToken::LBrace);
+		case '}':	return single(token, DotToken::RBrace);
+		case '[':	return single(token, DotToken::LBracket);
+		case ']':	return single(token, DotToken::RBracket);
+		case '=':	return single(token, DotToken::Equal);
+		case ';':	return single(token, DotToken::Semicolon);
+		case ',':	return single(token, DotToken::Comma);
+		case ':':	return single(token, DotToken::Colon);
+		case '+':	return single(token, DotToken::Plus);
+		case '"':	return quoted(token);
+		case '<':	return html(token);
+		default:	break;
+		}
+
+		if (c == '-' && m_ptr + 1 < m_end && (m_ptr[1] == '-' || m_ptr[1] == '>'))
+		{
+			token.type = DotToken::EdgeOp;
+			token.size = 2;
+			m_ptr += 2;
+			return token;
+		}
+
+		// numeral
+		if (c == '-' || c == '.' || isDigit(c))
+		{
+			const char *p = m_ptr + 1;
+			while (p < m_end && (isDigit(*p) || *p == '.'))
+				++p;
+
+			token.type = DotToken::Id;
+			token.size = int(p - m_ptr);
+			m_ptr = p;
+			return token;
+		}
+
+		// identifier (any non-ASCII byte is a letter)
+		if (isIdChar(c))
+		{
+			const char *p = m_ptr + 1;
+			while (p < m_end && (isIdChar(*p) || isDigit(*p)))
+				++p;
+
+			token.type = DotToken::Id;
+			token.size = int(p - m_ptr);
+			m_ptr = p;
+			return token;
+		}
+
+		token.type = DotToken::Error;
+		token.size = 1;
+		return token;
+	}
+
+private:
+	static bool isDigit(char c)
+	{
+		return c >= '0' && c <= '9';
+	}
+
+	static bool isIdChar(char c)
+	{
+		return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || (c & 0x80);
+	}
+
+	DotToken single(DotToken& token, DotToken::Type type)
+	{
+		token.type = type;
+		token.size = 1;
+		++m_ptr;
+		return token;
+	}
+
+	DotToken quoted(DotToken& token)
+	{
+		const char *p = ++m_ptr;
+
+		while (p < m_end && *p != '"')
+		{
+			if (*p == '\\' && p + 1 < m_end)
+			{
+				token.escaped = true;
+				if (p[1] == '\n')
+					m_line++;
+				p += 2;
+				continue;
+			}
+
+			if (*p == '\n')
+				m_line++;
+
+			++p;
+		}
+
+		if (p >= m_end)
+		{
+			token.type = DotToken::Error;
+			return token;
+		}
+
+		token.type = DotToken::String;
+		token.text = m_ptr;
+		token.size = int(p - m_ptr);
+		m_ptr = p + 1;
+		return token;
+	}
+
+	DotToken html(DotToken& token)
+	{
+		const char *p = ++m_ptr;
+		int depth = 1;
+
+		for (; p < m_end; ++p)
+		{
+			if (*p == '<')
+				depth++;
+			else if (*p == '>' && --depth == 0)
+				break;
+			else if (*p == '\n')
+				m_line++;
+		}
+
+		if (p >= m_end)
+		{
+			token.type = DotToken::Error;
+			return token;
+		}
+
+		token.type = DotToken::Html;
+		token.text = m_ptr;
+		token.size = int(p - m_ptr);
+		m_ptr = p + 1;
+		return token;
+	}
+
+	void skipSpaces()
+	{
+		bool lineStart = (m_ptr == m_end) || m_atLineStart;
+
+		while (m_ptr < m_end)
+		{
+			const char c = *m_ptr;
+
+			if (c == '\n')
+			{
+				m_line++;
+				m_ptr++;
+				lineStart = true;
+				continue;
+			}
+
+			if (c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v')
+			{
+				m_ptr++;
+				continue;
+			}
+
+			// C preprocessor output lines
+			if (c == '#' && lineStart)
+			{
+				skipLine();
+				continue;
+			}
+
+			if (c == '/' && m_ptr + 1 < m_end)
+			{
+				if (m_ptr[1] == '/')
+				{
+					skipLine();
+					continue;
+				}
+
+				if (m_ptr[1] == '*')
+				{
+					m_ptr += 2;
+					while (m_ptr + 1 < m_end && !(m_ptr[0] == '*' && m_ptr[1] == '/'))
+					{
+						if (*m_ptr == '\n')
+							m_line++;
+						m_ptr++;
+					}
+					m_ptr = qMin(m_ptr + 2, m_end);
+					continue;
+				}
+			}
+
+			break;
+		}
+
+		m_atLineStart = false;
+	}
 
-// helpers
+	void skipLine()
+	{
+		while (m_ptr < m_end && *m_ptr != '\n')
+			m_ptr++;
+	}
 
-static QString fromDotShape(const std::string& shape)
+	const char *m_ptr;
+	const char *m_end;
+	int m_line = 1;
+	bool m_atLineStart = true;
+};
+
+
+class DotParser
 {
-	// rename to conform dot
-	if (shape == "ellipse")		return "disc";
-	if (shape == "rect" || shape == "box" ) return "square";
-	if (shape == "invtriangle")	return "triangle2";
+public:
+	DotParser(const char *data, qint64 size, Graph& graph):
+		m_lexer(data, size),
+		m_graph(graph)
+	{
+	}
 
-	// else take original
-	return QString::fromStdString(shape);
-}
+	bool parse(QString* lastError);
+
+private:
+	struct Scope
+	{
+		DotAttrs nodeDefaults;
+		DotAttrs edgeDefaults;
+	};
+
+	// parsing
+	void advance()
+	{
+		m_token = m_lexer.next();
+	}
+
+	bool isKeyword(const char *keyword) const
+	{
+		return m_token.type == DotToken::Id
+			&& int(std::strlen(keyword)) == m_token.size
+			&& qstrnicmp(m_token.text, keyword, m_token.size) == 0;
+	}
+
+	bool isIdToken() const
+	{
+		return m_token.type == DotToken::Id || m_token.type == DotToken::String || m_token.type == DotToken::Html;
+	}
+
+	bool expect(DotToken::Type type, const char *what)
+	{
+		if (m_token.type == type)
+		{
+			advance();
+			return true;
+		}
+
+		return error(QString("'%1' expected").arg(what));
+	}
+
+	bool error(const QString& text)
+	{
+		if (m_error.isEmpty())
+			m_error = QString("DOT syntax error at line %1: %2").arg(m_token.line).arg(text);
+
+		return false;
+	}
+
+	bool readId(QByteArray& id);
+	bool readAttrList(DotAttrs& attrs);
+	bool readPort();
+	bool parseStatements(Scope& scope, QVector<int>* members);
+	bool parseSubgraph(Scope& scope, QVector<int>& members);
+	bool parseEdges(Scope& scope, QVector<int> first, QVector<int>* members);
+
+	// model
+	int getNode(const QByteArray& id, const Scope& scope);
+	void addEdge(int from, int to, const DotAttrs& defaults, const DotAttrs& attrs);
+
+	void setNodeAttr(Node& node, const QByteArray& key, const QByteArray& value);
+	void setEdgeAttr(Edge& edge, const QByteArray& key, const QByteArray& value);
+	bool setLabelAttr(GraphAttributes& attrs, const QByteArray& key, const QByteArray& value, const QByteArray& name);
+
+	DotLexer m_lexer;
+	DotToken m_token;
+	QString m_error;
+
+	Graph& m_graph;
+	QByteArray m_graphName;
+	bool m_directed = true;
+	bool m_strict = false;
+
+	QHash<QByteArray, int> m_nodeIndex;
+	QSet<QPair<int, int>> m_strictEdges;
+};
 
 
-template<class DotLabel>
-static void readLabel(const DotLabel &v, GraphAttributes &attrs)
+bool DotParser::parse(QString* lastError)
 {
-	if (v.label.size())
-		attrs["label"] = QString::fromStdString(v.label);
+	advance();
+
+	// [strict] (graph | digraph) [ID] '{' stmt_list '}'
+	if (isKeyword("strict"))
+	{
+		m_strict = true;
+		advance();
+	}
+
+	if (isKeyword("digraph"))
+		m_directed = true;
+	else if (isKeyword("graph"))
+		m_directed = false;
 	else
-	if (v.xlabel.size())
-		attrs["label"] = QString::fromStdString(v.xlabel);
+		error("'graph' or 'digraph' expected");
+
+	if (m_error.isEmpty())
+	{
+		advance();
+
+		if (m_token.type != DotToken::LBrace)
+			readId(m_graphName);
+
+		Scope root;
+
+		if (expect(DotToken::LBrace, "{") && parseStatements(root, nullptr))
+			expect(DotToken::RBrace, "}");
+	}
+
+	if (m_error.size())
+	{
+		if (lastError)
+			*lastError = m_error;
 
-	if (v.fontcolor.size())
-		attrs["label.color"] = QColor(QString::fromStdString(v.fontcolor));
+		return false;
+	}
 
-	if (v.fontname.size() || v.fontsize > .0)
+	return true;
+}
+
+
+bool DotParser::readId(QByteArray& id)
+{
+	if (!isIdToken())
+		return error("identifier expected");
+
+	if (m_token.type == DotToken::String)
 	{
-		QFont f;
-		if (v.fontname.size())
+		// "a" + "b" + ...
+		id.clear();
+
+		for (;;)
 		{
-			QString fontstring = QString::fromStdString(v.fontname).toLower();
-			
-			if (fontstring.contains("bold"))
+			if (m_token.escaped)
 			{
-				fontstring = fontstring.remove("bold");
-				f.setBold(true);
+				// only \" and line continuations are handled by the reader, the rest is up to the attribute
+				const char *p = m_token.text;
+				const char *end = p + m_token.size;
+				for (; p < end; ++p)
+				{
+					if (*p == '\\' && p + 1 < end)
+					{
+						if (p[1] == '"') { id += '"'; ++p; continue; }
+						if (p[1] == '\n') { ++p; continue; }
+						if (p[1] == '\r' && p + 2 < end && p[2] == '\n') { p += 2; continue; }
+					}
+
+					id += *p;
+				}
 			}
-			
-			if (fontstring.contains("italic"))
+			else
+				id.append(m_token.text, m_token.size);
+
+			advance();
+
+			if (m_token.type != DotToken::Plus)
+				break;
+
+			advance();
+			if (m_token.type != DotToken::String)
+				return error("string expected after '+'");
+		}
+
+		return true;
+	}
+
+	id = QByteArray(m_token.text, m_token.size);
+	advance();
+	return true;
+}
+
+
+bool DotParser::readAttrList(DotAttrs& attrs)
+{
+	// ('[' [ID '=' ID [;|,]]* ']')*
+	while (m_token.type == DotToken::LBracket)
+	{
+		advance();
+
+		while (m_token.type != DotToken::RBracket)
+		{
+			QByteArray key, value;
+			if (!readId(key))
+				return false;
+
+			if (m_token.type == DotToken::Equal)
 			{
-				fontstring = fontstring.remove("italic");
-				f.setItalic(true);
+				advance();
+				if (!readId(value))
+					return false;
 			}
+			else
+				value = "true";
 
-			f.setFamily(fontstring);
-		}
+			attrs.append(qMakePair(key, value));
 
-		if (v.fontsize > .0)
-			f.setPointSizeF(v.fontsize);
+			if (m_token.type == DotToken::Comma || m_token.type == DotToken::Semicolon)
+				advance();
+		}
 
-		attrs["label.font"] = f;
+		advance();
 	}
+
+	return true;
 }
 
 
-// reimp
+bool DotParser::readPort()
+{
+	// [':' ID [':' compass_pt]]: ports are not supported by the model
+	for (int i = 0; i < 2 && m_token.type == DotToken::Colon; ++i)
+	{
+		advance();
 
-bool CFormatDOT::load(const QString& fileName, Graph& g, QString* lastError) const
+		QByteArray port;
+		if (!readId(port))
+			return false;
+	}
+
+	return true;
+}
+
+
+bool DotParser::parseStatements(Scope& scope, QVector<int>* members)
 {
-#ifdef USE_BOOST
-	graph_t graphviz;
-	boost::dynamic_properties dp(boost::ignore_other_properties);
-
-	dp.property("node_id", boost::get(&DotVertex::id, graphviz));
-	dp.property("color", boost::get(&DotVertex::color, graphviz));
-	dp.property("fillcolor", boost::get(&DotVertex::fillcolor, graphviz));
-	dp.property("width", boost::get(&DotVertex::width, graphviz));
-	dp.property("height", boost::get(&DotVertex::height, graphviz));
-	dp.property("pos", boost::get(&DotVertex::pos, graphviz));
-	dp.property("shape", boost::get(&DotVertex::shape, graphviz));
-	dp.property("penwidth", boost::get(&DotVertex::penwidth, graphviz));
-	dp.property("style", boost::get(&DotVertex::style, graphviz));
-	dp.property("fontcolor", boost::get(&DotVertex::fontcolor, graphviz));
-	dp.property("fontname", boost::get(&DotVertex::fontname, graphviz));
-	dp.property("fontsize", boost::get(&DotVertex::fontsize, graphviz));
-	dp.property("label", boost::get(&DotVertex::label, graphviz));
-	dp.property("xlabel", boost::get(&DotVertex::xlabel, graphviz));
-
-	dp.property("id", boost::get(&DotEdge::id, graphviz));
-	dp.property("color", boost::get(&DotEdge::color, graphviz));
-	dp.property("penwidth", boost::get(&DotEdge::penwidth, graphviz));
-	dp.property("weight", boost::get(&DotEdge::weight, graphviz));
-	dp.property("dir", boost::get(&DotEdge::dir, graphviz));
-	dp.property("style", boost::get(&DotEdge::style, graphviz));
-	dp.property("fontcolor", boost::get(&DotEdge::fontcolor, graphviz));
-	dp.property("fontname", boost::get(&DotEdge::fontname, graphviz));
-	dp.property("fontsize", boost::get(&DotEdge::fontsize, graphviz));
-	dp.property("label", boost::get(&DotEdge::label, graphviz));
-	dp.property("xlabel", boost::get(&DotEdge::xlabel, graphviz));
-
-
-	std::ifstream dot(fileName.toStdString());
-	bool status = false;
-
-	try
-	{
-		status = boost::read_graphviz(dot, graphviz, dp);
-
-		if (!status)
+	while (m_token.type != DotToken::RBrace)
+	{
+		if (m_token.type == DotToken::End)
+			return error("unexpected end of file");
+
+		if (m_token.type == DotToken::Semicolon)
+		{
+			advance();
+			continue;
+		}
+
+		// attr_stmt: (graph | node | edge) attr_list
+		if (isKeyword("node") || isKeyword("edge") || isKeyword("graph"))
+		{
+			DotAttrs *defaults = isKeyword("node") ? &scope.nodeDefaults : isKeyword("edge") ? &scope.edgeDefaults : nullptr;
+
+			advance();
+
+			DotAttrs attrs;
+			if (!readAttrList(attrs))
+				return false;
+
+			// graph attributes are not used
+			if (defaults)
+				*defaults += attrs;
+
+			continue;
+		}
+
+		// subgraph, maybe followed by edges
+		if (isKeyword("subgraph") || m_token.type == DotToken::LBrace)
+		{
+			QVector<int> subMembers;
+			if (!parseSubgraph(scope, subMembers))
+				return false;
+
+			if (members)
+				*members += subMembers;
+
+			if (m_token.type == DotToken::EdgeOp && !parseEdges(scope, subMembers, members))
+				return false;
+
+			continue;
+		}
+
+		QByteArray id;
+		if (!readId(id))
+			return false;
+
+		// ID '=' ID: graph attribute, not used
+		if (m_token.type == DotToken::Equal)
 		{
-			*lastError = ("Failed reading DOT format");
+			advance();
+
+			QByteArray value;
+			if (!readId(value))
+				return false;
+
+			continue;
+		}
+
+		if (!readPort())
 			return false;
+
+		int node = getNode(id, scope);
+		if (members)
+			members->append(node);
+
+		if (m_token.type == DotToken::EdgeOp)
+		{
+			if (!parseEdges(scope, { node }, members))
+				return false;
+
+			continue;
 		}
+
+		// node_stmt
+		DotAttrs attrs;
+		if (!readAttrList(attrs))
+			return false;
+
+		Node& n = m_graph.nodes[node];
+		for (const auto& attr : attrs)
+			setNodeAttr(n, attr.first, attr.second);
 	}
 
-	catch (boost::bad_graphviz_syntax e)
+	return true;
+}
+
+
+bool DotParser::parseSubgraph(Scope& scope, QVector<int>& members)
+{
+	// [subgraph [ID]] '{' stmt_list '}'
+	if (isKeyword("subgraph"))
 	{
-		*lastError = QString::fromStdString(e.what());
-		return false;
+		advance();
+
+		QByteArray name;
+		if (m_token.type != DotToken::LBrace && !readId(name))
+			return false;
 	}
 
-	catch (...)
+	if (!expect(DotToken::LBrace, "{"))
+		return false;
+
+	// the defaults are inherited (implicitly shared)
+	Scope subScope(scope);
+
+	if (!parseStatements(subScope, &members))
+		return false;
+
+	return expect(DotToken::RBrace, "}");
+}
+
+
+bool DotParser::parseEdges(Scope& scope, QVector<int> first, QVector<int>* members)
+{
+	// operands: node ids or subgraphs
+	QVector<QVector<int>> operands;
+	operands.append(first);
+
+	while (m_token.type == DotToken::EdgeOp)
 	{
-		*lastError = ("BGL: unknown exception");
+		advance();
+
+		QVector<int> operand;
+
+		if (isKeyword("subgraph") || m_token.type == DotToken::LBrace)
+		{
+			if (!parseSubgraph(scope, operand))
+				return false;
+		}
+		else
+		{
+			QByteArray id;
+			if (!readId(id) || !readPort())
+				return false;
+
+			operand.append(getNode(id, scope));
+		}
+
+		if (members)
+			*members += operand;
+
+		operands.append(operand);
+	}
+
+	DotAttrs attrs;
+	if (!readAttrList(attrs))
 		return false;
+
+	for (int i = 0; i + 1 < operands.size(); ++i)
+	{
+		for (int from : operands.at(i))
+			for (int to : operands.at(i + 1))
+				addEdge(from, to, scope.edgeDefaults, attrs);
+	}
+
+	return true;
+}
+
+
+// model
+
+int DotParser::getNode(const QByteArray& id, const Scope& scope)
+{
+	auto it = m_nodeIndex.constFind(id);
+	if (it != m_nodeIndex.constEnd())
+		return it.value();
+
+	int index = m_graph.nodes.size();
+	m_nodeIndex.insert(id, index);
+
+	Node node;
+	node.id = id;
+
+	for (const auto& attr : scope.nodeDefaults)
+		setNodeAttr(node, attr.first, attr.second);
+
+	m_graph.nodes.append(node);
+
+	return index;
+}
+
+
+void DotParser::addEdge(int from, int to, const DotAttrs& defaults, const DotAttrs& attrs)
+{
+	if (m_strict)
+	{
+		auto key = (m_directed || from <= to) ? qMakePair(from, to) : qMakePair(to, from);
+		if (m_strictEdges.contains(key))
+			return;
+
+		m_strictEdges.insert(key);
 	}
 
+	Edge edge;
+	edge.startNodeId = m_graph.nodes.at(from).id;
+	edge.endNodeId = m_graph.nodes.at(to).id;
+
+	if (!m_directed)
+		edge.attrs["direction"] = "undirected";
+
+	for (const auto& attr : defaults)
+		setEdgeAttr(edge, attr.first, attr.second);
+
+	for (const auto& attr : attrs)
+		setEdgeAttr(edge, attr.first, attr.second);
+
+	m_graph.edges.append(edge);
+}
+
+
+// attributes
 
+static QString fromDotShape(const QByteArray& shape)
+{
+	// rename to conform dot
+	if (shape == "ellipse")		return "disc";
+	if (shape == "rect" || shape == "box" ) return "square";
+	if (shape == "invtriangle")	return "triangle2";
+
+	// else take original
+	return QString::fromUtf8(shape);
+}
+
+
+static QColor fromDotColor(QByteArray value)
+{
+	// color lists & weighted colors: the first one
+	int sep = value.indexOf(':');
+	if (sep >= 0)
+		value.truncate(sep);
 
-	//int edgesCount = graphviz.m_edges.size();	// is always empty...
+	sep = value.indexOf(';');
+	if (sep >= 0)
+		value.truncate(sep);
 
-	// nodes
-	int nodesCount = graphviz.m_vertices.size();
+	value = value.trimmed();
 
-	for (int i = 0; i < nodesCount; ++i)
+	if (value.isEmpty())
+		return QColor();
+
+	// #rrggbbaa
+	if (value.startsWith('#'))
 	{
-		const DotVertex &v = graphviz.m_vertices[i].m_property;
+		if (value.size() == 9)
+		{
+			bool ok = false;
+			uint rgba = value.mid(1).toUInt(&ok, 16);
+			if (ok)
+				return QColor((rgba >> 24) & 0xff, (rgba >> 16) & 0xff, (rgba >> 8) & 0xff, rgba & 0xff);
+		}
+
+		return QColor(QString::fromLatin1(value));
+	}
+
+	// "h,s,v" or "h s v"
+	if ((value[0] >= '0' && value[0] <= '9') || value[0] == '.')
+	{
+		QList<QByteArray> hsv = value.simplified().replace(',', ' ').split(' ');
+		if (hsv.size() >= 3)
+		{
+			return QColor::fromHsvF(
+				qBound(0.0, hsv.at(0).toDouble(), 1.0),
+				qBound(0.0, hsv.at(1).toDouble(), 1.0),
+				qBound(0.0, hsv.at(2).toDouble(), 1.0));
+		}
+	}
+
+	// /scheme/name
+	if (value.startsWith('/'))
+		value = value.mid(value.lastIndexOf('/') + 1);
+
+	return QColor(QString::fromLatin1(value));
+}
 
-		Node n;
-		n.id = QByteArray::fromStdString(v.id);
 
-		if (v.fillcolor.size())
-			n.attrs["color"] = QColor(QString::fromStdString(v.fillcolor));
-		
-		if (v.width > .0)
-			n.attrs["width"] = v.width * 72.0;
+static QString fromDotLabel(const QByteArray& value, const QByteArray& name)
+{
+	QString label;
+	label.reserve(value.size());
 
-		if (v.height > .0)
-			n.attrs["height"] = v.height * 72.0;
+	for (int i = 0; i < value.size(); ++i)
+	{
+		char c = value.at(i);
 
-		if (v.pos.size())
+		if (c == '\\' && i + 1 < value.size())
 		{
-			float x, y;
-			std::sscanf(v.pos.data(), "%f,%f", &x, &y);
-			n.attrs["x"] = x * 72.0;
-			n.attrs["y"] = -y * 72.0;
+			char e = value.at(++i);
+			switch (e)
+			{
+			case 'n':
+			case 'l':
+			case 'r':
+				label += '\n';
+				continue;
+
+			case 'N':
+			case 'E':
+			case 'G':
+				label += QString::fromUtf8(name);
+				continue;
+
+			default:
+				label += QChar::fromLatin1(e);
+				continue;
+			}
 		}
 
-		if (v.shape.size())
-			n.attrs["shape"] = fromDotShape(v.shape);
+		// not optimal, but labels are short
+		int start = i;
+		while (i + 1 < value.size() && value.at(i + 1) != '\\')
+			++i;
+
+		label += QString::fromUtf8(value.constData() + start, i - start + 1);
+	}
+
+	return label.trimmed();
+}
+
 
-		if (v.color.size())
-			n.attrs["stroke.color"] = QColor(QString::fromStdString(v.color));
+bool DotParser::setLabelAttr(GraphAttributes& attrs, const QByteArray& key, const QByteArray& value, const QByteArray& name)
+{
+	if (key == "label")
+	{
+		// the default one
+		if (value != "\\N")
+			attrs["label"] = fromDotLabel(value, name);
 
-		if (v.style.size())
-			n.attrs["stroke.style"] = QString::fromStdString(v.style);
+		return true;
+	}
 
-		if (v.penwidth > .0)
-			n.attrs["stroke.size"] = v.penwidth;
+	if (key == "xlabel")
+	{
+		if (!attrs.contains("label"))
+			attrs["label"] = fromDotLabel(value, name);
 
-		readLabel(v, n.attrs);
+		return true;
+	}
 
-		g.nodes.append(n);
+	if (key == "fontcolor")
+	{
+		attrs["label.color"] = fromDotColor(value);
+		return true;
 	}
 
-	// edges
-	for (int i = 0; i < nodesCount; ++i)
+	if (key == "fontname" || key == "fontsize")
 	{
-		const auto &gvnode_out_edges = graphviz.m_vertices[i].m_out_edges;
-		for (const auto &gvedge_props : gvnode_out_edges)
+		QFont f = attrs.value("label.font").value<QFont>();
+
+		if (key == "fontsize")
+		{
+			double size = value.toDouble();
+			if (size > .0)
+				f.setPointSizeF(size);
+		}
+		else
 		{
-			auto gvtarget = gvedge_props.get_target();
-			const DotEdge &edge = gvedge_props.get_property();
+			QString fontstring = QString::fromUtf8(value).toLower();
+
+			if (fontstring.contains("bold"))
+			{
+				fontstring = fontstring.remove("bold");
+				f.setBold(true);
+			}
 
-			Q_ASSERT(i >= 0 && i < nodesCount);
-			Q_ASSERT(gvtarget >= 0 && gvtarget < nodesCount);
-			
-			Edge e;
-			e.startNodeId = g.nodes.at(i).id;
-			e.endNodeId = g.nodes.at(gvtarget).id;
+			if (fontstring.contains("italic"))
+			{
+				fontstring = fontstring.remove("italic");
+				f.setItalic(true);
+			}
+
+			f.setFamily(fontstring.trimmed());
+		}
 
-			if (edge.weight > .0)
-				e.attrs["weight"] = edge.weight;
-			else if (edge.penwidth > .0)
-				e.attrs["weight"] = edge.penwidth;
+		attrs["label.font"] = f;
+		return true;
+	}
 
-			if (edge.dir == "both")
-				e.attrs["direction"] = "mutual";
-			else if (edge.dir == "none")
-				e.attrs["direction"] = "undirected";
+	return false;
+}
 
-			if (edge.style.size())
-				e.attrs["style"] = QString::fromStdString(edge.style);
 
-			readLabel(edge, e.attrs);
+void DotParser::setNodeAttr(Node& n, const QByteArray& key, const QByteArray& value)
+{
+	if (setLabelAttr(n.attrs, key, value, n.id))
+		return;
+
+	if (key == "fillcolor")
+		n.attrs["color"] = fromDotColor(value);
+	else if (key == "color")
+		n.attrs["stroke.color"] = fromDotColor(value);
+	else if (key == "width")
+		n.attrs["width"] = value.toDouble() * 72.0;		// inches
+	else if (key == "height")
+		n.attrs["height"] = value.toDouble() * 72.0;
+	else if (key == "pos")
+	{
+		// points, "x,y[!]"
+		int comma = value.indexOf(',');
+		if (comma > 0)
+		{
+			QByteArray y = value.mid(comma + 1);
+			if (y.endsWith('!'))
+				y.chop(1);
 
-			g.edges.append(e);
+			n.attrs["x"] = value.left(comma).toDouble();
+			n.attrs["y"] = -y.toDouble();
 		}
 	}
+	else if (key == "shape")
+		n.attrs["shape"] = fromDotShape(value);
+	else if (key == "style")
+		n.attrs["stroke.style"] = QString::fromUtf8(value);
+	else if (key == "penwidth")
+		n.attrs["stroke.size"] = value.toDouble();
+}
 
-	// done
-    return status;
 
-#else
-	return false;
-#endif
+void DotParser::setEdgeAttr(Edge& e, const QByteArray& key, const QByteArray& value)
+{
+	if (setLabelAttr(e.attrs, key, value, e.startNodeId + (m_directed ? "->" : "--") + e.endNodeId))
+		return;
+
+	if (key == "id")
+		e.id = value;
+	else if (key == "weight")
+		e.attrs["weight"] = value.toDouble();
+	else if (key == "penwidth")
+	{
+		if (!e.attrs.contains("weight"))
+			e.attrs["weight"] = value.toDouble();
+	}
+	else if (key == "dir")
+	{
+		if (value == "both")
+			e.attrs["direction"] = "mutual";
+		else if (value == "none")
+			e.attrs["direction"] = "undirected";
+		else if (value == "forward")
+			e.attrs.remove("direction");
+	}
+	else if (key == "style")
+		e.attrs["style"] = QString::fromUtf8(value);
+	else if (key == "color")
+		e.attrs["color"] = fromDotColor(value);
+}
+
+}	// namespace
+
+
+// reimp
+
+bool CFormatDOT::load(const QString& fileName, Graph& g, QString* lastError) const
+{
+	QFile file(fileName);
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		if (lastError)
+			*lastError = QObject::tr("Cannot open file");
+		return false;
+	}
+
+	g.clear();
+
+	// mapped if possible, no copy
+	QByteArray buffer;
+	const char *data = nullptr;
+	qint64 size = file.size();
+
+	if (size > 0)
+		data = reinterpret_cast<const char*>(file.map(0, size));
+
+	if (!data)
+	{
+		buffer = file.readAll();
+		data = buffer.constData();
+		size = buffer.size();
+	}
+
+	DotParser parser(data, size, g);
+	return parser.parse(lastError);
 }
 
 
@@ -278,4 +998,3 @@ bool CFormatDOT::save(const QString& fileName, Graph& graph, QString* lastError)
 {
 	return false;
 }
-
@@ -323,7 +323,7 @@ bool CFormatGraphML::readNode(int /*index*/, const QDomNode &domNode, Graph& gra
 	Node node;
 
 	// common attrs
-	auto id = elem.attribute("id", "").toLatin1();
+	auto id = elem.attribute("id", "").toUtf8();
 	node.id = id;
 
 	QDomNodeList data = elem.elementsByTagName("data");
@@ -382,14 +382,14 @@ bool CFormatGraphML::readEdge(int /*index*/, const QDomNode &domNode, Graph& gra
 	QDomElement elem = domNode.toElement();
 	
 	Edge edge;
-	edge.startNodeId = elem.attribute("source", "").toLatin1();
-	edge.startPortId = elem.attribute("sourceport", "").toLatin1();
-	edge.endNodeId = elem.attribute("target", "").toLatin1();
-	edge.endPortId = elem.attribute("targetport", "").toLatin1();
+	edge.startNodeId = elem.attribute("source", "").toUtf8();
+	edge.startPortId = elem.attribute("sourceport", "").toUtf8();
+	edge.endNodeId = elem.attribute("target", "").toUtf8();
+	edge.endPortId = elem.attribute("targetport", "").toUtf8();
 
 	// common attrs
 	QString id = elem.attribute("id", "");
-	edge.id = id.toLatin1();
+	edge.id = id.toUtf8();
 
 	QDomNodeList data = elem.elementsByTagName("data");
 	for (int i = 0; i < data.count(); ++i)
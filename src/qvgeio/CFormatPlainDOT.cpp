@@ -11,49 +11,142 @@ It can be used freely, maintaining the information above.
 
 #include <QFile>
 #include <QDebug>
-#include <QTextStream>
 #include <QFont>
+#include <QVarLengthArray>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+
+// tokens refer to the loaded data, nothing is copied until a value is stored into the graph
+
+struct PlainToken
+{
+	const char *text;
+	int size;
+};
+
+typedef QVarLengthArray<PlainToken, 32> PlainTokens;
+
+
+static bool isSpace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+
+static bool isDigit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+
+static bool equals(const PlainToken& token, const char* text)
+{
+	return qstrncmp(token.text, text, token.size) == 0 && text[token.size] == '\0';
+}
+
+
+// locale-independent, in place
+static bool toDouble(const PlainToken& token, double& value)
+{
+	const char *p = token.text;
+	const char *end = p + token.size;
+
+	bool negative = false;
+	if (p < end && (*p == '-' || *p == '+'))
+		negative = (*p++ == '-');
+
+	double v = 0;
+	bool digits = false;
+
+	for (; p < end && isDigit(*p); ++p, digits = true)
+		v = v * 10 + (*p - '0');
+
+	if (p < end && *p == '.')
+	{
+		double scale = 0.1;
+		for (++p; p < end && isDigit(*p); ++p, digits = true, scale *= 0.1)
+			v += (*p - '0') * scale;
+	}
+
+	if (!digits)
+		return false;
+
+	if (p < end && (*p == 'e' || *p == 'E'))
+	{
+		++p;
+
+		bool negativeExp = false;
+		if (p < end && (*p == '-' || *p == '+'))
+			negativeExp = (*p++ == '-');
+
+		if (p == end)
+			return false;
+
+		int exp = 0;
+		for (; p < end && isDigit(*p); ++p)
+			exp = exp * 10 + (*p - '0');
+
+		v *= std::pow(10.0, negativeExp ? -exp : exp);
+	}
+
+	if (p != end)
+		return false;
+
+	value = negative ? -v : v;
+	return true;
+}
 
 
 // helpers
 
-static QString fromDotNodeShape(const QString& shape)
+static QString fromDotNodeShape(const PlainToken& token)
 {
+	QLatin1String shape(token.text, token.size);
+
 	// rename to conform dot
-	if (shape == "ellipse")		return "disc";
-	if (shape == "rect" || shape == "box" ) return "square";
-	if (shape == "invtriangle")	return "triangle2";
+	if (shape == QLatin1String("ellipse"))	return "disc";
+	if (shape == QLatin1String("rect") || shape == QLatin1String("box")) return "square";
+	if (shape == QLatin1String("invtriangle"))	return "triangle2";
 
 	// else take original
 	return shape;
 }
 
 
-static void fromDotNodeStyle(const QString& style, GraphAttributes& nodeAttr)
+static bool contains(const PlainToken& token, const char* text)
 {
-	if (style.contains("dashed"))
+	return std::search(token.text, token.text + token.size, text, text + qstrlen(text)) != token.text + token.size;
+}
+
+
+static void fromDotNodeStyle(const PlainToken& style, GraphAttributes& nodeAttr)
+{
+	if (contains(style, "dashed"))
 		nodeAttr["stroke.style"] = "dashed";
 	else
-	if (style.contains("dotted"))
+	if (contains(style, "dotted"))
 		nodeAttr["stroke.style"] = "dotted";
 
-	if (style.contains("invis"))
+	if (contains(style, "invis"))
 		nodeAttr["stroke.size"] = 0;
 	else
-	if (style.contains("solid"))
+	if (contains(style, "solid"))
 		nodeAttr["stroke.size"] = 1;
 	else
-	if (style.contains("bold"))
+	if (contains(style, "bold"))
 		nodeAttr["stroke.size"] = 3;
 }
 
 
-class QStringRefsConstIterator
+class PlainTokensConstIterator
 {
 public:
-	QStringRefsConstIterator(const QStringList& refs): m_refs(refs)
+	PlainTokensConstIterator(const PlainTokens& tokens): m_tokens(tokens)
 	{
-		m_pos = (m_refs.size()) ? 0 : -1;
+		m_pos = (m_tokens.size()) ? 0 : -1;
 	}
 
 	int pos() const
@@ -63,12 +156,12 @@ public:
 
 	int restCount() const
 	{
-		return canNext() ? m_refs.count() - m_pos : 0;
+		return canNext() ? m_tokens.size() - m_pos : 0;
 	}
 
 	bool canNext() const
 	{
-		return (m_pos >= 0 && m_pos < m_refs.count());
+		return (m_pos >= 0 && m_pos < m_tokens.size());
 	}
 
 	bool next()
@@ -86,11 +179,10 @@ public:
 	{
 		if (canNext())
 		{
-			bool ok = false;
-			float tf = m_refs.at(m_pos++).toFloat(&ok);
-			if (ok)
+			double td = 0;
+			if (toDouble(m_tokens.at(m_pos++), td))
 			{
-				f = tf;
+				f = float(td);
 				return true;
 			}
 		}
@@ -102,11 +194,10 @@ public:
 	{
 		if (canNext())
 		{
-			bool ok = false;
-			int ti = m_refs.at(m_pos++).toInt(&ok);
-			if (ok)
+			double td = 0;
+			if (toDouble(m_tokens.at(m_pos++), td) && td == int(td))
 			{
-				i = ti;
+				i = int(td);
 				return true;
 			}
 		}
@@ -114,11 +205,23 @@ public:
 		return false;
 	}
 
+	bool next(PlainToken &t)
+	{
+		if (canNext())
+		{
+			t = m_tokens.at(m_pos++);
+			return true;
+		}
+
+		return false;
+	}
+
 	bool next(QString &s)
 	{
 		if (canNext())
 		{
-			s = m_refs.at(m_pos++);
+			const PlainToken& t = m_tokens.at(m_pos++);
+			s = QString::fromUtf8(t.text, t.size);
 			return true;
 		}
 
@@ -129,7 +232,8 @@ public:
 	{
 		if (canNext())
 		{
-			s = m_refs.at(m_pos++).toUtf8();
+			const PlainToken& t = m_tokens.at(m_pos++);
+			s = QByteArray(t.text, t.size);
 			return true;
 		}
 
@@ -137,81 +241,118 @@ public:
 	}
 
 private:
-	const QStringList& m_refs;
+	const PlainTokens& m_tokens;
 	int m_pos = -1;
 };
 
 
 // parsing plain dot
 
-static QStringList parseLine(QTextStream &ts)
+// splits the next non-empty record into tokens, false at the end of data
+static bool parseLine(const char*& ptr, const char* end, PlainTokens& tokens)
 {
-	QStringList tokens;
+	tokens.clear();
 
-	// normal mode
-	while (!ts.atEnd())
+	while (ptr < end)
 	{
-		QString line = ts.readLine().trimmed();
-		if (line.isEmpty())
-			continue;
-
-		// add EOL
-		line += '\0';
-
-		int i = 0;
+		const char *p = ptr;
+		const char *lineEnd = static_cast<const char*>(memchr(ptr, '\n', end - ptr));
+		if (!lineEnd)
+			lineEnd = end;
 
-	_loop:
-		// skip to next token
-		while (line[i].isSpace())
-			i++;
-		if (line[i] == '\0')
-			break;
+		ptr = (lineEnd < end) ? lineEnd + 1 : end;
 
-		// check for "
-		if (line[i] == '"')
+		for (;;)
 		{
-			i++;
-			QString token;
-			while (line[i] != '"' && line[i] != '\0')
-				token += line[i++];
-			tokens << token;
-			i++;
-
-			goto _loop;
-		}
-
-		// check for < + eol
-		if (line[i] == '<' && line[i+1] == '\0')
-		{
-			QString token;
-			while (!ts.atEnd())
+			// skip to next token
+			while (p < lineEnd && isSpace(*p))
+				p++;
+			if (p == lineEnd)
+				break;
+
+			// check for "
+			if (*p == '"')
 			{
-				QString l = ts.readLine();
-				QString lt = l.trimmed() + '\0';
-				if (lt[0] == '>' && (lt[1].isSpace() || lt[1] == '\0'))
+				const char *start = ++p;
+				while (p < lineEnd && *p != '"')
 				{
-					tokens << token;
-					line = lt;
-					i = 1;
-					goto _loop;
+					if (*p == '\\' && p + 1 < lineEnd)
+						p++;
+					p++;
 				}
-				else
+
+				tokens.append({ start, int(p - start) });
+
+				if (p < lineEnd)
+					p++;
+				continue;
+			}
+
+			// check for < + eol: multiline html label up to the line starting with >
+			if (*p == '<')
+			{
+				const char *rest = p + 1;
+				while (rest < lineEnd && isSpace(*rest))
+					rest++;
+
+				if (rest == lineEnd)
 				{
-					token += l + "\n";
+					const char *start = ptr;
+					bool found = false;
+
+					while (ptr < end)
+					{
+						const char *l = ptr;
+						const char *lEnd = static_cast<const char*>(memchr(ptr, '\n', end - ptr));
+						if (!lEnd)
+							lEnd = end;
+
+						ptr = (lEnd < end) ? lEnd + 1 : end;
+
+						const char *lt = l;
+						while (lt < lEnd && isSpace(*lt))
+							lt++;
+
+						if (lt < lEnd && *lt == '>' && (lt + 1 == lEnd || isSpace(lt[1])))
+						{
+							tokens.append({ start, int(l - start) });
+							p = lt + 1;
+							lineEnd = lEnd;
+							found = true;
+							break;
+						}
+					}
+
+					if (found)
+						continue;
+
+					// unterminated: the rest is dropped
+					break;
 				}
 			}
+
+			// read normal tokens
+			const char *start = p;
+			while (p < lineEnd && !isSpace(*p))
+				p++;
+
+			tokens.append({ start, int(p - start) });
 		}
-		
-		// read normal tokens
-		QString token;
-		while (line[i] != '\0' && !line[i].isSpace())
-			token += line[i++];
-
-		tokens << token;
-		goto _loop;
+
+		if (tokens.size())
+			return true;
 	}
 
-	return tokens;
+	return false;
+}
+
+
+static QString toLabel(const PlainToken& token)
+{
+	QString label = QString::fromUtf8(token.text, token.size);
+	label.replace("\\n", "\n");
+	label.replace("\\\"", "\"");
+	return label;
 }
 
 
@@ -229,67 +370,19 @@ static void splitEdgePortIds(QByteArray& nodeId, QByteArray& portId)
 }
 
 
-// reimp
-
-bool CFormatPlainDOT::load(const QString& fileName, Graph& g, QString* lastError) const
+struct GraphInternal
 {
-	GraphInternal gi;
-	gi.g = &g;
-
-	QFile f(fileName);
-	if (!f.open(QFile::ReadOnly))
-	{
-		if (lastError)
-			*lastError = QObject::tr("Cannot open file");
-
-		return false;
-	}
-
-	QTextStream ts(&f);
-
-	while (!ts.atEnd())
-	{
-		auto refs = parseLine(ts);
-		if (refs.first() == "stop")
-			break;
-
-		if (refs.first() == "graph")
-		{
-			parseGraph(refs, gi);
-			continue;
-		}
-
-		if (refs.first() == "node")
-		{
-			parseNode(refs, gi);
-			continue;
-		}
-
-		if (refs.first() == "edge")
-		{
-			parseEdge(refs, gi);
-			continue;
-		}
-	}
-
-	// done
-	f.close();
-
-    return true;
-}
-
-
-bool CFormatPlainDOT::save(const QString& fileName, Graph& g, QString* lastError) const
-{
-	return false;
-}
+	float g_scale = 1.0;
+	float g_x = 1.0;
+	float g_y = 1.0;
 
+	Graph* g = nullptr;
+};
 
-// privates
 
-bool CFormatPlainDOT::parseGraph(const QStringList &refs, GraphInternal &gi) const
+static bool parseGraph(const PlainTokens &tokens, GraphInternal &gi)
 {
-	QStringRefsConstIterator rit(refs);
+	PlainTokensConstIterator rit(tokens);
 	rit.next();	// skip header
 	rit.next(gi.g_scale);
 	rit.next(gi.g_x);
@@ -299,16 +392,17 @@ bool CFormatPlainDOT::parseGraph(const QStringList &refs, GraphInternal &gi) con
 }
 
 
-bool CFormatPlainDOT::parseNode(const QStringList &refs, GraphInternal &gi) const
+static bool parseNode(const PlainTokens &tokens, GraphInternal &gi)
 {
-	QStringRefsConstIterator rit(refs);
+	PlainTokensConstIterator rit(tokens);
 	rit.next();	// skip header
 
 	Node node;
 	rit.next(node.id);
 
-	QString label, style, shape, color, fillcolor;
-	float x, y, width, height;
+	PlainToken label = {}, style = {}, shape = {};
+	QString color, fillcolor;
+	float x = 0, y = 0, width = 0, height = 0;
 
 	rit.next(x);
 	rit.next(y);
@@ -326,8 +420,7 @@ bool CFormatPlainDOT::parseNode(const QStringList &refs, GraphInternal &gi) cons
 	node.attrs["width"] = width * 72.0 * gi.g_scale;
 	node.attrs["height"] = height * 72.0 * gi.g_scale;
 
-	label = label.replace("\\n", "\n");
-	node.attrs["label"] = label;
+	node.attrs["label"] = toLabel(label);
 	node.attrs["shape"] = fromDotNodeShape(shape);
 	fromDotNodeStyle(style, node.attrs);
 	node.attrs["color"] = fillcolor;
@@ -339,38 +432,28 @@ bool CFormatPlainDOT::parseNode(const QStringList &refs, GraphInternal &gi) cons
 }
 
 
-bool CFormatPlainDOT::parseEdge(const QStringList &refs, GraphInternal &gi) const
+static bool parseEdge(const PlainTokens &tokens, GraphInternal &gi)
 {
-	QStringRefsConstIterator rit(refs);
+	PlainTokensConstIterator rit(tokens);
 	rit.next();	// skip header
 
 	Edge edge;
 	rit.next(edge.startNodeId);
 	rit.next(edge.endNodeId);
 
+	// the joints are not used
 	int jointCount = 0;
-	float x, y;
 	rit.next(jointCount);
-	if (jointCount > 0)
-	{
-		QString points;
-		for (int i = 0; i < jointCount; ++i)
-		{
-			rit.next(x);
-			rit.next(y);
-			x = x * 72.0 * gi.g_scale;
-			y = y * 72.0 * gi.g_scale;
-			points += QString("%1 %2 ").arg(x).arg(y);
-		}
-		//edge.attrs["points"] = points;
-	}
+	for (int i = 0; i < jointCount * 2; ++i)
+		rit.next();
 
+	float x = 0, y = 0;
 
 	if (rit.restCount() > 2)
 	{
-		QString label;
-		rit.next(label);
-		label = label.replace("\\n", "\n");
+		PlainToken labelToken = {};
+		rit.next(labelToken);
+		QString label = toLabel(labelToken);
 
 		rit.next(x);
 		rit.next(y);
@@ -411,3 +494,80 @@ bool CFormatPlainDOT::parseEdge(const QStringList &refs, GraphInternal &gi) cons
 	return true;
 }
 
+
+// reimp
+
+bool CFormatPlainDOT::load(const QString& fileName, Graph& g, QString* lastError) const
+{
+	QFile f(fileName);
+	if (!f.open(QFile::ReadOnly))
+	{
+		if (lastError)
+			*lastError = QObject::tr("Cannot open file");
+
+		return false;
+	}
+
+	// mapped if possible, no copy
+	QByteArray buffer;
+	const char *data = nullptr;
+	qint64 size = f.size();
+
+	if (size > 0)
+		data = reinterpret_cast<const char*>(f.map(0, size));
+
+	if (!data)
+	{
+		buffer = f.readAll();
+		data = buffer.constData();
+		size = buffer.size();
+	}
+
+	return parse(data, size, g, lastError);
+}
+
+
+bool CFormatPlainDOT::parse(const char* data, qint64 size, Graph& g, QString* /*lastError*/) const
+{
+	GraphInternal gi;
+	gi.g = &g;
+
+	const char *ptr = data;
+	const char *end = data + size;
+
+	PlainTokens tokens;
+
+	while (parseLine(ptr, end, tokens))
+	{
+		const PlainToken& header = tokens.first();
+
+		if (equals(header, "stop"))
+			break;
+
+		if (equals(header, "graph"))
+		{
+			parseGraph(tokens, gi);
+			continue;
+		}
+
+		if (equals(header, "node"))
+		{
+			parseNode(tokens, gi);
+			continue;
+		}
+
+		if (equals(header, "edge"))
+		{
+			parseEdge(tokens, gi);
+			continue;
+		}
+	}
+
+    return true;
+}
+
+
+bool CFormatPlainDOT::save(const QString& fileName, Graph& g, QString* lastError) const
+{
+	return false;
+}
@@ -18,20 +18,6 @@ public:
 	bool load(const QString& fileName, Graph& graph, QString* lastError = nullptr) const;
 	bool save(const QString& fileName, Graph& graph, QString* lastError = nullptr) const;
 
-private:
-	struct GraphInternal
-	{
-		float g_scale = 1.0;
-		float g_x = 1.0;
-		float g_y = 1.0;
-
-		Graph* g = nullptr;
-	};
-
-	bool parseGraph(const QStringList& refs, GraphInternal &gi) const;
-	bool parseNode(const QStringList& refs, GraphInternal &gi) const;
-	bool parseEdge(const QStringList& refs, GraphInternal &gi) const;
+	// parses GraphViz -Tplain output kept in memory
+	bool parse(const char* data, qint64 size, Graph& graph, QString* lastError = nullptr) const;
 };
-
-
-
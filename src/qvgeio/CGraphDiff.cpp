@@ -0,0 +1,178 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#include "CGraphDiff.h"
+
+#include <QHash>
+#include <QSet>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentRun>
+
+
+// not removed when missing in b
+static const QSet<QByteArray> keptAttributes = { "x", "y", "z", "pos", "width", "height", "size", "points" };
+
+
+static bool compareAttributes(const GraphAttributes& a, const GraphAttributes& b, CGraphDiff::Change& change)
+{
+	for (auto it = b.constBegin(); it != b.constEnd(); ++it)
+	{
+		if (it.key() == "id")
+			continue;
+
+		auto old = a.constFind(it.key());
+		if (old == a.constEnd())
+			change.set[it.key()] = it.value();
+		else if (!CGraphDiff::isSameValue(old.value(), it.value()))
+		{
+			change.set[it.key()] = it.value();
+			change.old[it.key()] = old.value();
+		}
+	}
+
+	for (auto it = a.constBegin(); it != a.constEnd(); ++it)
+	{
+		if (it.key() != "id" && !b.contains(it.key()) && !keptAttributes.contains(it.key()))
+		{
+			change.removed << it.key();
+			change.old[it.key()] = it.value();
+		}
+	}
+
+	return change.set.size() || change.removed.size();
+}
+
+
+static bool isSameEdge(const Edge& a, const Edge& b)
+{
+	return a.startNodeId == b.startNodeId && a.endNodeId == b.endNodeId &&
+		a.startPortId == b.startPortId && a.endPortId == b.endPortId &&
+		a.attrs.contains("points") == b.attrs.contains("points");
+}
+
+
+int CGraphDiff::size() const
+{
+	return addedNodes.size() + addedEdges.size() +
+		removedNodes.size() + removedEdges.size() +
+		changedNodes.size() + changedEdges.size();
+}
+
+
+static void compareNodes(const Graph& a, const Graph& b, CGraphDiff& diff)
+{
+	QHash<QByteArray, int> aNodes;
+	aNodes.reserve(a.nodes.size());
+	for (int i = 0; i < a.nodes.size(); ++i)
+		aNodes.insert(a.nodes.at(i).id, i);
+
+	for (int i = 0; i < b.nodes.size(); ++i)
+	{
+		const Node& node = b.nodes.at(i);
+
+		auto it = aNodes.find(node.id);
+		if (it == aNodes.end())
+		{
+			diff.addedNodes << i;
+			continue;
+		}
+
+		CGraphDiff::Change change;
+		change.id = node.id;
+		change.index = i;
+
+		if (compareAttributes(a.nodes.at(it.value()).attrs, node.attrs, change))
+			diff.changedNodes << change;
+
+		// matched: whatever is left has been removed
+		aNodes.erase(it);
+	}
+
+	for (const Node& node : a.nodes)
+	{
+		if (aNodes.contains(node.id))
+			diff.removedNodes << node.id;
+	}
+}
+
+
+static void compareEdges(const Graph& a, const Graph& b, CGraphDiff& diff)
+{
+	QHash<QByteArray, int> aEdges;
+	aEdges.reserve(a.edges.size());
+	for (int i = 0; i < a.edges.size(); ++i)
+		aEdges.insert(a.edges.at(i).id, i);
+
+	for (int i = 0; i < b.edges.size(); ++i)
+	{
+		const Edge& edge = b.edges.at(i);
+
+		auto it = aEdges.find(edge.id);
+		if (it == aEdges.end())
+		{
+			diff.addedEdges << i;
+			continue;
+		}
+
+		const Edge& old = a.edges.at(it.value());
+		aEdges.erase(it);
+
+		if (!isSameEdge(old, edge))
+		{
+			diff.removedEdges << edge.id;
+			diff.addedEdges << i;
+			continue;
+		}
+
+		CGraphDiff::Change change;
+		change.id = edge.id;
+		change.index = i;
+
+		if (compareAttributes(old.attrs, edge.attrs, change))
+			diff.changedEdges << change;
+	}
+
+	for (const Edge& edge : a.edges)
+	{
+		if (aEdges.contains(edge.id))
+			diff.removedEdges << edge.id;
+	}
+}
+
+
+CGraphDiff CGraphDiff::compute(const Graph& a, const Graph& b)
+{
+	CGraphDiff diff;
+
+	// the edges by another thread: they write to own lists only; own pool, as the caller
+	// is usually a worker of the global one already
+	QThreadPool pool;
+	pool.setMaxThreadCount(1);
+
+	QFuture<void> edges = QtConcurrent::run(&pool, [&]() { compareEdges(a, b, diff); });
+
+	compareNodes(a, b, diff);
+
+	edges.waitForFinished();
+
+	return diff;
+}
+
+
+bool CGraphDiff::isSameValue(const QVariant& v1, const QVariant& v2)
+{
+	if (v1 == v2)
+		return true;
+
+	if (v1.type() == v2.type())
+		return false;
+
+	QString s1 = v1.toString();
+	return !s1.isEmpty() && s1 == v2.toString();
+}
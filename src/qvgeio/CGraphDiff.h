@@ -0,0 +1,49 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#pragma once
+
+#include <qvgeio/CGraphBase.h>
+
+
+// Keyed difference of two graphs: the nodes & edges are matched by their ids.
+// Applied to graph a it gives graph b: the removed items are deleted, the added ones are created
+// and the attributes of the changed ones are updated. An edge with the other end nodes, ports
+// or polyline-ness is removed & added again. Node ports are not compared.
+// The items are matched through hashes of the ids: linear in the size of the graphs.
+
+class CGraphDiff
+{
+public:
+	struct Change
+	{
+		QByteArray id;
+		int index = -1;					// in b
+		GraphAttributes set;			// new & changed values
+		QList<QByteArray> removed;		// attributes of a missing in b
+		GraphAttributes old;			// values in a of the changed & removed ones
+	};
+
+	// indexes in b
+	QList<int> addedNodes, addedEdges;
+
+	// ids of a
+	QList<QByteArray> removedNodes, removedEdges;
+
+	QList<Change> changedNodes, changedEdges;
+
+	bool isEmpty() const	{ return size() == 0; }
+	int size() const;
+
+	// the geometry missing in b (i.e. not stored by a generator) is not a change, it stays as in a
+	static CGraphDiff compute(const Graph& a, const Graph& b);
+
+	// the same value, also if read as a different type (i.e. a number as text)
+	static bool isSameValue(const QVariant& v1, const QVariant& v2);
+};
@@ -0,0 +1,303 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#include "CGraphGenerators.h"
+
+#include <QVector>
+#include <QtMath>
+
+#include <random>
+#include <cmath>
+
+
+// raw mt19937 output only: the distributions of std differ between the implementations
+static int randomIndex(std::mt19937& rng, int count)
+{
+	return int(rng() % quint32(count));
+}
+
+
+static double randomCoord(std::mt19937& rng, double range)
+{
+	return (rng() % 1000000) * range / 1000000.0;
+}
+
+
+// (0, 1)
+static double randomUnit(std::mt19937& rng)
+{
+	return (rng() + 0.5) / 4294967296.0;
+}
+
+
+// calls visitor(k) for every index k in [0, count) chosen with probability p;
+// the gaps between the chosen indices are geometric, so the cost is O(chosen), not O(count)
+template<class Visitor>
+static void samplePairs(qint64 count, double p, std::mt19937& rng, Visitor visitor)
+{
+	if (p <= 0 || count <= 0)
+		return;
+
+	if (p >= 1)
+	{
+		for (qint64 k = 0; k < count; ++k)
+			visitor(k);
+		return;
+	}
+
+	// too small to be represented
+	const double logQ = std::log1p(-p);
+	if (logQ >= 0)
+		return;
+
+	for (qint64 k = -1; ; )
+	{
+		double skip = std::floor(std::log(randomUnit(rng)) / logQ);
+		if (skip >= double(count - k - 1))
+			break;
+
+		k += 1 + qint64(skip);
+		visitor(k);
+	}
+}
+
+
+// generators
+
+void CGraphGenerators::grid(int rows, int columns, Graph& graph)
+{
+	if (rows <= 0 || columns <= 0)
+		return;
+
+	reserve(graph, rows * columns, 2 * rows * columns);
+
+	for (int r = 0; r < rows; ++r)
+		for (int c = 0; c < columns; ++c)
+			addNode(graph, r * columns + c, c * 100, r * 100);
+
+	for (int r = 0; r < rows; ++r)
+	{
+		for (int c = 0; c < columns; ++c)
+		{
+			int index = r * columns + c;
+
+			if (c + 1 < columns)
+				addEdge(graph, index, index + 1);
+
+			if (r + 1 < rows)
+				addEdge(graph, index, index + columns);
+		}
+	}
+}
+
+
+void CGraphGenerators::erdosRenyi(int nodeCount, int edgeCount, Graph& graph, quint32 seed)
+{
+	if (nodeCount <= 0)
+		return;
+
+	std::mt19937 rng(seed);
+
+	double range = qSqrt(nodeCount) * 100;
+
+	reserve(graph, nodeCount, edgeCount);
+
+	for (int i = 0; i < nodeCount; ++i)
+		addNode(graph, i, randomCoord(rng, range), randomCoord(rng, range));
+
+	for (int i = 0; i < edgeCount; ++i)
+	{
+		int n1 = randomIndex(rng, nodeCount);
+		int n2 = randomIndex(rng, nodeCount);
+		if (n1 == n2)
+			n2 = (n2 + 1) % nodeCount;
+
+		addEdge(graph, n1, n2);
+	}
+}
+
+
+void CGraphGenerators::barabasiAlbert(int nodeCount, int m, Graph& graph, quint32 seed)
+{
+	if (nodeCount <= 0)
+		return;
+
+	m = qMax(1, m);
+
+	std::mt19937 rng(seed);
+
+	double range = qSqrt(nodeCount) * 100;
+
+	reserve(graph, nodeCount, nodeCount * m);
+
+	// every edge end is listed here, so uniform pick from the list is proportional to the degree
+	QVector<int> ends;
+	ends.reserve(nodeCount * m * 2);
+
+	// fully connected core
+	int core = qMin(m + 1, nodeCount);
+	for (int i = 0; i < core; ++i)
+	{
+		addNode(graph, i, randomCoord(rng, range), randomCoord(rng, range));
+
+		for (int j = 0; j < i; ++j)
+		{
+			addEdge(graph, i, j);
+			ends << i << j;
+		}
+	}
+
+	QVector<int> targets;
+	targets.reserve(m);
+
+	for (int i = core; i < nodeCount; ++i)
+	{
+		addNode(graph, i, randomCoord(rng, range), randomCoord(rng, range));
+
+		targets.clear();
+		while (targets.size() < m)
+		{
+			int target = ends[randomIndex(rng, ends.size())];
+			if (!targets.contains(target))
+				targets << target;
+		}
+
+		for (int target : targets)
+		{
+			addEdge(graph, i, target);
+			ends << i << target;
+		}
+	}
+}
+
+
+void CGraphGenerators::tree(int nodeCount, int branching, Graph& graph)
+{
+	if (nodeCount <= 0)
+		return;
+
+	branching = qMax(1, branching);
+
+	reserve(graph, nodeCount, nodeCount - 1);
+
+	// nodes of a level are centered under the root
+	qint64 levelStart = 0, levelSize = 1;
+	int level = 0;
+
+	for (int i = 0; i < nodeCount; ++i)
+	{
+		if (i >= levelStart + levelSize)
+		{
+			levelStart += levelSize;
+			levelSize = qMin<qint64>(levelSize * branching, nodeCount);
+			level++;
+		}
+
+		qint64 levelCount = qMin<qint64>(levelSize, nodeCount - levelStart);
+
+		addNode(graph, i, (i - levelStart - (levelCount - 1) / 2.0) * 100, level * 100);
+
+		if (i > 0)
+			addEdge(graph, (i - 1) / branching, i);
+	}
+}
+
+
+void CGraphGenerators::plantedPartition(int groupCount, int groupSize, double pIn, double pOut, Graph& graph, quint32 seed)
+{
+	if (groupCount <= 0 || groupSize <= 0)
+		return;
+
+	std::mt19937 rng(seed);
+
+	const int nodeCount = groupCount * groupSize;
+	const qint64 innerPairs = qint64(groupSize) * (groupSize - 1) / 2;
+	const qint64 outerPairs = qint64(groupSize) * groupSize;
+
+	double expectedEdges = groupCount * innerPairs * qBound(0.0, pIn, 1.0)
+		+ 0.5 * groupCount * (groupCount - 1) * outerPairs * qBound(0.0, pOut, 1.0);
+
+	reserve(graph, nodeCount, int(qMin(expectedEdges * 1.05, 1e8)));
+
+	// groups in a square lattice, nodes spread around the group centers
+	double groupRange = qSqrt(groupSize) * 100;
+	int columns = qMax(1, int(qCeil(qSqrt(groupCount))));
+
+	for (int g = 0; g < groupCount; ++g)
+	{
+		double gx = (g % columns) * groupRange * 2;
+		double gy = (g / columns) * groupRange * 2;
+
+		for (int i = 0; i < groupSize; ++i)
+		{
+			int index = g * groupSize + i;
+			addNode(graph, index, gx + randomCoord(rng, groupRange), gy + randomCoord(rng, groupRange));
+			graph.nodes.last().attrs["group"] = g;
+		}
+	}
+
+	for (int g = 0; g < groupCount; ++g)
+	{
+		const int base = g * groupSize;
+
+		// inside of the group: k enumerates the pairs (i, j), j < i
+		samplePairs(innerPairs, pIn, rng, [&](qint64 k)
+		{
+			qint64 i = qint64((1 + std::sqrt(1.0 + 8.0 * k)) / 2);
+			while (i * (i - 1) / 2 > k)
+				--i;
+			while ((i + 1) * i / 2 <= k)
+				++i;
+
+			qint64 j = k - i * (i - 1) / 2;
+			addEdge(graph, base + int(i), base + int(j));
+		});
+
+		// to the following groups: k enumerates the pairs (i, j) row by row
+		for (int h = g + 1; h < groupCount; ++h)
+		{
+			const int otherBase = h * groupSize;
+
+			samplePairs(outerPairs, pOut, rng, [&](qint64 k)
+			{
+				addEdge(graph, base + int(k / groupSize), otherBase + int(k % groupSize));
+			});
+		}
+	}
+}
+
+
+// building blocks
+
+void CGraphGenerators::reserve(Graph& graph, int nodeCount, int edgeCount)
+{
+	graph.nodes.reserve(graph.nodes.size() + qMax(0, nodeCount));
+	graph.edges.reserve(graph.edges.size() + qMax(0, edgeCount));
+}
+
+
+void CGraphGenerators::addNode(Graph& graph, int index, double x, double y)
+{
+	Node node;
+	node.id = QByteArray::number(index);
+	node.attrs["x"] = x;
+	node.attrs["y"] = y;
+	node.attrs["label"] = QStringLiteral("Node ") + QString::number(index);
+	graph.nodes.append(node);
+}
+
+
+void CGraphGenerators::addEdge(Graph& graph, int startIndex, int endIndex)
+{
+	Edge edge;
+	edge.id = "e" + QByteArray::number(graph.edges.size());
+	edge.startNodeId = QByteArray::number(startIndex);
+	edge.endNodeId = QByteArray::number(endIndex);
+	graph.edges.append(edge);
+}
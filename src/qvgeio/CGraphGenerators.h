@@ -0,0 +1,42 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#pragma once
+
+#include <qvgeio/CGraphBase.h>
+
+
+// Synthetic graphs generated straight into the Graph model (no external libraries needed).
+// Deterministic: the same parameters & seed always give the same graph on every platform.
+// The items are appended to the graph; node ids are their indices, edge ids are "e<index>".
+
+class CGraphGenerators
+{
+public:
+	// rows x columns lattice, edges to the right & down neighbours
+	static void grid(int rows, int columns, Graph& graph);
+
+	// G(n, m): `edgeCount` edges between uniformly random node pairs
+	static void erdosRenyi(int nodeCount, int edgeCount, Graph& graph, quint32 seed = 1);
+
+	// Barabasi-Albert: every new node attaches to `m` nodes chosen by their degree
+	static void barabasiAlbert(int nodeCount, int m, Graph& graph, quint32 seed = 1);
+
+	// complete tree: every node has `branching` children, placed level by level
+	static void tree(int nodeCount, int branching, Graph& graph);
+
+	// `groupCount` groups of `groupSize` nodes: node pairs of the same group are connected
+	// with probability `pIn`, of different groups with `pOut`; nodes get the "group" attribute
+	static void plantedPartition(int groupCount, int groupSize, double pIn, double pOut, Graph& graph, quint32 seed = 1);
+
+	// building blocks
+	static void reserve(Graph& graph, int nodeCount, int edgeCount);
+	static void addNode(Graph& graph, int index, double x, double y);
+	static void addEdge(Graph& graph, int startIndex, int endIndex);
+};
@@ -0,0 +1,491 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#include "CLayeredLayout.h"
+
+#include <QtConcurrent/QtConcurrentRun>
+#include <QFutureSynchronizer>
+#include <QThreadPool>
+#include <QThread>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include <QPair>
+#include <QObject>
+
+#include <algorithm>
+#include <climits>
+
+
+// node size when not given
+static const double defaultNodeSize = 11.0;
+
+// items per parallel task at least
+static const int minChunkSize = 1024;
+
+
+// runs func(begin, end) over the chunks of [0, count) in the pool, or in place if not worth it
+template<class Func>
+static void parallelFor(QThreadPool& pool, int count, int minChunk, const Func& func)
+{
+	int chunks = qMin(pool.maxThreadCount(), count / qMax(1, minChunk));
+	if (chunks < 2)
+	{
+		func(0, count);
+		return;
+	}
+
+	QFutureSynchronizer<void> tasks;
+	for (int c = 0; c < chunks; ++c)
+	{
+		int begin = int(qint64(count) * c / chunks);
+		int end = int(qint64(count) * (c + 1) / chunks);
+		tasks.addFuture(QtConcurrent::run(&pool, [&func, begin, end]() { func(begin, end); }));
+	}
+
+	tasks.waitForFinished();
+}
+
+
+// crossings between a layer and the next one (accumulator tree, Barth et al.)
+static qint64 countCrossings(const QVector<int>& upper, int lowerSize, const QVector<QVector<int>>& down, const QVector<int>& pos)
+{
+	QVector<int> sequence;
+	QVector<int> targets;
+
+	for (int u : upper)
+	{
+		targets.clear();
+		for (int v : down[u])
+			targets << pos[v];
+
+		std::sort(targets.begin(), targets.end());
+		sequence += targets;
+	}
+
+	// count of the inserted values > x, for each x
+	QVector<int> tree(lowerSize + 1, 0);
+	qint64 crossings = 0;
+	int inserted = 0;
+
+	for (int x : sequence)
+	{
+		int notGreater = 0;
+		for (int i = x + 1; i > 0; i -= i & -i)
+			notGreater += tree[i];
+
+		crossings += inserted - notGreater;
+
+		for (int i = x + 1; i <= lowerSize; i += i & -i)
+			tree[i]++;
+
+		inserted++;
+	}
+
+	return crossings;
+}
+
+
+static double median(QVector<double>& values)
+{
+	int mid = values.size() / 2;
+	std::nth_element(values.begin(), values.begin() + mid, values.end());
+	double m = values[mid];
+
+	if (values.size() % 2 == 0)
+	{
+		double lower = *std::max_element(values.begin(), values.begin() + mid);
+		m = (m + lower) / 2;
+	}
+
+	return m;
+}
+
+
+bool CLayeredLayout::run(Graph& graph, QString* lastError)
+{
+	m_layerCount = 0;
+	m_crossingCount = 0;
+
+	const int nodeCount = graph.nodes.size();
+	if (nodeCount == 0)
+		return true;
+
+	QThreadPool pool;
+	pool.setMaxThreadCount(m_options.threads > 0 ? m_options.threads : QThread::idealThreadCount());
+
+	// ids -> indices
+	QHash<QByteArray, int> nodeIndex;
+	nodeIndex.reserve(nodeCount);
+	for (int i = 0; i < nodeCount; ++i)
+	{
+		// the edges could not be resolved
+		const QByteArray& id = graph.nodes.at(i).id;
+		if (nodeIndex.contains(id))
+		{
+			if (lastError)
+				*lastError = QObject::tr("Node ID is not unique: %1").arg(QString::fromUtf8(id));
+
+			return false;
+		}
+
+		nodeIndex.insert(id, i);
+	}
+
+	// edges without loops & duplicates
+	QVector<QVector<int>> out(nodeCount);
+	QSet<quint64> edgeSet;
+
+	for (const Edge& edge : graph.edges)
+	{
+		int u = nodeIndex.value(edge.startNodeId, -1);
+		int v = nodeIndex.value(edge.endNodeId, -1);
+		if (u < 0 || v < 0 || u == v)
+			continue;
+
+		quint64 key = (quint64(u) << 32) | quint32(v);
+		if (edgeSet.contains(key))
+			continue;
+
+		edgeSet.insert(key);
+		out[u] << v;
+	}
+
+	// cycle removal: back edges of DFS are reversed
+	QVector<QVector<int>> succ(nodeCount), pred(nodeCount);
+	{
+		QSet<quint64> dagSet;
+		auto addDagEdge = [&](int u, int v)
+		{
+			quint64 key = (quint64(u) << 32) | quint32(v);
+			if (!dagSet.contains(key))
+			{
+				dagSet.insert(key);
+				succ[u] << v;
+				pred[v] << u;
+			}
+		};
+
+		QVector<char> state(nodeCount, 0);	// 0: new, 1: on stack, 2: done
+		QVector<QPair<int, int>> stack;		// node, next edge
+
+		for (int start = 0; start < nodeCount; ++start)
+		{
+			if (state[start])
+				continue;
+
+			state[start] = 1;
+			stack << qMakePair(start, 0);
+
+			while (stack.size())
+			{
+				int u = stack.last().first;
+				int next = stack.last().second;
+
+				if (next < out[u].size())
+				{
+					stack.last().second++;
+
+					int v = out[u][next];
+					if (state[v] == 1)
+						addDagEdge(v, u);
+					else
+					{
+						addDagEdge(u, v);
+
+						if (state[v] == 0)
+						{
+							state[v] = 1;
+							stack << qMakePair(v, 0);
+						}
+					}
+				}
+				else
+				{
+					state[u] = 2;
+					stack.removeLast();
+				}
+			}
+		}
+	}
+
+	// layering: longest path from the sources
+	QVector<int> topo;
+	topo.reserve(nodeCount);
+	{
+		QVector<int> inDegree(nodeCount);
+		for (int v = 0; v < nodeCount; ++v)
+		{
+			inDegree[v] = pred[v].size();
+			if (inDegree[v] == 0)
+				topo << v;
+		}
+
+		for (int k = 0; k < topo.size(); ++k)
+		{
+			for (int v : succ[topo[k]])
+			{
+				if (--inDegree[v] == 0)
+					topo << v;
+			}
+		}
+
+		Q_ASSERT(topo.size() == nodeCount);
+	}
+
+	QVector<int> layer(nodeCount, 0);
+	for (int u : topo)
+	{
+		for (int v : succ[u])
+			layer[v] = qMax(layer[v], layer[u] + 1);
+	}
+
+	// sources go down to their successors: shorter edges
+	for (int k = nodeCount - 1; k >= 0; --k)
+	{
+		int u = topo[k];
+		if (pred[u].isEmpty() && succ[u].size())
+		{
+			int minLayer = INT_MAX;
+			for (int v : succ[u])
+				minLayer = qMin(minLayer, layer[v]);
+
+			layer[u] = minLayer - 1;
+		}
+	}
+
+	int layerCount = 0;
+	for (int l : layer)
+		layerCount = qMax(layerCount, l + 1);
+
+	// layered graph: long edges are split by dummy nodes
+	QVector<int> lLayer = layer;
+	QVector<double> lWidth(nodeCount), lHeight(nodeCount);
+	QVector<QVector<int>> up(nodeCount), down(nodeCount);
+	QVector<QVector<int>> layers(layerCount);
+
+	for (int i = 0; i < nodeCount; ++i)
+	{
+		const GraphAttributes& attrs = graph.nodes.at(i).attrs;
+		lWidth[i] = attrs.value("width", defaultNodeSize).toDouble();
+		lHeight[i] = attrs.value("height", defaultNodeSize).toDouble();
+	}
+
+	auto link = [&](int u, int v)
+	{
+		down[u] << v;
+		up[v] << u;
+	};
+
+	// initial order: topological, dummies next to their edges
+	for (int u : topo)
+	{
+		layers[layer[u]] << u;
+
+		for (int v : succ[u])
+		{
+			int prev = u;
+
+			for (int l = layer[u] + 1; l < layer[v]; ++l)
+			{
+				int dummy = lLayer.size();
+				lLayer << l;
+				lWidth << 0;
+				lHeight << 0;
+				up << QVector<int>();
+				down << QVector<int>();
+				layers[l] << dummy;
+
+				link(prev, dummy);
+				prev = dummy;
+			}
+
+			link(prev, v);
+		}
+	}
+
+	const int lCount = lLayer.size();
+
+	QVector<int> pos(lCount);
+	auto updatePositions = [&]()
+	{
+		for (const QVector<int>& lay : layers)
+			for (int i = 0; i < lay.size(); ++i)
+				pos[lay[i]] = i;
+	};
+
+	updatePositions();
+
+	// total crossings, the layer pairs are counted in parallel
+	QVector<qint64> pairCrossings(qMax(0, layerCount - 1));
+	auto totalCrossings = [&]()
+	{
+		parallelFor(pool, pairCrossings.size(), 1, [&](int begin, int end)
+		{
+			for (int l = begin; l < end; ++l)
+				pairCrossings[l] = countCrossings(layers[l], layers[l + 1].size(), down, pos);
+		});
+
+		qint64 total = 0;
+		for (qint64 c : pairCrossings)
+			total += c;
+		return total;
+	};
+
+	// crossing minimization: barycenter sweeps down & up, the best order is kept
+	qint64 bestCrossings = totalCrossings();
+	QVector<QVector<int>> bestLayers = layers;
+	QVector<double> key(lCount);
+
+	for (int sweep = 0; sweep < m_options.sweeps && bestCrossings > 0; ++sweep)
+	{
+		bool downwards = (sweep % 2 == 0);
+		const QVector<QVector<int>>& fixedNeighbors = downwards ? up : down;
+
+		for (int step = 1; step < layerCount; ++step)
+		{
+			QVector<int>& lay = layers[downwards ? step : layerCount - 1 - step];
+
+			parallelFor(pool, lay.size(), minChunkSize, [&](int begin, int end)
+			{
+				for (int i = begin; i < end; ++i)
+				{
+					int v = lay[i];
+					const QVector<int>& neighbors = fixedNeighbors[v];
+
+					// no neighbors: stays in place
+					if (neighbors.isEmpty())
+					{
+						key[v] = pos[v];
+						continue;
+					}
+
+					double sum = 0;
+					for (int n : neighbors)
+						sum += pos[n];
+					key[v] = sum / neighbors.size();
+				}
+			});
+
+			std::stable_sort(lay.begin(), lay.end(), [&key](int a, int b) { return key[a] < key[b]; });
+
+			for (int i = 0; i < lay.size(); ++i)
+				pos[lay[i]] = i;
+		}
+
+		qint64 crossings = totalCrossings();
+		if (crossings < bestCrossings)
+		{
+			bestCrossings = crossings;
+			bestLayers = layers;
+		}
+	}
+
+	layers = bestLayers;
+	updatePositions();
+
+	// coordinates: the nodes go to the median of their neighbors keeping the order & distances;
+	// all the layers are done in parallel from the previous pass
+	auto separation = [&](int a, int b)
+	{
+		bool dummy = (a >= nodeCount || b >= nodeCount);
+		return (lWidth[a] + lWidth[b]) / 2 + (dummy ? m_options.nodeSpacing / 2 : m_options.nodeSpacing);
+	};
+
+	QVector<double> x(lCount), nextX(lCount);
+
+	for (const QVector<int>& lay : layers)
+	{
+		double left = 0;
+		for (int i = 0; i < lay.size(); ++i)
+		{
+			if (i > 0)
+				left += separation(lay[i - 1], lay[i]);
+			x[lay[i]] = left;
+		}
+
+		// centered
+		for (int v : lay)
+			x[v] -= left / 2;
+	}
+
+	for (int pass = 0; pass < m_options.alignPasses; ++pass)
+	{
+		parallelFor(pool, layerCount, 1, [&](int begin, int end)
+		{
+			QVector<double> desired, leftX, rightX, values;
+
+			for (int l = begin; l < end; ++l)
+			{
+				const QVector<int>& lay = layers[l];
+				const int size = lay.size();
+				if (size == 0)
+					continue;
+
+				desired.resize(size);
+				for (int i = 0; i < size; ++i)
+				{
+					int v = lay[i];
+
+					values.clear();
+					for (int n : up[v])
+						values << x[n];
+					for (int n : down[v])
+						values << x[n];
+
+					desired[i] = values.isEmpty() ? x[v] : median(values);
+				}
+
+				// as close as possible from the left & from the right, then the average
+				leftX.resize(size);
+				rightX.resize(size);
+
+				leftX[0] = desired[0];
+				for (int i = 1; i < size; ++i)
+					leftX[i] = qMax(desired[i], leftX[i - 1] + separation(lay[i - 1], lay[i]));
+
+				rightX[size - 1] = desired[size - 1];
+				for (int i = size - 2; i >= 0; --i)
+					rightX[i] = qMin(desired[i], rightX[i + 1] - separation(lay[i], lay[i + 1]));
+
+				for (int i = 0; i < size; ++i)
+					nextX[lay[i]] = (leftX[i] + rightX[i]) / 2;
+			}
+		});
+
+		x.swap(nextX);
+	}
+
+	// layers from the top
+	QVector<double> layerY(layerCount);
+	{
+		QVector<double> layerHeight(layerCount, 0);
+		for (int i = 0; i < nodeCount; ++i)
+			layerHeight[layer[i]] = qMax(layerHeight[layer[i]], lHeight[i]);
+
+		double y = 0;
+		for (int l = 0; l < layerCount; ++l)
+		{
+			if (l > 0)
+				y += (layerHeight[l - 1] + layerHeight[l]) / 2 + m_options.layerSpacing;
+			layerY[l] = y;
+		}
+	}
+
+	for (int i = 0; i < nodeCount; ++i)
+	{
+		graph.nodes[i].attrs["x"] = x[i];
+		graph.nodes[i].attrs["y"] = layerY[layer[i]];
+	}
+
+	m_layerCount = layerCount;
+	m_crossingCount = bestCrossings;
+
+	return true;
+}
@@ -0,0 +1,55 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#pragma once
+
+#include <qvgeio/CGraphBase.h>
+
+
+// Layered (Sugiyama-style) layout of the Graph model, for DAGs first of all:
+// cycle removal (DFS), longest path layering, barycentric crossing minimization with the
+// crossings counted in parallel, and median-based coordinate assignment done per layer in parallel.
+// The result is written to "x" & "y" attributes of the nodes; node sizes are read from "width" & "height".
+
+class CLayeredLayout
+{
+public:
+	struct Options
+	{
+		// distance between the layers (from bottom of one to top of the next one)
+		double layerSpacing = 60;
+
+		// free space between the neighbors in a layer
+		double nodeSpacing = 30;
+
+		// crossing minimization passes (down & up)
+		int sweeps = 12;
+
+		// coordinate assignment passes
+		int alignPasses = 8;
+
+		// 0: all the cores
+		int threads = 0;
+	};
+
+	CLayeredLayout() {}
+	explicit CLayeredLayout(const Options& options): m_options(options) {}
+
+	bool run(Graph& graph, QString* lastError = nullptr);
+
+	// after run()
+	int layerCount() const { return m_layerCount; }
+	qint64 crossingCount() const { return m_crossingCount; }
+
+private:
+	Options m_options;
+
+	int m_layerCount = 0;
+	qint64 m_crossingCount = 0;
+};
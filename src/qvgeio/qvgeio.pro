@@ -4,7 +4,7 @@ TARGET = qvgeio
 
 # common config
 CONFIG += static c++14
-QT += core xml
+QT += core xml concurrent
 
 
 # compiler stuff
@@ -0,0 +1,466 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#include "CBatchConverter.h"
+#include "CImportExportUIController.h"
+
+#include <qvgelib/CNodeEditorScene.h>
+#include <qvgelib/CNode.h>
+#include <qvgelib/CEdge.h>
+#include <qvgelib/CImageExport.h>
+#include <qvgelib/CPDFExport.h>
+#include <qvgelib/CSVGExport.h>
+#include <qvgelib/CFileSerializerGEXF.h>
+#include <qvgelib/CFileSerializerGraphML.h>
+#include <qvgelib/CFileSerializerXGR.h>
+#include <qvgelib/CFileSerializerXGRJ.h>
+#include <qvgelib/CFileSerializerDOT.h>
+#include <qvgelib/CFileSerializerCSV.h>
+
+#include <qvgeio/CGraphBase.h>
+#include <qvgeio/CFormatGraphML.h>
+
+#include <QtConcurrent/QtConcurrentRun>
+#include <QThread>
+#include <QThreadPool>
+#include <QVector>
+#include <QElapsedTimer>
+#include <QImageWriter>
+#include <QFileInfo>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QScopedPointer>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_MAC)
+#include <mach/mach.h>
+#endif
+
+
+static double elapsedMs(const QElapsedTimer& timer)
+{
+	return timer.nsecsElapsed() / 1000000.0;
+}
+
+
+// Result
+
+QJsonObject CBatchConverter::Result::toJson() const
+{
+	QJsonObject json;
+	json["file"] = fileName;
+	json["status"] = ok ? "ok" : "failed";
+	if (error.size())
+		json["error"] = error;
+	json["nodes"] = nodes;
+	json["edges"] = edges;
+	json["loadMs"] = loadMs;
+	json["totalMs"] = totalMs;
+	json["stateBytes"] = stateBytes;
+	if (residentBytes >= 0)
+		json["residentBytes"] = residentBytes;
+
+	QJsonArray outputsJson;
+	for (const Output& output : outputs)
+	{
+		QJsonObject outputJson;
+		outputJson["file"] = output.fileName;
+		outputJson["status"] = output.ok ? "ok" : "failed";
+		if (output.error.size())
+			outputJson["error"] = output.error;
+		outputJson["ms"] = output.ms;
+		outputsJson.append(outputJson);
+	}
+	json["outputs"] = outputsJson;
+
+	return json;
+}
+
+
+// CBatchConverter
+
+CBatchConverter::CBatchConverter(const Options& options):
+	m_options(options)
+{
+	for (QString& format : m_options.formats)
+		format = format.toLower();
+
+	if (m_options.formats.contains("pdf"))
+		m_pdfExport = new CPDFExport();
+}
+
+
+CBatchConverter::~CBatchConverter()
+{
+	delete m_pdfExport;
+}
+
+
+QStringList CBatchConverter::inputFormats()
+{
+	return { "xgr", "xgrj", "graphml", "gexf", "dot", "gv", "plain", "txt", "csv" };
+}
+
+
+QStringList CBatchConverter::outputFormats()
+{
+	QStringList formats = { "xgr", "xgrj", "graphml", "gexf", "dot", "gv", "svg", "pdf" };
+
+	for (const QByteArray& format : QImageWriter::supportedImageFormats())
+	{
+		if (!formats.contains(format.toLower()))
+			formats << format.toLower();
+	}
+
+	return formats;
+}
+
+
+bool CBatchConverter::checkFormats(QString* lastError) const
+{
+	if (m_options.formats.isEmpty())
+	{
+		if (lastError)
+			*lastError = QObject::tr("No output format given");
+		return false;
+	}
+
+	QStringList supported = outputFormats();
+
+	for (const QString& format : m_options.formats)
+	{
+		if (!supported.contains(format))
+		{
+			if (lastError)
+				*lastError = QObject::tr("Output format is not supported: %1").arg(format);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+QList<CBatchConverter::Result> CBatchConverter::run(const QStringList& fileNames)
+{
+	QList<Result> results;
+
+	if (fileNames.isEmpty())
+		return results;
+
+	int jobs = m_options.jobs > 0 ? m_options.jobs : QThread::idealThreadCount();
+	jobs = qBound(1, jobs, fileNames.size());
+
+	QThreadPool pool;
+	pool.setMaxThreadCount(jobs);
+
+	// parsed ahead by the workers, a few files only to limit the memory
+	QVector<QFuture<Parsed>> parsed(fileNames.size());
+	int started = 0;
+
+	auto parseAhead = [&](int count)
+	{
+		for (; started < qMin(count, fileNames.size()); ++started)
+		{
+			QString fileName = fileNames.at(started);
+			parsed[started] = QtConcurrent::run(&pool, [this, fileName]() { return parse(fileName); });
+		}
+	};
+
+	// the outputs written by the workers are collected when the next file is done
+	QVector<QList<QFuture<Output>>> writes(fileNames.size());
+
+	auto finish = [&](int index)
+	{
+		Result& result = results[index];
+
+		for (QFuture<Output>& write : writes[index])
+		{
+			Output output = write.result();
+
+			result.ok = result.ok && output.ok;
+			result.totalMs += output.ms;
+			result.outputs << output;
+		}
+
+		writes[index].clear();
+
+		result.residentBytes = residentMemory();
+
+		if (m_progress)
+			m_progress(result);
+	};
+
+	// only one scene, in the GUI thread
+	CNodeEditorScene scene;
+
+	for (int index = 0; index < fileNames.size(); ++index)
+	{
+		parseAhead(index + 1 + jobs);
+
+		results << convert(fileNames.at(index), parsed[index].result(), scene, pool, writes[index]);
+
+		// free the graph
+		parsed[index] = QFuture<Parsed>();
+
+		if (index > 0)
+			finish(index - 1);
+	}
+
+	finish(fileNames.size() - 1);
+
+	return results;
+}
+
+
+CBatchConverter::Parsed CBatchConverter::parse(const QString& fileName) const
+{
+	Parsed parsed;
+
+	CAsyncGraphLoader::Parser parser = CImportExportUIController::graphParser(QFileInfo(fileName).suffix().toLower(), fileName);
+	if (!parser)
+		return parsed;
+
+	QElapsedTimer timer;
+	timer.start();
+
+	parsed.graph.reset(new Graph);
+
+	try
+	{
+		parsed.ok = parser(*parsed.graph, &parsed.error);
+	}
+	catch (...)
+	{
+		parsed.ok = false;
+	}
+
+	parsed.ms = elapsedMs(timer);
+	return parsed;
+}
+
+
+CBatchConverter::Result CBatchConverter::convert(const QString& fileName, const Parsed& parsed, CNodeEditorScene& scene, QThreadPool& pool, QList<QFuture<Output>>& writes) const
+{
+	Result result;
+	result.fileName = fileName;
+
+	QElapsedTimer timer;
+	timer.start();
+
+	bool loaded = false;
+
+	if (parsed.graph)
+		loaded = parsed.ok && scene.fromGraph(*parsed.graph);
+	else
+		loaded = load(fileName, scene, &result.error);
+
+	if (!loaded)
+	{
+		if (result.error.isEmpty())
+			result.error = parsed.error.size() ? parsed.error : QObject::tr("Cannot load file");
+
+		scene.reset();
+
+		result.totalMs = parsed.ms + elapsedMs(timer);
+		return result;
+	}
+
+	result.loadMs = parsed.ms + elapsedMs(timer);
+	result.totalMs = result.loadMs;
+	result.nodes = scene.getItems<CNode>().size();
+	result.edges = scene.getItems<CEdge>().size();
+	result.stateBytes = scene.getStateSnapshot().size();
+
+	QFileInfo inputInfo(fileName);
+	QDir outputDir(m_options.outputDir.isEmpty() ? inputInfo.absolutePath() : m_options.outputDir);
+
+	result.ok = true;
+
+	// taken once for all the Graph based outputs
+	QSharedPointer<Graph> graph;
+
+	for (const QString& format : m_options.formats)
+	{
+		Output output;
+		output.fileName = outputDir.filePath(inputInfo.completeBaseName() + "." + format);
+
+		// never overwrite the input
+		if (QFileInfo(output.fileName) == inputInfo)
+			output.fileName = outputDir.filePath(inputInfo.completeBaseName() + ".converted." + format);
+
+		timer.start();
+
+		// written by a worker
+		if (format == "graphml")
+		{
+			if (!graph)
+			{
+				graph.reset(new Graph);
+				scene.toGraph(*graph);
+			}
+
+			writes << QtConcurrent::run(&pool, [output, graph]() mutable
+			{
+				QElapsedTimer writeTimer;
+				writeTimer.start();
+
+				output.ok = CFormatGraphML().save(output.fileName, *graph, &output.error);
+
+				if (!output.ok && output.error.isEmpty())
+					output.error = QObject::tr("Cannot save file");
+
+				output.ms = elapsedMs(writeTimer);
+				return output;
+			});
+
+			continue;
+		}
+
+		QScopedPointer<IFileSerializer> saver(createSaver(format));
+		IFileSerializer *exporter = (format == "pdf") ? m_pdfExport : saver.data();
+
+		if (exporter)
+			output.ok = exporter->save(output.fileName, scene, &output.error);
+		else
+			output.error = QObject::tr("Output format is not supported: %1").arg(format);
+
+		if (!output.ok && output.error.isEmpty())
+			output.error = QObject::tr("Cannot save file");
+
+		output.ms = elapsedMs(timer);
+
+		result.ok = result.ok && output.ok;
+		result.totalMs += output.ms;
+		result.outputs << output;
+	}
+
+	// free the items before the next file
+	scene.reset();
+
+	return result;
+}
+
+
+// the formats read by the scene itself
+bool CBatchConverter::load(const QString& fileName, CNodeEditorScene& scene, QString* lastError) const
+{
+	QString format = QFileInfo(fileName).suffix().toLower();
+
+	if (format == "xgr")
+		return CFileSerializerXGR().load(fileName, scene, lastError);
+
+	if (format == "xgrj")
+		return CFileSerializerXGRJ().load(fileName, scene, lastError);
+
+	if (format == "gexf")
+		return CFileSerializerGEXF().load(fileName, scene, lastError);
+
+	if (format == "csv")
+	{
+		CFileSerializerCSV csvLoader;
+		csvLoader.setDelimiter(m_options.csvDelimiter);
+		return csvLoader.load(fileName, scene, lastError);
+	}
+
+	if (lastError)
+		*lastError = QObject::tr("Input format is not supported: %1").arg(format);
+
+	return false;
+}
+
+
+IFileSerializer* CBatchConverter::createSaver(const QString& format) const
+{
+	if (format == "xgr")
+		return new CFileSerializerXGR();
+
+	if (format == "xgrj")
+		return new CFileSerializerXGRJ();
+
+	if (format == "graphml")
+		return new CFileSerializerGraphML();
+
+	if (format == "gexf")
+		return new CFileSerializerGEXF();
+
+	if (format == "dot" || format == "gv")
+		return new CFileSerializerDOT();
+
+	if (format == "svg")
+		return new CSVGExport(m_options.cutContent, m_options.resolution);
+
+	// shared one
+	if (format == "pdf")
+		return nullptr;
+
+	if (QImageWriter::supportedImageFormats().contains(format.toLatin1()))
+		return new CImageExport(m_options.cutContent, m_options.resolution);
+
+	return nullptr;
+}
+
+
+// memory
+
+qint64 CBatchConverter::residentMemory()
+{
+#if defined(Q_OS_WIN)
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return counters.WorkingSetSize;
+#elif defined(Q_OS_MAC)
+	mach_task_basic_info info;
+	mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+	if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) == KERN_SUCCESS)
+		return info.resident_size;
+#elif defined(Q_OS_LINUX)
+	QFile status("/proc/self/status");
+	if (status.open(QIODevice::ReadOnly))
+	{
+		for (const QByteArray& line : status.readAll().split('\n'))
+		{
+			if (line.startsWith("VmRSS:"))
+				return line.mid(6).trimmed().split(' ').first().toLongLong() * 1024;
+		}
+	}
+#endif
+
+	return -1;
+}
+
+
+qint64 CBatchConverter::peakResidentMemory()
+{
+#if defined(Q_OS_WIN)
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return counters.PeakWorkingSetSize;
+#elif defined(Q_OS_MAC)
+	mach_task_basic_info info;
+	mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+	if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) == KERN_SUCCESS)
+		return info.resident_size_max;
+#elif defined(Q_OS_LINUX)
+	QFile status("/proc/self/status");
+	if (status.open(QIODevice::ReadOnly))
+	{
+		for (const QByteArray& line : status.readAll().split('\n'))
+		{
+			if (line.startsWith("VmHWM:"))
+				return line.mid(6).trimmed().split(' ').first().toLongLong() * 1024;
+		}
+	}
+#endif
+
+	return -1;
+}
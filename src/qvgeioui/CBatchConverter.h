@@ -0,0 +1,106 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QJsonObject>
+#include <QSharedPointer>
+#include <QFuture>
+
+#include <functional>
+
+struct Graph;
+class CNodeEditorScene;
+class IFileSerializer;
+class QThreadPool;
+
+
+// Headless conversion of the graph files: every input is loaded & saved into all the output formats.
+// The scene may live in the GUI thread only, so the files are built & exported by it one by one, while
+// a pool of workers parses the next files into the Graph model and writes the Graph based outputs.
+
+class CBatchConverter
+{
+public:
+	struct Options
+	{
+		QStringList formats;		// output suffixes: xgr, graphml, gexf, dot, svg, pdf, png (or another image format)...
+		QString outputDir;			// next to the input files if empty
+		int jobs = 0;				// workers, QThread::idealThreadCount() if 0
+		char csvDelimiter = ';';
+		bool cutContent = true;		// images & SVG
+		int resolution = 0;			// images & SVG, dpi
+	};
+
+	struct Output
+	{
+		QString fileName;
+		bool ok = false;
+		QString error;
+		double ms = 0;
+	};
+
+	struct Result
+	{
+		QString fileName;
+		bool ok = false;
+		QString error;
+		int nodes = 0;
+		int edges = 0;
+		double loadMs = 0;
+		double totalMs = 0;
+		qint64 stateBytes = 0;		// native state of the scene
+		qint64 residentBytes = -1;	// of the process (all workers) when finished, -1 if unknown
+		QList<Output> outputs;
+
+		QJsonObject toJson() const;
+	};
+
+	explicit CBatchConverter(const Options& options);
+	~CBatchConverter();
+
+	// false if some output format is not supported
+	bool checkFormats(QString* lastError = nullptr) const;
+
+	// blocking, must be called by the GUI thread; the results are in the order of the inputs
+	QList<Result> run(const QStringList& fileNames);
+
+	// called by the calling thread as the files are done
+	void setProgressCallback(std::function<void(const Result&)> callback) { m_progress = callback; }
+
+	static QStringList inputFormats();
+	static QStringList outputFormats();
+
+	// -1 if not available on the platform
+	static qint64 residentMemory();
+	static qint64 peakResidentMemory();
+
+private:
+	struct Parsed
+	{
+		QSharedPointer<Graph> graph;	// null if the format is read by the scene itself
+		bool ok = false;
+		QString error;
+		double ms = 0;
+	};
+
+	Parsed parse(const QString& fileName) const;
+	Result convert(const QString& fileName, const Parsed& parsed, CNodeEditorScene& scene, QThreadPool& pool, QList<QFuture<Output>>& writes) const;
+	bool load(const QString& fileName, CNodeEditorScene& scene, QString* lastError) const;
+	IFileSerializer* createSaver(const QString& format) const;
+
+	Options m_options;
+	std::function<void(const Result&)> m_progress;
+
+	// has a page setup dialog inside: created by the GUI thread
+	class CPDFExport *m_pdfExport = nullptr;
+};
@@ -10,6 +10,8 @@ It can be used freely, maintaining the information above.
 #include <QFileInfo>
 #include <QFileDialog>
 #include <QStatusBar>
+#include <QProgressDialog>
+#include <QEventLoop>
 #include <QDebug>
 
 #include <CImportExportUIController.h>
@@ -39,10 +41,17 @@ It can be used freely, maintaining the information above.
 #include <qvgelib/CFileSerializerGEXF.h>
 #include <qvgelib/CFileSerializerGraphML.h>
 #include <qvgelib/CFileSerializerXGR.h>
+#include <qvgelib/CFileSerializerXGRJ.h>
 #include <qvgelib/CFileSerializerDOT.h>
 #include <qvgelib/CFileSerializerPlainDOT.h>
 #include <qvgelib/CFileSerializerCSV.h>
 #include <qvgelib/ISceneItemFactory.h>
+#include <qvgelib/CAsyncGraphLoader.h>
+
+#include <qvgeio/CGraphBase.h>
+#include <qvgeio/CFormatGraphML.h>
+#include <qvgeio/CFormatDOT.h>
+#include <qvgeio/CFormatPlainDOT.h>
 
 
 CImportExportUIController::CImportExportUIController(CMainWindow *parent): QObject(parent)
@@ -52,6 +61,14 @@ CImportExportUIController::CImportExportUIController(CMainWindow *parent): QObje
 	// export dialogs
 	m_dotDialog = new CDOTExportDialog(parent);
 	m_imageDialog = new CImageExportDialog(parent);
+
+	m_xgrjSerializer = new CFileSerializerXGRJ();
+}
+
+
+CImportExportUIController::~CImportExportUIController()
+{
+	delete m_xgrjSerializer;
 }
 
 
@@ -215,16 +232,23 @@ bool CImportExportUIController::importCSV(CEditorScene& scene, const QString &fi
 
 bool CImportExportUIController::loadFromFile(const QString &format, const QString &fileName, CNodeEditorScene& scene, QString* lastError)
 {
+	m_loadCanceled = false;
+
 	try 
 	{
+		if (format == "graphml" || format == "plain" || format == "txt")
+		{
+			return loadAsync(format, fileName, scene, lastError);
+		}
+
 		if (format == "xgr")
 		{
 			return (CFileSerializerXGR().load(fileName, scene, lastError));
 		}
 
-		if (format == "graphml")
+		if (format == "xgrj")
 		{
-			return (CFileSerializerGraphML().load(fileName, scene, lastError));
+			return (m_xgrjSerializer->load(fileName, scene, lastError));
 		}
 
 		if (format == "gexf")
@@ -243,15 +267,8 @@ bool CImportExportUIController::loadFromFile(const QString &format, const QStrin
 					return true;
 			}
 #endif
-			// try to load via boost
-#ifdef USE_BOOST
-			return (CFileSerializerDOT().load(fileName, scene, lastError));
-#endif
-		}
-
-		if (format == "plain" || format == "txt")
-		{
-			return (CFileSerializerPlainDOT().load(fileName, scene, lastError));
+			// native reader (no layout)
+			return loadAsync(format, fileName, scene, lastError);
 		}
 
 		if (format == "csv")
@@ -273,11 +290,105 @@ bool CImportExportUIController::loadFromFile(const QString &format, const QStrin
 }
 
 
+CAsyncGraphLoader::Parser CImportExportUIController::graphParser(const QString &format, const QString &fileName)
+{
+	if (format == "graphml")
+		return [fileName](Graph& graph, QString* parseError) { return CFormatGraphML().load(fileName, graph, parseError); };
+
+	if (format == "dot" || format == "gv")
+		return [fileName](Graph& graph, QString* parseError) { return CFormatDOT().load(fileName, graph, parseError); };
+
+	if (format == "plain" || format == "txt")
+		return [fileName](Graph& graph, QString* parseError) { return CFormatPlainDOT().load(fileName, graph, parseError); };
+
+	return CAsyncGraphLoader::Parser();
+}
+
+
+bool CImportExportUIController::canReadGraphViaScene(const QString &format)
+{
+	return format == "xgr" || format == "xgrj" || format == "gexf";
+}
+
+
+bool CImportExportUIController::readGraphViaScene(const QString &format, const QString &fileName, Graph &graph, QString* lastError)
+{
+	CNodeEditorScene tempScene;
+	bool ok = false;
+
+	if (format == "xgr")
+		ok = CFileSerializerXGR().load(fileName, tempScene, lastError);
+	else if (format == "xgrj")
+		ok = CFileSerializerXGRJ().load(fileName, tempScene, lastError);
+	else if (format == "gexf")
+		ok = CFileSerializerGEXF().load(fileName, tempScene, lastError);
+	else if (lastError)
+		*lastError = tr("Format is not supported: %1").arg(format);
+
+	return ok && tempScene.toGraph(graph);
+}
+
+
+bool CImportExportUIController::loadAsync(const QString &format, const QString &fileName, CNodeEditorScene& scene, QString* lastError)
+{
+	CAsyncGraphLoader::Parser parser = graphParser(format, fileName);
+
+	CAsyncGraphLoader loader(scene);
+
+	// modal from the start: the window may not be used while the scene is built
+	QProgressDialog progressDialog(tr("Reading %1...").arg(QFileInfo(fileName).fileName()), tr("Cancel"), 0, 0, m_parent);
+	progressDialog.setWindowTitle(tr("Opening"));
+	progressDialog.setWindowModality(Qt::WindowModal);
+	progressDialog.setMinimumDuration(0);
+	progressDialog.setAutoClose(false);
+	progressDialog.setAutoReset(false);
+	progressDialog.show();
+
+	connect(&progressDialog, &QProgressDialog::canceled, &loader, &CAsyncGraphLoader::cancel);
+
+	connect(&loader, &CAsyncGraphLoader::progress, &progressDialog, [&](int done, int total)
+	{
+		if (total > 0 && progressDialog.maximum() == 0)
+		{
+			progressDialog.setLabelText(tr("Creating %1 items...").arg(total));
+			progressDialog.setMaximum(total);
+		}
+
+		progressDialog.setValue(done);
+	});
+
+	QEventLoop loop;
+	bool ok = false;
+
+	connect(&loader, &CAsyncGraphLoader::finished, &loop, [&](bool result, const QString& error)
+	{
+		ok = result;
+		if (lastError)
+			*lastError = error;
+
+		loop.quit();
+	});
+
+	loader.start(parser);
+
+	// the GUI is running meanwhile, the dialog blocks the input to the window
+	if (loader.isRunning())
+		loop.exec();
+
+	m_loadCanceled = loader.isCanceled();
+
+	return ok;
+}
+
+
 bool CImportExportUIController::saveToFile(const QString &format, const QString &fileName, CNodeEditorScene& scene, QString* lastError)
 {
     if (format == "xgr")
         return (CFileSerializerXGR().save(fileName, scene, lastError));
 
+    if (format == "xgrj")
+        return (m_xgrjSerializer->save(fileName, scene, lastError));
+
     if (format == "dot" || format == "gv")
         return (CFileSerializerDOT().save(fileName, scene, lastError));
 
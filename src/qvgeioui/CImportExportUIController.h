@@ -13,10 +13,13 @@ class CMainWindow;
 class CEditorScene;
 class CNodeEditorScene;
 class IFileSerializer;
+class CFileSerializerXGRJ;
 
 // think: to move?
 class CGVGraphLayoutUIController;
 
+#include <qvgelib/CAsyncGraphLoader.h>
+
 #include <QSettings>
 
 
@@ -26,6 +29,7 @@ class CImportExportUIController: public QObject
 
 public:
 	CImportExportUIController(CMainWindow *parent);
+	virtual ~CImportExportUIController();
 
 	// think: to move?
 	void setGVGraphController(CGVGraphLayoutUIController *gvController) { m_gvController = gvController; }
@@ -42,12 +46,28 @@ public:
 	bool loadFromFile(const QString &format, const QString &fileName, CNodeEditorScene& scene, QString* lastError);
 	bool saveToFile(const QString &format, const QString &fileName, CNodeEditorScene& scene, QString* lastError);
 
+	// true if the last loadFromFile() was canceled by user
+	bool isLoadCanceled() const { return m_loadCanceled; }
+
+	// reader of the format into Graph model (can run on a worker thread), empty if there is none
+	static CAsyncGraphLoader::Parser graphParser(const QString &format, const QString &fileName);
+
+	// the formats read by the scene itself (XGR, XGRJ, GEXF): via a temporary scene, by the GUI thread
+	static bool canReadGraphViaScene(const QString &format);
+	static bool readGraphViaScene(const QString &format, const QString &fileName, Graph &graph, QString* lastError);
+
 private:
 	bool doExport(CEditorScene& scene, const IFileSerializer &exporter);
 
+	// formats parsed into Graph model are loaded asynchronously, with progress
+	bool loadAsync(const QString &format, const QString &fileName, CNodeEditorScene& scene, QString* lastError);
+
 private:
 	CMainWindow *m_parent = nullptr;
 
+	// keeps the last saved state of the document for incremental saves
+	CFileSerializerXGRJ *m_xgrjSerializer = nullptr;
+
 	class CDOTExportDialog *m_dotDialog = nullptr;
 	class CImageExportDialog *m_imageDialog = nullptr;
 
@@ -55,4 +75,6 @@ private:
 	CGVGraphLayoutUIController *m_gvController = nullptr;
 
 	QString m_lastExportPath;
+
+	bool m_loadCanceled = false;
 };
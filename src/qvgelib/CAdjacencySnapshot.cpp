@@ -0,0 +1,134 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#include "CAdjacencySnapshot.h"
+#include "CEditorScene.h"
+#include "CEditorSceneDefines.h"
+#include "CNode.h"
+#include "CEdge.h"
+#include "CPerfTrace.h"
+
+
+// offsets from the counts of arcs per node (counting sort)
+static void buildOffsets(QVector<int>& offsets)
+{
+	int sum = 0;
+	for (int& offset : offsets)
+	{
+		int count = offset;
+		offset = sum;
+		sum += count;
+	}
+}
+
+
+CAdjacencySnapshot::CAdjacencySnapshot(const CEditorScene& scene):
+	m_revision(scene.getTopologyRevision())
+{
+	PERF_SCOPE("scene.adjacency");
+
+	// a single pass over the scene items
+	const QList<QGraphicsItem*> items = scene.items();
+
+	QVector<CEdge*> edges;
+
+	for (QGraphicsItem* item : items)
+	{
+		if (CNode* node = dynamic_cast<CNode*>(item))
+		{
+			m_nodeIndex.insert(node, m_nodes.size());
+			m_nodes << node;
+		}
+		else if (CEdge* edge = dynamic_cast<CEdge*>(item))
+			edges << edge;
+	}
+
+	// edges between the known nodes only (i.e. not the one being drawn)
+	m_edges.reserve(edges.size());
+	m_edgeSource.reserve(edges.size());
+	m_edgeTarget.reserve(edges.size());
+	m_edgeDirection.reserve(edges.size());
+
+	for (CEdge* edge : edges)
+	{
+		int source = m_nodeIndex.value(edge->firstNode(), -1);
+		int target = m_nodeIndex.value(edge->lastNode(), -1);
+		if (source < 0 || target < 0)
+			continue;
+
+		QString direction = edge->getAttribute(attr_edge_direction).toString();
+
+		m_edgeIndex.insert(edge, m_edges.size());
+		m_edges << edge;
+		m_edgeSource << source;
+		m_edgeTarget << target;
+		m_edgeDirection << quint8(direction == "mutual" ? Mutual : direction == "undirected" ? Undirected : Directed);
+	}
+
+	const int nodeCount = m_nodes.size();
+	const int edgeCount = m_edges.size();
+
+	// count the arcs per node
+	m_outOffsets.fill(0, nodeCount + 1);
+	m_inOffsets.fill(0, nodeCount + 1);
+	m_allOffsets.fill(0, nodeCount + 1);
+
+	for (int e = 0; e < edgeCount; ++e)
+	{
+		int s = m_edgeSource[e], t = m_edgeTarget[e];
+		bool loop = (s == t);
+
+		m_outOffsets[s]++;
+		m_inOffsets[t]++;
+		m_allOffsets[s]++;
+
+		if (!loop)
+		{
+			m_allOffsets[t]++;
+
+			if (m_edgeDirection[e] != Directed)
+			{
+				m_outOffsets[t]++;
+				m_inOffsets[s]++;
+			}
+		}
+	}
+
+	buildOffsets(m_outOffsets);
+	buildOffsets(m_inOffsets);
+	buildOffsets(m_allOffsets);
+
+	// fill: the offsets serve as cursors, so every edge keeps its order within a node
+	m_outArcs.resize(m_outOffsets[nodeCount]);
+	m_inArcs.resize(m_inOffsets[nodeCount]);
+	m_allArcs.resize(m_allOffsets[nodeCount]);
+
+	QVector<int> outPos = m_outOffsets, inPos = m_inOffsets, allPos = m_allOffsets;
+
+	for (int e = 0; e < edgeCount; ++e)
+	{
+		int s = m_edgeSource[e], t = m_edgeTarget[e];
+		bool loop = (s == t);
+
+		m_outArcs[outPos[s]++] = { t, e };
+		m_inArcs[inPos[t]++] = { s, e };
+		m_allArcs[allPos[s]++] = { t, e };
+
+		if (!loop)
+		{
+			m_allArcs[allPos[t]++] = { s, e };
+
+			if (m_edgeDirection[e] != Directed)
+			{
+				m_outArcs[outPos[t]++] = { s, e };
+				m_inArcs[inPos[s]++] = { t, e };
+			}
+		}
+	}
+}
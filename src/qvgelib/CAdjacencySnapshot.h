@@ -0,0 +1,106 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#pragma once
+
+#include <QVector>
+#include <QHash>
+
+class CEditorScene;
+class CNode;
+class CEdge;
+
+
+// Read-only adjacency of the scene graph in compressed sparse row form: nodes & edges are
+// numbered 0..n-1, the arcs of every node are stored contiguously in a single array.
+// Taken at some topology revision of the scene (see CNodeEditorScene::getAdjacency()): the item
+// pointers are valid only while the revision is the same.
+
+class CAdjacencySnapshot
+{
+public:
+	enum Direction
+	{
+		Directed,		// first -> last node
+		Mutual,			// both ways
+		Undirected
+	};
+
+	// step to a neighbor node
+	struct Arc
+	{
+		int node;
+		int edge;
+	};
+
+	// arcs of a node: for (const auto& arc : snapshot.outArcs(i)) ...
+	class Arcs
+	{
+	public:
+		Arcs(const Arc* begin, const Arc* end): m_begin(begin), m_end(end) {}
+
+		const Arc* begin() const	{ return m_begin; }
+		const Arc* end() const		{ return m_end; }
+		int size() const			{ return int(m_end - m_begin); }
+		bool isEmpty() const		{ return m_begin == m_end; }
+
+	private:
+		const Arc *m_begin, *m_end;
+	};
+
+	explicit CAdjacencySnapshot(const CEditorScene& scene);
+
+	quint64 revision() const	{ return m_revision; }
+
+	// items
+	int nodeCount() const		{ return m_nodes.size(); }
+	int edgeCount() const		{ return m_edges.size(); }
+
+	CNode* node(int index) const	{ return m_nodes.at(index); }
+	CEdge* edge(int index) const	{ return m_edges.at(index); }
+
+	// -1 if not in the snapshot
+	int indexOf(const CNode* node) const	{ return m_nodeIndex.value(node, -1); }
+	int indexOf(const CEdge* edge) const	{ return m_edgeIndex.value(edge, -1); }
+
+	int edgeSource(int edge) const			{ return m_edgeSource.at(edge); }
+	int edgeTarget(int edge) const			{ return m_edgeTarget.at(edge); }
+	Direction edgeDirection(int edge) const	{ return Direction(m_edgeDirection.at(edge)); }
+
+	// along the edge directions (mutual & undirected edges go both ways)
+	Arcs outArcs(int node) const	{ return arcs(m_outOffsets, m_outArcs, node); }
+	Arcs inArcs(int node) const		{ return arcs(m_inOffsets, m_inArcs, node); }
+
+	// every edge at both of its ends, regardless of the direction (loops once)
+	Arcs allArcs(int node) const	{ return arcs(m_allOffsets, m_allArcs, node); }
+
+	int outDegree(int node) const	{ return outArcs(node).size(); }
+	int inDegree(int node) const	{ return inArcs(node).size(); }
+	int degree(int node) const		{ return allArcs(node).size(); }
+
+private:
+	static Arcs arcs(const QVector<int>& offsets, const QVector<Arc>& list, int node)
+	{
+		const Arc* data = list.constData();
+		return Arcs(data + offsets.at(node), data + offsets.at(node + 1));
+	}
+
+	quint64 m_revision = 0;
+
+	QVector<CNode*> m_nodes;
+	QVector<CEdge*> m_edges;
+	QHash<const CNode*, int> m_nodeIndex;
+	QHash<const CEdge*, int> m_edgeIndex;
+
+	QVector<int> m_edgeSource, m_edgeTarget;
+	QVector<quint8> m_edgeDirection;
+
+	QVector<int> m_outOffsets, m_inOffsets, m_allOffsets;
+	QVector<Arc> m_outArcs, m_inArcs, m_allArcs;
+};
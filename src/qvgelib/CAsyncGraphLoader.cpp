@@ -0,0 +1,183 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#include "CAsyncGraphLoader.h"
+#include "CNodeEditorScene.h"
+#include "CPerfTrace.h"
+
+#include <qvgeio/CGraphBase.h>
+
+#include <QtConcurrent/QtConcurrentRun>
+
+
+// GUI time per slice (ms) & items created between the time checks
+static const int sliceTime = 20;
+static const int sliceItems = 200;
+
+// the scene rect follows the content with this period (ms)
+static const int sceneRectTime = 500;
+
+
+CAsyncGraphLoader::CAsyncGraphLoader(CNodeEditorScene& scene, QObject* parent):
+	QObject(parent),
+	m_scene(&scene)
+{
+	connect(&m_watcher, &QFutureWatcher<ParseResult>::finished, this, &CAsyncGraphLoader::onParsed);
+
+	m_sliceTimer.setSingleShot(true);
+	m_sliceTimer.setInterval(0);
+	connect(&m_sliceTimer, &QTimer::timeout, this, &CAsyncGraphLoader::onSlice);
+}
+
+
+CAsyncGraphLoader::~CAsyncGraphLoader()
+{
+	// a running parser finishes on its own, the result is dropped
+	if (m_state == Parsing)
+		m_parseCanceled->storeRelease(1);
+
+	if (m_state == Building)
+		m_scene->abortFromGraph();
+}
+
+
+void CAsyncGraphLoader::start(Parser parser)
+{
+	if (isRunning())
+		return;
+
+	m_state = Parsing;
+	m_canceled = false;
+	m_graph.clear();
+
+	QSharedPointer<QAtomicInt> canceled(new QAtomicInt(0));
+	m_parseCanceled = canceled;
+
+	Q_EMIT progress(0, 0);
+
+	m_watcher.setFuture(QtConcurrent::run([parser, canceled]()
+	{
+		PERF_SCOPE("io.async.parse");
+
+		ParseResult result;
+		result.graph.reset(new Graph);
+
+		// must not reach the GUI thread
+		try
+		{
+			result.ok = parser(*result.graph, &result.lastError);
+		}
+		catch (...)
+		{
+			result.ok = false;
+		}
+
+		// nobody waits for it: freed right here
+		if (canceled->loadAcquire())
+		{
+			result.ok = false;
+			result.graph.clear();
+		}
+
+		return result;
+	}));
+}
+
+
+void CAsyncGraphLoader::cancel()
+{
+	if (!isRunning())
+		return;
+
+	if (m_state == Parsing)
+		m_parseCanceled->storeRelease(1);
+
+	if (m_state == Building)
+	{
+		m_sliceTimer.stop();
+		m_scene->abortFromGraph();
+	}
+
+	m_canceled = true;
+
+	finish(false, QString());
+}
+
+
+void CAsyncGraphLoader::finish(bool ok, const QString& lastError)
+{
+	m_state = Idle;
+	m_graph.clear();
+
+	Q_EMIT finished(ok, lastError);
+}
+
+
+void CAsyncGraphLoader::onParsed()
+{
+	// canceled while parsing
+	if (m_state != Parsing)
+		return;
+
+	ParseResult result = m_watcher.result();
+	if (!result.ok)
+	{
+		finish(false, result.lastError);
+		return;
+	}
+
+	m_graph = result.graph;
+	m_total = m_graph->nodes.size() + m_graph->edges.size();
+	m_state = Building;
+
+	m_scene->beginFromGraph(*m_graph);
+	m_sceneRectTimer.start();
+
+	onSlice();
+}
+
+
+void CAsyncGraphLoader::onSlice()
+{
+	if (m_state != Building)
+		return;
+
+	QElapsedTimer timer;
+	timer.start();
+
+	int left = 0;
+	do
+	{
+		left = m_scene->continueFromGraph(sliceItems);
+	}
+	while (left > 0 && timer.elapsed() < sliceTime);
+
+	if (left == 0)
+	{
+		m_scene->finishFromGraph();
+
+		Q_EMIT progress(m_total, m_total);
+
+		finish(true, QString());
+		return;
+	}
+
+	// let the view show the items created so far
+	if (m_sceneRectTimer.elapsed() > sceneRectTime)
+	{
+		m_scene->setSceneRect(m_scene->sceneRect().united(m_scene->itemsBoundingRect()));
+		m_sceneRectTimer.start();
+	}
+
+	// progress dialogs may process the events (and cancel) here
+	Q_EMIT progress(m_total - left, m_total);
+
+	if (m_state == Building)
+		m_sliceTimer.start();
+}
@@ -0,0 +1,83 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QSharedPointer>
+#include <QAtomicInt>
+
+#include <functional>
+
+struct Graph;
+class CNodeEditorScene;
+
+
+// Loading of large documents without blocking the GUI: the file is parsed into the Graph model
+// by a worker thread, then the scene items are created by the GUI thread in short time slices,
+// so the view shows the content while it grows and the loading can be canceled at any time.
+
+class CAsyncGraphLoader : public QObject
+{
+	Q_OBJECT
+
+public:
+	// called by the worker thread: must not touch the scene
+	typedef std::function<bool(Graph& graph, QString* lastError)> Parser;
+
+	explicit CAsyncGraphLoader(CNodeEditorScene& scene, QObject* parent = nullptr);
+	virtual ~CAsyncGraphLoader();
+
+	void start(Parser parser);
+	bool isRunning() const { return m_state != Idle; }
+	bool isCanceled() const { return m_canceled; }
+
+public Q_SLOTS:
+	// the scene is left empty; a running parser cannot be interrupted, its result is dropped
+	void cancel();
+
+Q_SIGNALS:
+	// total is 0 while parsing
+	void progress(int done, int total);
+	// ok is false when canceled, with empty error
+	void finished(bool ok, const QString& lastError);
+
+private Q_SLOTS:
+	void onParsed();
+	void onSlice();
+
+private:
+	struct ParseResult
+	{
+		QSharedPointer<Graph> graph;
+		bool ok = false;
+		QString lastError;
+	};
+
+	void finish(bool ok, const QString& lastError);
+
+	CNodeEditorScene *m_scene;
+
+	enum State { Idle, Parsing, Building };
+	State m_state = Idle;
+	bool m_canceled = false;
+
+	QFutureWatcher<ParseResult> m_watcher;
+	// seen by the running parser: its result is dropped by the worker
+	QSharedPointer<QAtomicInt> m_parseCanceled;
+	QSharedPointer<Graph> m_graph;
+	int m_total = 0;
+
+	QTimer m_sliceTimer;
+	QElapsedTimer m_sceneRectTimer;
+};
@@ -0,0 +1,301 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#include "CBlockDiff.h"
+
+#include <QtCore/QHash>
+
+#include <algorithm>
+#include <cstring>
+
+
+// chunking parameters: ~512 bytes average chunk (9 bits of the hash)
+static const int minChunkSize = 64;
+static const int maxChunkSize = 8192;
+static const quint32 boundaryMask = 0xff800000;
+
+// compare step for the memory scans
+static const int scanBlockSize = 64;
+
+
+// gear table for the rolling hash: fixed pseudo-random values
+
+struct GearTable
+{
+	quint32 values[256];
+
+	GearTable()
+	{
+		quint64 seed = 0x9e3779b97f4a7c15ull;
+		for (int i = 0; i < 256; ++i)
+		{
+			seed += 0x9e3779b97f4a7c15ull;
+			quint64 z = seed;
+			z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+			z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+			values[i] = quint32(z ^ (z >> 31));
+		}
+	}
+};
+
+static const quint32* gearTable()
+{
+	// thread-safe initialization
+	static const GearTable table;
+	return table.values;
+}
+
+
+// chunks
+
+CBlockDiff::Chunks CBlockDiff::split(const QByteArray& data)
+{
+	Chunks chunks;
+
+	const quint32* gear = gearTable();
+	const uchar* p = (const uchar*)data.constData();
+	int size = data.size();
+
+	chunks.reserve(size / 512 + 1);
+
+	int start = 0;
+	while (start < size)
+	{
+		int end = qMin(start + maxChunkSize, size);
+		int pos = qMin(start + minChunkSize, end);
+
+		quint32 h = 0;
+		while (pos < end)
+		{
+			h = (h << 1) + gear[p[pos++]];
+			if (!(h & boundaryMask))
+				break;
+		}
+
+		Chunk chunk;
+		chunk.offset = start;
+		chunk.size = pos - start;
+		chunk.hash = qHashBits(p + start, chunk.size);
+		chunks.append(chunk);
+
+		start = pos;
+	}
+
+	return chunks;
+}
+
+
+// memory scans
+
+int CBlockDiff::commonPrefix(const char* p1, const char* p2, int size)
+{
+	int i = 0;
+
+	while (i + scanBlockSize <= size && memcmp(p1 + i, p2 + i, scanBlockSize) == 0)
+		i += scanBlockSize;
+
+	while (i < size && p1[i] == p2[i])
+		++i;
+
+	return i;
+}
+
+
+int CBlockDiff::commonSuffix(const char* end1, const char* end2, int size)
+{
+	int i = 0;
+
+	while (i + scanBlockSize <= size && memcmp(end1 - i - scanBlockSize, end2 - i - scanBlockSize, scanBlockSize) == 0)
+		i += scanBlockSize;
+
+	while (i < size && end1[-i - 1] == end2[-i - 1])
+		++i;
+
+	return i;
+}
+
+
+// diff
+
+static bool isSameChunk(const char* p1, const CBlockDiff::Chunk& c1, const char* p2, const CBlockDiff::Chunk& c2)
+{
+	return c1.hash == c2.hash && c1.size == c2.size && memcmp(p1 + c1.offset, p2 + c2.offset, c1.size) == 0;
+}
+
+
+typedef QHash<uint, QVector<int>> ChunkIndex;
+
+static ChunkIndex indexChunks(const CBlockDiff::Chunks& chunks)
+{
+	ChunkIndex index;
+	index.reserve(chunks.size());
+
+	for (int i = 0; i < chunks.size(); ++i)
+		index[chunks[i].hash].append(i);
+
+	return index;
+}
+
+
+// first chunk of the index at or after `from` which is the same as the given one, -1 if none
+static int findChunk(const ChunkIndex& index, int from,
+	const char* p, const CBlockDiff::Chunks& chunks,
+	const char* pc, const CBlockDiff::Chunk& chunk)
+{
+	auto it = index.constFind(chunk.hash);
+	if (it == index.constEnd())
+		return -1;
+
+	const QVector<int>& list = it.value();
+	for (auto pos = std::lower_bound(list.constBegin(), list.constEnd(), from); pos != list.constEnd(); ++pos)
+	{
+		if (isSameChunk(p, chunks[*pos], pc, chunk))
+			return *pos;
+	}
+
+	return -1;
+}
+
+
+void CBlockDiff::diff(const QByteArray& from, const Chunks& fromChunks,
+	const QByteArray& to, const Chunks& toChunks,
+	Patches* forward, Patches* backward)
+{
+	const char* p1 = from.constData();
+	const char* p2 = to.constData();
+	int count1 = fromChunks.size();
+	int count2 = toChunks.size();
+
+	// same chunks at the head & tail: no hashing needed there
+	int head = 0;
+	while (head < count1 && head < count2 && isSameChunk(p1, fromChunks[head], p2, toChunks[head]))
+		++head;
+
+	int tail1 = count1, tail2 = count2;
+	while (tail1 > head && tail2 > head && isSameChunk(p1, fromChunks[tail1 - 1], p2, toChunks[tail2 - 1]))
+		--tail1, --tail2;
+
+	// changed regions in chunk indices: [start1, end1) replaced by [start2, end2)
+	struct Region { int start1, end1, start2, end2; };
+	QVector<Region> regions;
+
+	if (head < tail1 || head < tail2)
+	{
+		ChunkIndex index1 = indexChunks(fromChunks);
+		ChunkIndex index2 = indexChunks(toChunks);
+
+		int i1 = head, i2 = head;
+		int start1 = -1, start2 = -1;
+
+		while (i1 < tail1 && i2 < tail2)
+		{
+			if (isSameChunk(p1, fromChunks[i1], p2, toChunks[i2]))
+			{
+				if (start1 >= 0)
+				{
+					regions.append({ start1, i1, start2, i2 });
+					start1 = start2 = -1;
+				}
+
+				++i1, ++i2;
+				continue;
+			}
+
+			if (start1 < 0)
+			{
+				start1 = i1;
+				start2 = i2;
+			}
+
+			// resync by the nearest matching chunk on either side
+			int k1 = findChunk(index1, i1, p1, fromChunks, p2, toChunks[i2]);
+			int k2 = findChunk(index2, i2, p2, toChunks, p1, fromChunks[i1]);
+			if (k1 >= tail1) k1 = -1;
+			if (k2 >= tail2) k2 = -1;
+
+			if (k1 < 0 && k2 < 0)
+			{
+				// both chunks changed
+				++i1, ++i2;
+			}
+			else if (k2 < 0 || (k1 >= 0 && k1 - i1 <= k2 - i2))
+			{
+				// chunks removed
+				i1 = k1;
+			}
+			else
+			{
+				// chunks inserted
+				i2 = k2;
+			}
+		}
+
+		if (start1 < 0)
+		{
+			start1 = i1;
+			start2 = i2;
+		}
+
+		regions.append({ start1, tail1, start2, tail2 });
+	}
+
+	// to byte ranges, trimmed to the changed bytes
+	for (const Region& r : regions)
+	{
+		int offset1 = r.start1 < count1 ? fromChunks[r.start1].offset : from.size();
+		int offset2 = r.start2 < count2 ? toChunks[r.start2].offset : to.size();
+		int endOffset1 = r.end1 < count1 ? fromChunks[r.end1].offset : from.size();
+		int endOffset2 = r.end2 < count2 ? toChunks[r.end2].offset : to.size();
+
+		int size1 = endOffset1 - offset1;
+		int size2 = endOffset2 - offset2;
+
+		int prefix = commonPrefix(p1 + offset1, p2 + offset2, qMin(size1, size2));
+		offset1 += prefix, size1 -= prefix;
+		offset2 += prefix, size2 -= prefix;
+
+		int suffix = commonSuffix(p1 + offset1 + size1, p2 + offset2 + size2, qMin(size1, size2));
+		size1 -= suffix;
+		size2 -= suffix;
+
+		if (size1 == 0 && size2 == 0)
+			continue;
+
+		if (forward)
+		{
+			CStateDelta delta;
+			delta.index = offset1;
+			delta.sizeToReplace = size1;
+			delta.data = to.mid(offset2, size2);
+			forward->append(delta);
+		}
+
+		if (backward)
+		{
+			CStateDelta delta;
+			delta.index = offset2;
+			delta.sizeToReplace = size2;
+			delta.data = from.mid(offset1, size1);
+			backward->append(delta);
+		}
+	}
+}
+
+
+bool CBlockDiff::apply(QByteArray& data, const Patches& patches)
+{
+	// patches are ordered by position: apply from the end to keep the positions valid
+	for (int i = patches.size() - 1; i >= 0; --i)
+	{
+		if (!CStateJournal::apply(data, patches.at(i)))
+			return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,50 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QVector>
+#include <QtCore/QList>
+
+#include "CStateJournal.h"
+
+
+// Diff of serialized states by content-defined chunks: both states are split at the positions
+// chosen by a rolling hash of the content, so an edit shifts the chunk boundaries locally only.
+// Equal chunks are matched, and only the differing regions (trimmed to the changed bytes) are stored.
+
+class CBlockDiff
+{
+public:
+	struct Chunk
+	{
+		int offset;
+		int size;
+		uint hash;
+	};
+
+	typedef QVector<Chunk> Chunks;
+	typedef QList<CStateDelta> Patches;
+
+	// splits the data into the chunks
+	static Chunks split(const QByteArray& data);
+
+	// computes patches turning `from` into `to` (forward) and back (backward); nullptr to skip
+	static void diff(const QByteArray& from, const Chunks& fromChunks,
+		const QByteArray& to, const Chunks& toChunks,
+		Patches* forward, Patches* backward);
+
+	// applies patches (as produced by diff) to the data
+	static bool apply(QByteArray& data, const Patches& patches);
+
+	// sizes of the common head & tail of two memory blocks
+	static int commonPrefix(const char* p1, const char* p2, int size);
+	static int commonSuffix(const char* end1, const char* end2, int size);
+};
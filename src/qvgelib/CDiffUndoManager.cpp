@@ -10,9 +10,19 @@ It can be used freely, maintaining the information above.
 
 #include "CDiffUndoManager.h"
 #include "CEditorScene.h"
+#include "CPerfTrace.h"
 
 #include <QDataStream>
 
+#include <algorithm>
+
+
+static CPerfCounter undoStateCounter("undo.stateBytes");
+static CPerfCounter undoMemoryCounter("undo.memoryBytes");
+
+// the spill file is compacted when its dead space is over the live data & this size
+static const qint64 minSpillCompaction = 1 << 20;
+
 
 CDiffUndoManager::CDiffUndoManager(CEditorScene & scene)
     : m_scene(&scene)
@@ -26,13 +36,23 @@ void CDiffUndoManager::reset()
 	m_redoStackTemp.clear();
 	m_undoStackTemp.clear();
 	m_lastState.clear();
+	m_lastChunks.clear();
+
+	m_commandsSize = 0;
+	m_spillSize = 0;
+
+	// nothing refers to the spilled data anymore
+	if (m_spillFile.isOpen())
+		m_spillFile.resize(0);
 }
 
 void CDiffUndoManager::addState()
 {
+	PERF_SCOPE("undo.addState");
+
 	// drop temp stacks
-	m_redoStack.clear();
-	m_undoStackTemp.clear();
+	clearStack(m_redoStack);
+	clearStack(m_undoStackTemp);
 
 	// serialize & compress
 	QByteArray snap;
@@ -43,33 +63,39 @@ void CDiffUndoManager::addState()
 	if (m_lastState.isEmpty() && m_undoStack.isEmpty() && m_redoStack.isEmpty())
 	{
 		m_lastState = snap;
+		m_lastChunks.clear();
 		return;
 	}
 
-	// push states into stacks
-	int leftDiffIndex = 0;
-	int len = qMin(snap.size(), m_lastState.size());
-	while (leftDiffIndex < len && snap[leftDiffIndex] == m_lastState[leftDiffIndex])
-		++leftDiffIndex;
+	// push changed blocks into stacks
+	if (m_lastChunks.isEmpty())
+		m_lastChunks = CBlockDiff::split(m_lastState);
 
-	int rightDiffIndex1 = m_lastState.size() - 1;
-	int rightDiffIndex2 = snap.size() - 1;
-	while (rightDiffIndex1 >= 0 && rightDiffIndex2 >= 0 
-		&& rightDiffIndex1 > leftDiffIndex && rightDiffIndex2 > leftDiffIndex 
-		&& snap[rightDiffIndex2] == m_lastState[rightDiffIndex1])
-			--rightDiffIndex1, --rightDiffIndex2;
+	CBlockDiff::Chunks snapChunks = CBlockDiff::split(snap);
 
-	int len1 = rightDiffIndex1 - leftDiffIndex + 1;
-	int len2 = rightDiffIndex2 - leftDiffIndex + 1;
+	CBlockDiff::Patches redoPatches, undoPatches;
+	CBlockDiff::diff(m_lastState, m_lastChunks, snap, snapChunks, &redoPatches, &undoPatches);
 
-	Command cUndo = { leftDiffIndex, len2, qCompress(m_lastState.mid(leftDiffIndex, len1)) };
-	Command cRedo = { leftDiffIndex, len1, qCompress(snap.mid(leftDiffIndex, len2)) };
+	Command cUndo;
+	cUndo.data = packPatches(undoPatches);
+	Command cRedo;
+	cRedo.data = packPatches(redoPatches);
 
 	m_undoStack << cUndo;
 	m_redoStackTemp << cRedo;
 
+	m_commandsSize += cUndo.data.size() + cRedo.data.size();
+
 	// write last state
 	m_lastState = snap;
+	m_lastChunks = snapChunks;
+
+	checkMemoryBudget();
+
+	compactSpillFile();
+
+	PERF_SET(undoStateCounter, m_lastState.size());
+	PERF_SET(undoMemoryCounter, memoryUsage());
 }
 
 void CDiffUndoManager::revertState()
@@ -80,10 +106,12 @@ void CDiffUndoManager::revertState()
 
 void CDiffUndoManager::undo()
 {
+	PERF_SCOPE("undo.undo");
+
 	if (availableUndoCount())
 	{
 		Command cUndo = m_undoStack.takeLast();
-		m_lastState.replace(cUndo.index, cUndo.sizeToReplace, qUncompress(cUndo.data));
+		applyCommand(cUndo);
 		QDataStream ds(&m_lastState, QIODevice::ReadOnly);
 		m_scene->restoreFrom(ds, true);
 
@@ -94,10 +122,12 @@ void CDiffUndoManager::undo()
 
 void CDiffUndoManager::redo()
 {
+	PERF_SCOPE("undo.redo");
+
 	if (availableRedoCount())
 	{
 		Command cRedo = m_redoStack.takeLast();
-		m_lastState.replace(cRedo.index, cRedo.sizeToReplace, qUncompress(cRedo.data));
+		applyCommand(cRedo);
 		QDataStream ds(&m_lastState, QIODevice::ReadOnly);
 		m_scene->restoreFrom(ds, true);
 
@@ -115,3 +145,204 @@ int CDiffUndoManager::availableRedoCount() const
 {
 	return m_redoStack.size();
 }
+
+QByteArray CDiffUndoManager::currentState() const
+{
+	return m_lastState;
+}
+
+void CDiffUndoManager::setMemoryBudget(qint64 bytes)
+{
+	m_memoryBudget = bytes;
+
+	checkMemoryBudget();
+}
+
+qint64 CDiffUndoManager::memoryUsage() const
+{
+	return m_commandsSize + m_lastState.size() + m_lastChunks.size() * qint64(sizeof(CBlockDiff::Chunk));
+}
+
+
+// privates
+
+QByteArray CDiffUndoManager::packPatches(const CBlockDiff::Patches& patches)
+{
+	QByteArray data;
+	QDataStream ds(&data, QIODevice::WriteOnly);
+
+	ds << qint32(patches.size());
+	for (const CStateDelta& patch : patches)
+		ds << qint32(patch.index) << qint32(patch.sizeToReplace) << patch.data;
+
+	return qCompress(data);
+}
+
+bool CDiffUndoManager::unpackPatches(const QByteArray& data, CBlockDiff::Patches& patches)
+{
+	QByteArray unpacked = qUncompress(data);
+	QDataStream ds(unpacked);
+
+	qint32 count = 0;
+	ds >> count;
+
+	for (int i = 0; i < count && ds.status() == QDataStream::Ok; ++i)
+	{
+		qint32 index = 0, sizeToReplace = 0;
+		CStateDelta patch;
+		ds >> index >> sizeToReplace >> patch.data;
+		patch.index = index;
+		patch.sizeToReplace = sizeToReplace;
+		patches.append(patch);
+	}
+
+	return ds.status() == QDataStream::Ok;
+}
+
+void CDiffUndoManager::applyCommand(const Command& cmd)
+{
+	QByteArray data = cmd.data;
+
+	// read spilled data back (stays on disk)
+	if (cmd.fileOffset >= 0)
+	{
+		m_spillFile.seek(cmd.fileOffset);
+		data = m_spillFile.read(cmd.fileSize);
+		m_spillFile.seek(m_spillFile.size());
+	}
+
+	CBlockDiff::Patches patches;
+	if (unpackPatches(data, patches))
+		CBlockDiff::apply(m_lastState, patches);
+
+	// chunks to be recomputed on the next change
+	m_lastChunks.clear();
+}
+
+void CDiffUndoManager::checkMemoryBudget()
+{
+	if (m_memoryBudget <= 0)
+		return;
+
+	// the oldest undo steps go first; undo & redo commands of a step are kept in pairs
+	for (int i = 0; i < m_undoStack.size() && memoryUsage() > m_memoryBudget; ++i)
+	{
+		Command &cUndo = m_undoStack[i];
+		Command &cRedo = m_redoStackTemp[i];
+
+		if (cUndo.fileOffset >= 0 && cRedo.fileOffset >= 0)
+			continue;
+
+		if (spillCommand(cUndo) && spillCommand(cRedo))
+			continue;
+
+		// no disk space: coalesce the oldest steps into the initial state, i.e. drop them
+		while (!m_undoStack.isEmpty() && memoryUsage() > m_memoryBudget)
+		{
+			releaseCommand(m_undoStack.takeFirst());
+			releaseCommand(m_redoStackTemp.takeFirst());
+		}
+
+		return;
+	}
+}
+
+bool CDiffUndoManager::spillCommand(Command& cmd)
+{
+	if (cmd.fileOffset >= 0)
+		return true;
+
+	if (!m_spillFile.isOpen() && !m_spillFile.open())
+		return false;
+
+	qint64 offset = m_spillFile.size();
+	m_spillFile.seek(offset);
+	if (m_spillFile.write(cmd.data) != cmd.data.size())
+		return false;
+
+	m_commandsSize -= cmd.data.size();
+	m_spillSize += cmd.data.size();
+
+	cmd.fileOffset = offset;
+	cmd.fileSize = cmd.data.size();
+	cmd.data.clear();
+
+	return true;
+}
+
+void CDiffUndoManager::releaseCommand(const Command& cmd)
+{
+	// the spilled data is dead space from now
+	if (cmd.fileOffset >= 0)
+		m_spillSize -= cmd.fileSize;
+	else
+		m_commandsSize -= cmd.data.size();
+}
+
+void CDiffUndoManager::clearStack(QList<Command>& stack)
+{
+	for (const Command& cmd : stack)
+		releaseCommand(cmd);
+
+	stack.clear();
+}
+
+void CDiffUndoManager::compactSpillFile()
+{
+	if (!m_spillFile.isOpen())
+		return;
+
+	qint64 deadSize = m_spillFile.size() - m_spillSize;
+	if (deadSize <= m_spillSize || deadSize < minSpillCompaction)
+		return;
+
+	PERF_SCOPE("undo.compactSpill");
+
+	// the live commands are moved towards the start in place, in the order of the file
+	QList<Command*> spilled;
+	for (QList<Command>* stack : { &m_undoStack, &m_redoStack, &m_undoStackTemp, &m_redoStackTemp })
+	{
+		for (Command& cmd : *stack)
+		{
+			if (cmd.fileOffset >= 0)
+				spilled << &cmd;
+		}
+	}
+
+	std::sort(spilled.begin(), spilled.end(), [](const Command* c1, const Command* c2) { return c1->fileOffset < c2->fileOffset; });
+
+	qint64 offset = 0;
+	for (Command* cmd : spilled)
+	{
+		if (cmd->fileOffset != offset)
+		{
+			m_spillFile.seek(cmd->fileOffset);
+			QByteArray data = m_spillFile.read(cmd->fileSize);
+
+			m_spillFile.seek(offset);
+			if (data.size() != cmd->fileSize || m_spillFile.write(data) != data.size())
+			{
+				// its old place may be overwritten: kept in RAM, the rest stays where it is
+				if (data.size() == cmd->fileSize)
+				{
+					m_spillSize -= cmd->fileSize;
+					m_commandsSize += data.size();
+
+					cmd->data = data;
+					cmd->fileOffset = -1;
+					cmd->fileSize = 0;
+				}
+
+				m_spillFile.seek(m_spillFile.size());
+				return;
+			}
+
+			cmd->fileOffset = offset;
+		}
+
+		offset += cmd->fileSize;
+	}
+
+	m_spillFile.resize(offset);
+	m_spillFile.seek(offset);
+}
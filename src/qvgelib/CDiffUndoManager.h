@@ -10,9 +10,11 @@ It can be used freely, maintaining the information above.
 #pragma once
 
 #include "IUndoManager.h"
+#include "CBlockDiff.h"
 
 #include <QtCore/QByteArray>
 #include <QtCore/QList>
+#include <QtCore/QTemporaryFile>
 
 class CEditorScene;
 
@@ -30,17 +32,42 @@ public:
 	virtual void redo();
 	virtual int availableUndoCount() const;
 	virtual int availableRedoCount() const;
+	virtual QByteArray currentState() const;
+	virtual void setMemoryBudget(qint64 bytes);
+	virtual qint64 memoryUsage() const;
 
 private:
+	// compressed patches (see CBlockDiff)
 	struct Command
 	{
-		int index;
-		int sizeToReplace;
 		QByteArray data;
+
+		// spilled to disk: data is empty then
+		qint64 fileOffset = -1;
+		int fileSize = 0;
 	};
 
+	static QByteArray packPatches(const CBlockDiff::Patches& patches);
+	static bool unpackPatches(const QByteArray& data, CBlockDiff::Patches& patches);
+
+	void applyCommand(const Command& cmd);
+	void checkMemoryBudget();
+	bool spillCommand(Command& cmd);
+	void releaseCommand(const Command& cmd);
+	void clearStack(QList<Command>& stack);
+	void compactSpillFile();
+
 	CEditorScene *m_scene;
 	QList<Command> m_redoStack, m_undoStack;
 	QList<Command> m_redoStackTemp, m_undoStackTemp;
 	QByteArray m_lastState;
+	CBlockDiff::Chunks m_lastChunks;	// of m_lastState, empty if not computed yet
+
+	// compressed commands kept in RAM
+	qint64 m_commandsSize = 0;
+	qint64 m_memoryBudget = 0;
+
+	// older commands over the budget & the size of them (the rest of the file is dead)
+	QTemporaryFile m_spillFile;
+	qint64 m_spillSize = 0;
 };
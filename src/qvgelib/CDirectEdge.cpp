@@ -143,6 +143,8 @@ void CDirectEdge::onParentGeometryChanged()
 	if (!m_firstNode || !m_lastNode)
 		return;
 
+	countGeometryUpdate();
+
 	prepareGeometryChange();
 
 	// update line position
@@ -10,6 +10,7 @@ It can be used freely, maintaining the information above.
 #include "CEdge.h"
 #include "CNode.h"
 #include "CEditorSceneDefines.h"
+#include "CPerfTrace.h"
 
 #include <QPen>
 #include <QPainter>
@@ -21,6 +22,10 @@ It can be used freely, maintaining the information above.
 #include <math.h>
 
 
+static CPerfCounter paintedEdgesCounter("paint.edges");
+static CPerfCounter updatedEdgesCounter("edges.updated");
+
+
 CEdge::CEdge(QGraphicsItem *parent): Shape(parent)
 {
     m_firstNode = m_lastNode = NULL;
@@ -77,6 +82,9 @@ bool CEdge::setAttribute(const QByteArray& attrId, const QVariant& v)
 	if (attrId == attr_edge_direction)
 	{
 		updateArrowFlags(v.toString());
+
+		if (auto scene = getScene())
+			scene->invalidateTopology();
 	}
 
 	bool res = Super::setAttribute(attrId, v);
@@ -93,6 +101,9 @@ bool CEdge::removeAttribute(const QByteArray& attrId)
 	if (attrId == attr_edge_direction)
 	{
 		updateArrowFlags(getAttribute(attr_edge_direction).toString());
+
+		if (auto scene = getScene())
+			scene->invalidateTopology();
 	}
 
 	if (res) update();
@@ -136,8 +147,17 @@ QRectF CEdge::boundingRect() const
 }
 
 
+void CEdge::countGeometryUpdate() const
+{
+	PERF_COUNT(updatedEdgesCounter, 1);
+}
+
+
 void CEdge::setupPainter(QPainter *painter, const QStyleOptionGraphicsItem* /*option*/, QWidget* /*widget*/)
 {
+	// called once per edge painting
+	PERF_COUNT(paintedEdgesCounter, 1);
+
 	double weight = getVisibleWeight();
 
 	Qt::PenStyle penStyle = (Qt::PenStyle) CUtils::textToPenStyle(getAttribute(attr_style).toString(), Qt::SolidLine);
@@ -260,7 +280,7 @@ bool CEdge::storeTo(QDataStream &out, quint64 version64) const
 {
 	Super::storeTo(out, version64);
 
-    out << quint64(m_firstNode) << quint64(m_lastNode);
+	out << (m_firstNode ? m_firstNode->getStoreId() : 0) << (m_lastNode ? m_lastNode->getStoreId() : 0);
 
 	// since version 11
 	out << m_firstPortId << m_lastPortId;
@@ -464,8 +484,24 @@ void CEdge::onItemRestored()
 
 QVariant CEdge::itemChange(QGraphicsItem::GraphicsItemChange change, const QVariant &value)
 {
+	// leaves the old scene
+	if (change == ItemSceneChange)
+	{
+		if (auto scene = getScene())
+			scene->invalidateTopology();
+	}
+
 	if (change == ItemSceneHasChanged)
 	{
+		if (auto scene = getScene())
+		{
+			scene->invalidateTopology();
+
+			// restored states are not new
+			if (!s_duringRestore)
+				scene->onItemAdded(this);
+		}
+
 		// set default ID
 		setDefaultId();
 
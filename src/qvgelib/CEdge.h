@@ -93,6 +93,9 @@ protected:
 	/*virtual*/ void drawArrow(QPainter *painter, qreal shift, const QLineF &direction) const;
 	QLineF calculateArrowLine(const QPainterPath &path, bool first, const QLineF &direction) const;
 
+	// instrumentation: to be called when the edge geometry is recomputed
+	void countGeometryUpdate() const;
+
 	// reimp
 	virtual QVariant itemChange(QGraphicsItem::GraphicsItemChange change, const QVariant &value);
 	virtual void hoverEnterEvent(QGraphicsSceneHoverEvent *event);
@@ -17,6 +17,7 @@ It can be used freely, maintaining the information above.
 #include "CDiffUndoManager.h"
 #include "ISceneItemFactory.h"
 #include "ISceneMenuController.h"
+#include "CPerfTrace.h"
 
 #include <QPainter>
 #include <QPaintEngine>
@@ -29,12 +30,15 @@ It can be used freely, maintaining the information above.
 #include <QMimeData>
 #include <QClipboard>
 #include <QDebug>
-#include <QElapsedTimer>
 #include <QPixmapCache> 
 
 #include <qopengl.h>
 
 
+static CPerfCounter itemCacheCounter("items.cacheUpdated");
+static CPerfCounter labelsCounter("labels.laidOut");
+
+
 const quint64 version64 = 12;	// build
 const char* versionId = "VersionId";
 
@@ -326,6 +330,36 @@ void CEditorScene::setInitialState()
 }
 
 
+QByteArray CEditorScene::getStateSnapshot() const
+{
+	QByteArray state;
+
+	if (m_undoManager)
+		state = m_undoManager->currentState();
+
+	if (state.isEmpty())
+	{
+		QDataStream ds(&state, QIODevice::WriteOnly);
+		storeTo(ds, true);
+	}
+
+	return state;
+}
+
+
+void CEditorScene::setUndoMemoryBudget(qint64 bytes)
+{
+	if (m_undoManager)
+		m_undoManager->setMemoryBudget(bytes);
+}
+
+
+qint64 CEditorScene::getUndoMemoryUsage() const
+{
+	return m_undoManager ? m_undoManager->memoryUsage() : 0;
+}
+
+
 int CEditorScene::availableUndoCount() const
 { 
 	return m_undoManager ? m_undoManager->availableUndoCount() : 0; 
@@ -351,8 +385,8 @@ bool CEditorScene::storeTo(QDataStream& out, bool storeOptions) const
 {
     out << versionId << version64;
 
-	// items
-	QMap<CItem*, uint> sortedMap;
+	// items, in a stable order
+	QMap<quint64, CItem*> sortedMap;
 
 	QList<QGraphicsItem*> allItems = items();
 
@@ -361,15 +395,15 @@ bool CEditorScene::storeTo(QDataStream& out, bool storeOptions) const
 		CItem* citem = dynamic_cast<CItem*>(item);
 		if (citem)
 		{
-            sortedMap[citem] = quint64(citem);
+			sortedMap[citem->getStoreId()] = citem;
 		}
 	}
 
-	for (CItem* citem : sortedMap.keys())
+	for (auto it = sortedMap.constBegin(); it != sortedMap.constEnd(); ++it)
 	{
-        out << citem->typeId() << quint64(citem);
+		out << it.value()->typeId() << it.key();
 
-		citem->storeTo(out, version64);
+		it.value()->storeTo(out, version64);
 	}
 
 	// attributes
@@ -438,7 +472,8 @@ bool CEditorScene::restoreFrom(QDataStream& out, bool readOptions)
 		{
 			if (item->restoreFrom(out, storedVersion))
 			{
-                idToItem[ptrId] = item;
+				idToItem[ptrId] = item;
+				item->setStoreId(ptrId);
 				continue;
 			}
 		}
@@ -629,12 +664,18 @@ void CEditorScene::setClassAttribute(const QByteArray& classId, const CAttribute
 
 	setClassAttributeVisible(classId, attr.id, vis);
 
+	if (attr.id == attr_edge_direction)
+		invalidateTopology();
+
 	needUpdate();
 }
 
 
 void CEditorScene::setClassAttribute(const QByteArray& classId, const QByteArray& attrId, const QVariant& defaultValue)
 {
+	if (attrId == attr_edge_direction)
+		invalidateTopology();
+
 	if (m_classAttributes[classId].contains(attrId))
 	{
 		// just update the value
@@ -673,6 +714,9 @@ bool CEditorScene::removeClassAttribute(const QByteArray& classId, const QByteAr
 	if (it == m_classAttributes.end())
 		return false;
 
+	if (attrId == attr_edge_direction)
+		invalidateTopology();
+
 	needUpdate();
 
 	return (*it).remove(attrId);
@@ -829,7 +873,7 @@ void CEditorScene::del()
 void CEditorScene::copy()
 {
 	// store selected items only
-	QMap<CItem*, quint64> sortedMap;
+	QMap<quint64, CItem*> sortedMap;
 
 	QList<QGraphicsItem*> allItems = getCopyPasteItems();
 
@@ -837,7 +881,7 @@ void CEditorScene::copy()
 	{
 		if (CItem* citem = dynamic_cast<CItem*>(item))
 		{
-			sortedMap[citem] = quint64(citem);
+			sortedMap[citem->getStoreId()] = citem;
 		}
 	}
 
@@ -853,11 +897,11 @@ void CEditorScene::copy()
 
 	out << version64;
 
-	for (CItem* citem : sortedMap.keys())
+	for (auto it = sortedMap.constBegin(); it != sortedMap.constEnd(); ++it)
 	{
-		out << citem->typeId() << quint64(citem);
+		out << it.value()->typeId() << it.key();
 
-		citem->storeTo(out, version64);
+		it.value()->storeTo(out, version64);
 	}
 
 	// create mime object
@@ -1024,6 +1068,11 @@ void CEditorScene::pasteAt(const QPointF &anchor)
 	}
 
 	blocker.unblock();
+
+	// the items were added while the signals were blocked
+	for (CItem* item : lifeList)
+		Q_EMIT itemAdded(item);
+
 	Q_EMIT selectionChanged();
 
 	// finish
@@ -1042,7 +1091,7 @@ QList<CItem*> CEditorScene::cloneSelectedItems()
 	QList<CItem*> clonedList;
 
 	// store selected items only
-	QMap<CItem*, quint64> sortedMap;
+	QMap<quint64, CItem*> sortedMap;
 
 	QList<QGraphicsItem*> allItems = getCopyPasteItems();
 
@@ -1050,7 +1099,7 @@ QList<CItem*> CEditorScene::cloneSelectedItems()
 	{
 		if (CItem* citem = dynamic_cast<CItem*>(item))
 		{
-			sortedMap[citem] = quint64(citem);
+			sortedMap[citem->getStoreId()] = citem;
 		}
 	}
 
@@ -1062,11 +1111,11 @@ QList<CItem*> CEditorScene::cloneSelectedItems()
 	{
 		QDataStream out(&buffer, QIODevice::WriteOnly);
 
-		for (CItem* citem : sortedMap.keys())
+		for (auto it = sortedMap.constBegin(); it != sortedMap.constEnd(); ++it)
 		{
-			out << citem->typeId() << quint64(citem);
+			out << it.value()->typeId() << it.key();
 
-			citem->storeTo(out, version64);
+			it.value()->storeTo(out, version64);
 		}
 	}
 
@@ -1157,6 +1206,11 @@ QList<CItem*> CEditorScene::cloneSelectedItems()
 	}
 
 	blocker.unblock();
+
+	// the items were added while the signals were blocked
+	for (CItem* item : clonedList)
+		Q_EMIT itemAdded(item);
+
 	Q_EMIT selectionChanged();
 
 	return clonedList;
@@ -1188,14 +1242,40 @@ QList<QGraphicsItem*> CEditorScene::getTransformableItems() const
 
 // callbacks
 
+void CEditorScene::onItemAdded(CItem *citem)
+{
+	Q_ASSERT(citem);
+
+	Q_EMIT itemAdded(citem);
+}
+
+
 void CEditorScene::onItemDestroyed(CItem *citem)
 {
 	Q_ASSERT(citem);
+
+	invalidateTopology();
+
+	// do not keep dangling pointers in the selection
+	m_selectionCached = false;
+
+	if (m_lastSelection.remove(citem))
+	{
+		m_destroyedSelection << citem;
+
+		onSelectionChanged();
+	}
+
+	m_itemHighlights.remove(citem);
+
+	Q_EMIT itemDestroyed(citem);
 }
 
 
 void CEditorScene::onSceneChanged()
 {
+	++m_stateRevision;
+
 	Q_EMIT sceneChanged();
 
 	layoutItemLabels();
@@ -1209,15 +1289,66 @@ void CEditorScene::onSceneChanged()
 
 void CEditorScene::onSelectionChanged()
 {
-	int selectionCount = selectedItems().size();
-	actions()->cutAction->setEnabled(selectionCount > 0);
-	actions()->copyAction->setEnabled(selectionCount > 0);
-	actions()->delAction->setEnabled(selectionCount > 0);
+	// drop cached selection
+	m_selectionCached = false;
+
+	// notify once per event loop turn
+	if (!m_selectionPending)
+	{
+		m_selectionPending = true;
+
+		QMetaObject::invokeMethod(this, "flushSelectionChanged", Qt::QueuedConnection);
+	}
+}
+
+
+void CEditorScene::flushSelectionChanged()
+{
+	if (!m_selectionPending)
+		return;
+
+	m_selectionPending = false;
+
+	// selection delta
+	const auto& selItems = getSelectedCItems();
+
+	QList<CItem*> added, removed;
+	removed.swap(m_destroyedSelection);
+
+	QSet<CItem*> currentSelection;
+	currentSelection.reserve(selItems.size());
+
+	for (auto item : selItems)
+	{
+		currentSelection.insert(item);
+
+		if (!m_lastSelection.contains(item))
+			added << item;
+	}
+
+	for (auto item : m_lastSelection)
+	{
+		if (!currentSelection.contains(item))
+			removed << item;
+	}
+
+	m_lastSelection.swap(currentSelection);
+
+	// actions
+	bool hasSelection = !selItems.isEmpty();
+	actions()->cutAction->setEnabled(hasSelection);
+	actions()->copyAction->setEnabled(hasSelection);
+	actions()->delAction->setEnabled(hasSelection);
 
 	if (m_editController)
 	{
 		m_editController->onSelectionChanged(*this);
 	}
+
+	if (added.size() || removed.size())
+	{
+		Q_EMIT selectionUpdated(added, removed);
+	}
 }
 
 
@@ -1230,9 +1361,13 @@ void CEditorScene::onFocusItemChanged(QGraphicsItem *newFocusItem, QGraphicsItem
 
 void CEditorScene::drawBackground(QPainter *painter, const QRectF &)
 {
+	PERF_SCOPE("paint.background");
+
 	// invalidate items if needed
 	if (m_needUpdateItems)
 	{
+		PERF_SCOPE("scene.updateItemCache");
+
 		m_needUpdateItems = false;
 		auto citems = getItems<CItem>();
 		for (auto citem : citems)
@@ -1240,6 +1375,8 @@ void CEditorScene::drawBackground(QPainter *painter, const QRectF &)
 			citem->updateCachedItems();
 			citem->getSceneItem()->update();
 		}
+
+		PERF_COUNT(itemCacheCounter, citems.size());
 	}
 
 	// update layout if needed
@@ -1285,6 +1422,8 @@ void CEditorScene::drawBackground(QPainter *painter, const QRectF &)
 
 void CEditorScene::drawForeground(QPainter *painter, const QRectF &r)
 {
+	PERF_SCOPE("paint.foreground");
+
     Super::drawForeground(painter, r);
 
 	// drop label update flag
@@ -1293,6 +1432,35 @@ void CEditorScene::drawForeground(QPainter *painter, const QRectF &r)
 	// draw transformer etc
 	if (m_editController)
 		m_editController->draw(*this, painter, r);
+
+	// marks of the visible items only
+	if (m_itemHighlights.size())
+	{
+		PERF_SCOPE("paint.highlights");
+
+		painter->save();
+
+		const QList<QGraphicsItem*> visibleItems = items(r);
+		for (QGraphicsItem* item : visibleItems)
+		{
+			CItem* citem = dynamic_cast<CItem*>(item);
+			auto it = citem ? m_itemHighlights.constFind(citem) : m_itemHighlights.constEnd();
+			if (it == m_itemHighlights.constEnd())
+				continue;
+
+			QPen pen(it.value(), 3, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin);
+			pen.setCosmetic(true);
+			painter->setPen(pen);
+
+			QColor fill(it.value());
+			fill.setAlpha(64);
+			painter->setBrush(fill);
+
+			painter->drawPath(item->sceneTransform().map(item->shape()));
+		}
+
+		painter->restore();
+	}
 }
 
 
@@ -1324,6 +1492,8 @@ void CEditorScene::setLabelsPolicy(CEditorScene::LabelsPolicy v)
 
 void CEditorScene::layoutItemLabels()
 {
+	PERF_SCOPE("scene.layoutLabels");
+
 	// reset region
 	m_usedLabelsRegion = QPainterPath();
 
@@ -1343,10 +1513,9 @@ void CEditorScene::layoutItemLabels()
 		return;
 	}
 
-	//QElapsedTimer tm;
-	//tm.start();
-
 	// else layout texts
+	PERF_COUNT(labelsCounter, allItems.size());
+
 	for (auto citem : allItems)
 	{
 		citem->updateLabelContent();
@@ -1370,8 +1539,6 @@ void CEditorScene::layoutItemLabels()
 
 		citem->showLabel(checkLabelRegion(reducedRect));
 	}
-
-	//qDebug() << "layout labels: " << tm.elapsed();
 }
 
 
@@ -1384,6 +1551,33 @@ void CEditorScene::needUpdate()
 }
 
 
+void CEditorScene::needLabelsUpdate()
+{
+	m_labelsUpdate = true;
+
+	update();
+}
+
+
+void CEditorScene::setItemHighlights(const QHash<CItem*, QColor>& highlights)
+{
+	m_itemHighlights = highlights;
+
+	update();
+}
+
+
+void CEditorScene::clearItemHighlights()
+{
+	if (m_itemHighlights.isEmpty())
+		return;
+
+	m_itemHighlights.clear();
+
+	update();
+}
+
+
 // mousing
 
 void CEditorScene::mousePressEvent(QGraphicsSceneMouseEvent *mouseEvent)
@@ -2382,6 +2576,22 @@ void CEditorScene::selectItems(const QList<CItem*>& items, bool exclusive)
 }
 
 
+const QList<CItem*>& CEditorScene::getSelectedCItems() const
+{
+	if (!m_selectionCached)
+		prefetchSelection();
+
+	return m_selItems;
+}
+
+
+void CEditorScene::prefetchSelection() const
+{
+	m_selItems = getSelectedItems<CItem>();
+	m_selectionCached = true;
+}
+
+
 void CEditorScene::beginSelection()
 {
 	blockSignals(true);
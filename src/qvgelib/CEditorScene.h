@@ -13,6 +13,8 @@ It can be used freely, maintaining the information above.
 #include <QGraphicsScene>
 #include <QGraphicsRectItem>
 #include <QSet>
+#include <QHash>
+#include <QColor>
 #include <QMenu>
 #include <QByteArrayList>
 
@@ -99,6 +101,19 @@ public:
 	void revertUndoState();
 	// sets initial scene state
 	void setInitialState();
+	// serialized state of the last undo point (default QDataStream version), cheap if cached by undo manager
+	QByteArray getStateSnapshot() const;
+	// max. RAM for undo history in bytes (0: unlimited), older steps are moved out of RAM
+	void setUndoMemoryBudget(qint64 bytes);
+	qint64 getUndoMemoryUsage() const;
+
+	// topology revision: changes when nodes or edges are added, removed, reconnected or change direction
+	quint64 getTopologyRevision() const { return m_topologyRevision; }
+	void invalidateTopology() { ++m_topologyRevision; }
+
+	// state revision: changes with every change of the scene made known by onSceneChanged() or invalidateState()
+	quint64 getStateRevision() const { return m_stateRevision; }
+	void invalidateState() { ++m_stateRevision; }
 
 	// serialization 
 	virtual bool storeTo(QDataStream& out, bool storeOptions) const;
@@ -193,6 +208,9 @@ public:
 	template<class T = CItem, class L = T>
 	QList<T*> getSelectedItems(bool triggeredIfEmpty = false) const;
 
+	// cached list of the selected CItems, valid until the selection changes
+	const QList<CItem*>& getSelectedCItems() const;
+
 	virtual void beginSelection();
 	virtual void endSelection();
 
@@ -246,6 +264,14 @@ public:
 
 	void needUpdate();
 
+	// labels only, laid out once by the next repaint
+	void needLabelsUpdate();
+
+	// temporary marks drawn over the items (i.e. the comparison results): not stored, not undoable
+	void setItemHighlights(const QHash<CItem*, QColor>& highlights);
+	void clearItemHighlights();
+	bool hasItemHighlights() const { return !m_itemHighlights.isEmpty(); }
+
 	virtual QPointF getSnapped(const QPointF& pos) const;
 
 	int getInfoStatus() const {
@@ -255,6 +281,7 @@ public:
 	QGraphicsView* getCurrentView();
 
 	// callbacks
+	virtual void onItemAdded(CItem *citem);
 	virtual void onItemDestroyed(CItem *citem);
 
 public Q_SLOTS:
@@ -292,6 +319,16 @@ Q_SIGNALS:
 
 	void infoStatusChanged(int status);
 
+	// coalesced selectionChanged(): emitted once per event loop turn with the selection delta.
+	// removed items could be already destroyed, so use them as the keys only.
+	void selectionUpdated(const QList<CItem*>& added, const QList<CItem*>& removed);
+
+	// emitted when a node or an edge is put onto the scene (but not when a stored state is restored)
+	void itemAdded(CItem* item);
+
+	// emitted from the item's destructor: the item must not be accessed, use it as the key only.
+	void itemDestroyed(CItem* item);
+
 protected:
 	void setInfoStatus(int status);
 
@@ -335,8 +372,12 @@ protected:
 
 	virtual void onSceneChanged();
 
+	// fills the cached selection lists
+	virtual void prefetchSelection() const;
+
 protected Q_SLOTS:
 	virtual void onSelectionChanged();
+	void flushSelectionChanged();
 	void onFocusItemChanged(QGraphicsItem *newFocusItem, QGraphicsItem *oldFocusItem, Qt::FocusReason reason);
 	void onItemEditingFinished(CItem *item, bool cancelled);
 
@@ -364,6 +405,10 @@ protected:
 	// pimpl
 	class CEditorScene_p* m_pimpl = nullptr;
 
+	// cached selection
+	mutable QList<CItem*> m_selItems;
+	mutable bool m_selectionCached = false;
+
 private:
 	int m_infoStatus;
 
@@ -372,6 +417,9 @@ private:
 
 	IUndoManager *m_undoManager = nullptr;
 	bool m_inProgress = false;
+
+	quint64 m_topologyRevision = 0;
+	quint64 m_stateRevision = 0;
 	
 	QGraphicsItem *m_menuTriggerItem = nullptr;
 	ISceneMenuController *m_menuController = nullptr;
@@ -380,6 +428,13 @@ private:
 
 	ISceneEditController *m_editController = nullptr;
 
+	// selection delta since the last selectionUpdated()
+	bool m_selectionPending = false;
+	QSet<CItem*> m_lastSelection;
+	QList<CItem*> m_destroyedSelection;
+
+	QHash<CItem*, QColor> m_itemHighlights;
+
 	QMap<QByteArray, QByteArray> m_classToSuperIds;
 	ClassAttributesMap m_classAttributes;
     QMap<QByteArray, QSet<QByteArray>> m_classAttributesVis;
@@ -9,8 +9,11 @@ It can be used freely, maintaining the information above.
 
 #include "CEditorView.h"
 #include "CEditorScene.h"
+#include "CItem.h"
+#include "CPerfTrace.h"
 
 #include <QMouseEvent> 
+#include <QPainter>
 #include <QScrollBar> 
 #include <QGuiApplication>
 #include <QGLWidget>
@@ -38,6 +41,9 @@ CEditorView::CEditorView(QWidget *parent)
 
 	connect(&m_scrollTimer, SIGNAL(timeout()), this, SLOT(onScrollTimeout()));
 	m_scrollTimer.setInterval(100);
+
+	connect(&m_hudTimer, SIGNAL(timeout()), this, SLOT(onHUDTimeout()));
+	m_hudTimer.setInterval(500);
 }
 
 
@@ -346,6 +352,139 @@ void CEditorView::contextMenuEvent(QContextMenuEvent *e)
 #endif
 
 
+void CEditorView::paintEvent(QPaintEvent * event)
+{
+	QRect updateRect = event->region().boundingRect();
+
+	QElapsedTimer frameTimer;
+	frameTimer.start();
+
+	{
+		PERF_SCOPE("paint.view");
+
+		QPaintEvent newEvent(updateRect);
+		QGraphicsView::paintEvent(&newEvent);
+	}
+
+	qint64 frameTime = frameTimer.nsecsElapsed() / 1000;
+
+	// per-frame counter values
+	CPerfTrace::sampleCounters();
+
+	if (!m_hudVisible)
+		return;
+
+	// read-only: the counters are shared with the trace, so the frame values are the differences to the last snapshot
+	qint64 lastPainted = m_paintedItemsSnapshot;
+	qint64 lastLabels = m_laidOutLabelsSnapshot;
+	qint64 lastEdges = m_updatedEdgesSnapshot;
+
+	takeHUDSnapshot();
+
+	qint64 painted = m_paintedItemsSnapshot - lastPainted;
+	qint64 labels = m_laidOutLabelsSnapshot - lastLabels;
+	qint64 edges = m_updatedEdgesSnapshot - lastEdges;
+
+	// HUD refresh only: keep the values of the last real frame
+	if (!getHUDRect().contains(updateRect))
+	{
+		m_frameTime = frameTime;
+		m_paintedItems = painted;
+		m_laidOutLabels = labels;
+		m_updatedEdges = edges;
+	}
+
+	if (updateRect.intersects(getHUDRect()))
+		drawPerformanceHUD();
+}
+
+
+// performance HUD
+
+void CEditorView::takeHUDSnapshot()
+{
+	static CPerfCounter* paintedNodes = CPerfCounter::find("paint.nodes");
+	static CPerfCounter* paintedEdges = CPerfCounter::find("paint.edges");
+	static CPerfCounter* laidOutLabels = CPerfCounter::find("labels.laidOut");
+	static CPerfCounter* updatedEdges = CPerfCounter::find("edges.updated");
+
+	m_paintedItemsSnapshot = (paintedNodes ? paintedNodes->value() : 0) + (paintedEdges ? paintedEdges->value() : 0);
+	m_laidOutLabelsSnapshot = laidOutLabels ? laidOutLabels->value() : 0;
+	m_updatedEdgesSnapshot = updatedEdges ? updatedEdges->value() : 0;
+}
+
+
+void CEditorView::setPerformanceHUDVisible(bool on)
+{
+	if (m_hudVisible == on)
+		return;
+
+	m_hudVisible = on;
+
+	CPerfTrace::setCountingEnabled(on);
+
+	if (on)
+	{
+		// count from now on
+		takeHUDSnapshot();
+
+		m_hudTimer.start();
+	}
+	else
+		m_hudTimer.stop();
+
+	viewport()->update();
+}
+
+
+void CEditorView::onHUDTimeout()
+{
+	viewport()->update(getHUDRect());
+}
+
+
+QRect CEditorView::getHUDRect() const
+{
+	int lineHeight = fontMetrics().height();
+	return QRect(8, 8, lineHeight * 16, lineHeight * 5 + 12);
+}
+
+
+void CEditorView::drawPerformanceHUD()
+{
+	// count of items is not cheap: refresh it once a second
+	CEditorScene* editorScene = dynamic_cast<CEditorScene*>(scene());
+	if (editorScene && (!m_totalItemsTimer.isValid() || m_totalItemsTimer.elapsed() > 1000))
+	{
+		m_totalItems = editorScene->getItems<CItem>().size();
+		m_totalItemsTimer.start();
+	}
+
+	static CPerfCounter* undoState = CPerfCounter::find("undo.stateBytes");
+	qint64 undoMemory = editorScene ? editorScene->getUndoMemoryUsage() : 0;
+
+	QStringList lines;
+	lines << tr("Frame: %1 ms").arg(m_frameTime / 1000.0, 0, 'f', 1);
+	lines << tr("Painted: %1 / %2 items").arg(m_paintedItems).arg(m_totalItems);
+	lines << tr("Labels laid out: %1").arg(m_laidOutLabels);
+	lines << tr("Edges recomputed: %1").arg(m_updatedEdges);
+	lines << tr("Undo state: %1 KB (history %2 MB)")
+		.arg(undoState ? undoState->value() / 1024 : 0)
+		.arg(undoMemory / (1024.0 * 1024.0), 0, 'f', 1);
+
+	QRect hudRect = getHUDRect();
+
+	QPainter painter(viewport());
+	painter.setPen(Qt::NoPen);
+	painter.setBrush(QColor(0, 0, 0, 160));
+	painter.drawRoundedRect(hudRect, 4, 4);
+
+	painter.setPen(Qt::white);
+	painter.setFont(font());
+	painter.drawText(hudRect.adjusted(6, 6, -6, -6), Qt::AlignLeft | Qt::AlignTop, lines.join('\n'));
+}
+
+
 void CEditorView::wheelEvent(QWheelEvent *e)
 {
 	// original taken from
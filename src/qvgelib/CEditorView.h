@@ -14,8 +14,10 @@ It can be used freely, maintaining the information above.
 #include <QGraphicsItem>
 #include <QPaintEvent>
 #include <QTimer>
+#include <QElapsedTimer>
 
 class CEditorScene;
+class CPerfCounter;
 
 class CEditorView : public QGraphicsView
 {
@@ -45,6 +47,10 @@ public:
 
 	void centerContent();
 
+	// overlay with the painting statistics (uses instrumentation counters, see CPerfTrace)
+	void setPerformanceHUDVisible(bool on);
+	bool isPerformanceHUDVisible() const { return m_hudVisible; }
+
 	// scene
 	QGraphicsItem* getDragItem()
 	{
@@ -61,12 +67,7 @@ public:
 	virtual void contextMenuEvent(QContextMenuEvent *e);
 	virtual void wheelEvent(QWheelEvent *e);
 
-	void paintEvent(QPaintEvent * event)
-	{
-		QPaintEvent *newEvent = new QPaintEvent(event->region().boundingRect());
-		QGraphicsView::paintEvent(newEvent);
-		delete newEvent;
-	}
+	virtual void paintEvent(QPaintEvent * event);
 
 Q_SIGNALS:
 	void scaleChanged(double);
@@ -74,6 +75,12 @@ Q_SIGNALS:
 private Q_SLOTS:
 	void restoreContextMenu();
 	void onScrollTimeout();
+	void onHUDTimeout();
+
+private:
+	QRect getHUDRect() const;
+	void drawPerformanceHUD();
+	void takeHUDSnapshot();
 
 private:
 	DragMode m_dragModeTmp;
@@ -88,6 +95,19 @@ private:
 
 	QTimer m_scrollTimer;
 	float m_scrollThreshold = 30;
+
+	// performance HUD: values of the last frame
+	bool m_hudVisible = false;
+	QTimer m_hudTimer;
+	qint64 m_frameTime = 0;
+	qint64 m_paintedItems = 0;
+	qint64 m_laidOutLabels = 0;
+	qint64 m_updatedEdges = 0;
+	qint64 m_paintedItemsSnapshot = 0;
+	qint64 m_laidOutLabelsSnapshot = 0;
+	qint64 m_updatedEdgesSnapshot = 0;
+	int m_totalItems = 0;
+	QElapsedTimer m_totalItemsTimer;
 };
 
 #endif // CEDITORVIEW_H
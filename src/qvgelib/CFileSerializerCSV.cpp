@@ -8,6 +8,7 @@ It can be used freely, maintaining the information above.
 */
 
 #include "CFileSerializerCSV.h"
+#include "CPerfTrace.h"
 #include "CAttribute.h"
 #include "CNode.h"
 #include "CDirectEdge.h"
@@ -23,6 +24,8 @@ It can be used freely, maintaining the information above.
 
 bool CFileSerializerCSV::load(const QString& fileName, CEditorScene& scene, QString* lastError) const
 {
+	PERF_SCOPE("io.csv.load");
+
     CNodeEditorScene* nodeScene = dynamic_cast<CNodeEditorScene*>(&scene);
     if (nodeScene == nullptr)
         return false;
@@ -36,6 +39,9 @@ bool CFileSerializerCSV::load(const QString& fileName, CEditorScene& scene, QStr
 
     CGraphInterface graph(*nodeScene);
 
+	// ids are looked up in the hashes
+	graph.beginUpdate();
+
     QTextStream ts(&file);
     while (!ts.atEnd())
     {
@@ -48,6 +54,8 @@ bool CFileSerializerCSV::load(const QString& fileName, CEditorScene& scene, QStr
         /*auto edge =*/ graph.addEdge(items[0], items[1], items[2]);
     }
 
+	graph.endUpdate();
+
     file.close();
 
     // update scene rect
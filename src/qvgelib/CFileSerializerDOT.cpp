@@ -8,6 +8,7 @@ It can be used freely, maintaining the information above.
 */
 
 #include "CFileSerializerDOT.h"
+#include "CPerfTrace.h"
 #include "CNode.h"
 #include "CEdge.h"
 #include "CPolyEdge.h"
@@ -17,70 +18,128 @@ It can be used freely, maintaining the information above.
 #include <QFile>
 #include <QTextStream>
 #include <QFileInfo>
+#include <QProcess>
+
+
+// pipes: pass the text to the reader while it is being generated
+
+static const int chunkItems = 1000;
+
+// the generator waits while more is buffered: the reader has to keep up (bytes)
+static const qint64 maxPendingBytes = 1 << 20;
+
+// waiting for the reader (ms), repeated while it is alive
+static const int pendingWaitTime = 100;
+
+static bool writeChunk(QTextStream& ts, QIODevice& device, int itemIndex)
+{
+	if (!device.isSequential() || (itemIndex + 1) % chunkItems)
+		return true;
+
+	ts.flush();
+
+	// other sequential devices buffer everything
+	QProcess* process = qobject_cast<QProcess*>(&device);
+	if (!process)
+		return true;
+
+	while (process->bytesToWrite() > maxPendingBytes)
+	{
+		if (process->waitForBytesWritten(pendingWaitTime))
+			continue;
+
+		// the reader is gone: nothing more will be written (a timeout is not an error here)
+		if (process->state() == QProcess::NotRunning || process->error() == QProcess::WriteError)
+			return false;
+	}
+
+	return true;
+}
 
 
 // reimp
 
 bool CFileSerializerDOT::save(const QString& fileName, CEditorScene& scene, QString* lastError) const
 {
+	PERF_SCOPE("io.dot.save");
+
 	QFile saveFile(fileName);
 	if (saveFile.open(QFile::WriteOnly))
 	{
-        QTextStream ts(&saveFile);
-		ts.setCodec("UTF-8");
-		//ts.setGenerateByteOrderMark(true);
+		return write(saveFile, scene, QFileInfo(fileName).completeBaseName(), lastError);
+	}
 
-        QString graphId = QFileInfo(fileName).completeBaseName();
+	return false;
+}
 
-        ts << "digraph \"" << graphId << "\"\n{";
-		ts << "\n\n";
 
-		// we'll output points, not inches
-		//ts << "\n\n";
-		//ts << "inputscale = 72;";
+bool CFileSerializerDOT::write(QIODevice& device, CEditorScene& scene, const QString& graphId, QString* lastError) const
+{
+    QTextStream ts(&device);
+	ts.setCodec("UTF-8");
+	//ts.setGenerateByteOrderMark(true);
 
-		// background
-		if (m_writeBackground)
-		{
-			ts << "bgcolor = \"" << scene.backgroundBrush().color().name() << "\"";
-			ts << "\n\n";
-		}
+    ts << "digraph \"" << graphId << "\"\n{";
+	ts << "\n\n";
 
-        // nodes
-		if (m_writeAttrs)
-		{
-			doWriteNodeDefaults(ts, scene);
-			ts << "\n\n";
-		}
+	// we'll output points, not inches
+	//ts << "\n\n";
+	//ts << "inputscale = 72;";
 
-        auto nodes = scene.getItems<CNode>();
-        for (auto node: nodes)
-        {
-			doWriteNode(ts, *node, scene);
-        }
+	// background
+	if (m_writeBackground)
+	{
+		ts << "bgcolor = \"" << scene.backgroundBrush().color().name() << "\"";
+		ts << "\n\n";
+	}
 
+    // nodes
+	if (m_writeAttrs)
+	{
+		doWriteNodeDefaults(ts, scene);
 		ts << "\n\n";
+	}
 
+    auto nodes = scene.getItems<CNode>();
+    for (int i = 0; i < nodes.size(); ++i)
+    {
+		doWriteNode(ts, *nodes.at(i), scene);
 
-        // edges
-		if (m_writeAttrs)
+		if (!writeChunk(ts, device, i))
 		{
-			doWriteEdgeDefaults(ts, scene);
-			ts << "\n\n";
+			if (lastError)
+				*lastError = QObject::tr("The reader has stopped");
+			return false;
 		}
+    }
 
-        auto edges = scene.getItems<CEdge>();
-        for (auto edge: edges)
-        {
-			doWriteEdge(ts, *edge, scene);
-        }
+	ts << "\n\n";
 
-		ts << "\n}\n";
 
-		return true;
+    // edges
+	if (m_writeAttrs)
+	{
+		doWriteEdgeDefaults(ts, scene);
+		ts << "\n\n";
 	}
 
-	return false;
+    auto edges = scene.getItems<CEdge>();
+    for (int i = 0; i < edges.size(); ++i)
+    {
+		doWriteEdge(ts, *edges.at(i), scene);
+
+		if (!writeChunk(ts, device, i))
+		{
+			if (lastError)
+				*lastError = QObject::tr("The reader has stopped");
+			return false;
+		}
+    }
+
+	ts << "\n}\n";
+	ts.flush();
+
+	return (ts.status() == QTextStream::Ok);
 }
 
 
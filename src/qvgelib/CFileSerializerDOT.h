@@ -19,6 +19,7 @@ class CNode;
 class CEdge;
 
 class QTextStream;
+class QIODevice;
 
 
 class CFileSerializerDOT : public IFileSerializer
@@ -55,6 +56,9 @@ public:
 
 	virtual bool save(const QString& fileName, CEditorScene& scene, QString* lastError = nullptr) const;
 
+	// writes to any device, i.e. stdin of GraphViz
+	bool write(QIODevice& device, CEditorScene& scene, const QString& graphId, QString* lastError = nullptr) const;
+
 private:
 	void doWriteNodeDefaults(QTextStream& ts, const CEditorScene& scene) const;
 	void doWriteNode(QTextStream& ts, const CNode& node, const CEditorScene& scene) const;
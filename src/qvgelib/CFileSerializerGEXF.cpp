@@ -8,6 +8,7 @@ It can be used freely, maintaining the information above.
 */
 
 #include "CFileSerializerGEXF.h"
+#include "CPerfTrace.h"
 #include "CNode.h"
 #include "CDirectEdge.h"
 #include "CPolyEdge.h"
@@ -23,6 +24,8 @@ It can be used freely, maintaining the information above.
 
 bool CFileSerializerGEXF::load(const QString& fileName, CEditorScene& scene, QString* lastError) const
 {
+	PERF_SCOPE("io.gexf.load");
+
 	// read file into document
 	QFile file(fileName);
 	if (!file.open(QIODevice::ReadOnly))
@@ -401,6 +404,8 @@ bool CFileSerializerGEXF::readEdge(int /*index*/, const QDomNode &domNode, const
 
 bool CFileSerializerGEXF::save(const QString& fileName, CEditorScene& scene, QString* /*lastError*/) const
 {
+	PERF_SCOPE("io.gexf.save");
+
 	QFile file(fileName);
 	if (!file.open(QIODevice::WriteOnly))
 		return false;
@@ -8,6 +8,7 @@ It can be used freely, maintaining the information above.
 */
 
 #include "CFileSerializerGraphML.h"
+#include "CPerfTrace.h"
 #include "CAttribute.h"
 #include "CNode.h"
 #include "CDirectEdge.h"
@@ -22,6 +23,8 @@ It can be used freely, maintaining the information above.
 
 bool CFileSerializerGraphML::load(const QString& fileName, CEditorScene& scene, QString* lastError) const
 {
+	PERF_SCOPE("io.graphml.load");
+
 	CFormatGraphML graphML;
 	Graph graphModel;
 
@@ -34,6 +37,8 @@ bool CFileSerializerGraphML::load(const QString& fileName, CEditorScene& scene,
 
 bool CFileSerializerGraphML::save(const QString& fileName, CEditorScene& scene, QString* lastError) const
 {
+	PERF_SCOPE("io.graphml.save");
+
 	CFormatGraphML graphML;
 	Graph graphModel;
 
@@ -8,6 +8,7 @@ It can be used freely, maintaining the information above.
 */
 
 #include "CFileSerializerPlainDOT.h"
+#include "CPerfTrace.h"
 #include "CAttribute.h"
 #include "CNode.h"
 #include "CDirectEdge.h"
@@ -22,6 +23,8 @@ It can be used freely, maintaining the information above.
 
 bool CFileSerializerPlainDOT::load(const QString& fileName, CEditorScene& scene, QString* lastError) const
 {
+	PERF_SCOPE("io.plaindot.load");
+
 	CFormatPlainDOT graphFormat;
 	Graph graphModel;
 
@@ -8,6 +8,7 @@ It can be used freely, maintaining the information above.
 */
 
 #include "CFileSerializerXGR.h"
+#include "CPerfTrace.h"
 #include "CEditorScene.h"
 #include "ISceneItemFactory.h"
 
@@ -48,6 +49,8 @@ static CDPSERecoder s_dpseRecoder;
 
 bool CFileSerializerXGR::load(const QString& fileName, CEditorScene& scene, QString* /*lastError*/) const
 {
+	PERF_SCOPE("io.xgr.load");
+
 	// read file into document
 	QFile openFile(fileName);
 	if (!openFile.open(QIODevice::ReadOnly))
@@ -74,6 +77,8 @@ bool CFileSerializerXGR::load(const QString& fileName, CEditorScene& scene, QStr
 
 bool CFileSerializerXGR::save(const QString& fileName, CEditorScene& scene, QString* /*lastError*/) const
 {
+	PERF_SCOPE("io.xgr.save");
+
 	QFile saveFile(fileName);
 	if (saveFile.open(QFile::WriteOnly))
 	{
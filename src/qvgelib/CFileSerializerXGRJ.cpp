@@ -0,0 +1,219 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#include "CFileSerializerXGRJ.h"
+#include "CPerfTrace.h"
+#include "CStateJournal.h"
+#include "CEditorScene.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+#include <QtCore/QDataStream>
+#include <QtCore/QObject>
+#include <QtConcurrent/QtConcurrentRun>
+
+
+CFileSerializerXGRJ::~CFileSerializerXGRJ()
+{
+	m_splitting.waitForFinished();
+}
+
+
+// reimp
+
+bool CFileSerializerXGRJ::load(const QString& fileName, CEditorScene& scene, QString* lastError) const
+{
+	PERF_SCOPE("io.xgrj.load");
+
+	QFile openFile(fileName);
+	if (!openFile.open(QIODevice::ReadOnly))
+	{
+		if (lastError)
+			*lastError = QObject::tr("Cannot open file");
+		return false;
+	}
+
+	// base image + changes
+	QByteArray state;
+	int streamVersion = 0;
+	qint64 imageSize = 0;
+	if (!CStateJournal::read(openFile, state, streamVersion, nullptr, lastError, &imageSize))
+		return false;
+
+	// a torn tail would hide the appended changes
+	bool appendable = openFile.atEnd() && streamVersion == QDataStream().version();
+
+	scene.reset();
+
+	QDataStream ds(&state, QIODevice::ReadOnly);
+	ds.setVersion(streamVersion);
+
+	if (!scene.restoreFrom(ds, true))
+	{
+		if (lastError)
+			*lastError = QObject::tr("Scene data is corrupted");
+		return false;
+	}
+
+	scene.addUndoState();
+
+	resetState();
+
+	// the restored items keep their stored ids, so the next save appends the changes only
+	if (appendable)
+	{
+		QFileInfo fi(fileName);
+		m_fileName = fileName;
+		m_savedState = state;
+		m_fileSize = fi.size();
+		m_imageSize = imageSize;
+		m_fileModified = fi.lastModified();
+
+		startSplitting();
+	}
+
+	return true;
+}
+
+
+bool CFileSerializerXGRJ::save(const QString& fileName, CEditorScene& scene, QString* lastError) const
+{
+	PERF_SCOPE("io.xgrj.save");
+
+	QByteArray state = scene.getStateSnapshot();
+
+	// the same file not touched since the last save: append the changes only
+	if (fileName == m_fileName && m_savedState.size())
+	{
+		QFileInfo fi(fileName);
+		if (fi.exists() && fi.size() == m_fileSize && fi.lastModified() == m_fileModified)
+		{
+			if (appendChanges(state))
+				return true;
+
+			// unknown file state (a torn record is ignored by reading): rewrite it
+		}
+	}
+
+	return writeImage(fileName, state, lastError);
+}
+
+
+// privates
+
+bool CFileSerializerXGRJ::writeImage(const QString& fileName, const QByteArray& state, QString* lastError) const
+{
+	PERF_SCOPE("io.xgrj.image");
+
+	resetState();
+
+	QSaveFile saveFile(fileName);
+	if (!saveFile.open(QIODevice::WriteOnly))
+	{
+		if (lastError)
+			*lastError = QObject::tr("Cannot open file for writing");
+		return false;
+	}
+
+	if (!CStateJournal::writeImage(saveFile, state, QDataStream().version()) || !saveFile.commit())
+	{
+		if (lastError)
+			*lastError = QObject::tr("Cannot write file");
+		return false;
+	}
+
+	QFileInfo fi(fileName);
+	m_fileName = fileName;
+	m_savedState = state;
+	m_fileSize = m_imageSize = fi.size();
+	m_fileModified = fi.lastModified();
+
+	startSplitting();
+
+	return true;
+}
+
+
+bool CFileSerializerXGRJ::appendChanges(const QByteArray& state) const
+{
+	PERF_SCOPE("io.xgrj.append");
+
+	// the new state is split while the chunks of the saved one are being finished
+	QFuture<CBlockDiff::Chunks> splitting = QtConcurrent::run([state]() { return CBlockDiff::split(state); });
+
+	finishSplitting();
+
+	CBlockDiff::Chunks chunks = splitting.result();
+
+	// the changed regions only
+	CBlockDiff::Patches patches;
+	CBlockDiff::diff(m_savedState, m_savedChunks, state, chunks, &patches, nullptr);
+
+	if (patches.size())
+	{
+		QFile journalFile(m_fileName);
+		if (!journalFile.open(QIODevice::WriteOnly | QIODevice::Append))
+			return false;
+
+		if (!CStateJournal::appendPatches(journalFile, patches) || !journalFile.flush())
+			return false;
+
+		journalFile.close();
+	}
+
+	QFileInfo fi(m_fileName);
+	m_savedState = state;
+	m_savedChunks = chunks;
+	m_fileSize = fi.size();
+	m_fileModified = fi.lastModified();
+
+	// too many changes: rewrite the image (the journal is valid anyway, so a failure is not an error)
+	if ((m_fileSize - m_imageSize) * 100 > m_imageSize * m_compactionRatio)
+	{
+		PERF_SCOPE("io.xgrj.compact");
+
+		QString fileName = m_fileName;
+		writeImage(fileName, state, nullptr);
+	}
+
+	return true;
+}
+
+
+void CFileSerializerXGRJ::startSplitting() const
+{
+	QByteArray state = m_savedState;
+
+	m_savedChunks.clear();
+	m_splitting = QtConcurrent::run([state]() { return CBlockDiff::split(state); });
+}
+
+
+void CFileSerializerXGRJ::finishSplitting() const
+{
+	if (m_splitting.isCanceled() || !m_splitting.isStarted())
+		return;
+
+	m_savedChunks = m_splitting.result();
+	m_splitting = QFuture<CBlockDiff::Chunks>();
+}
+
+
+void CFileSerializerXGRJ::resetState() const
+{
+	m_splitting.waitForFinished();
+	m_splitting = QFuture<CBlockDiff::Chunks>();
+
+	m_fileName.clear();
+	m_savedState.clear();
+	m_savedChunks.clear();
+	m_fileSize = m_imageSize = 0;
+	m_fileModified = QDateTime();
+}
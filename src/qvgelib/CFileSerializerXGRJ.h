@@ -0,0 +1,78 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QDateTime>
+#include <QtCore/QFuture>
+
+#include "qvgelib/IFileSerializer.h"
+#include "CBlockDiff.h"
+
+
+// Journaled XGR: the base image of the scene followed by the appended changes (see CStateJournal).
+// The same instance should be used for the loading & the subsequent saves of a document: then only
+// the changed regions since the last save are appended, and the file is compacted when the changes grow.
+// The saved state is split into the chunks by a worker thread meanwhile; the append itself is finished
+// before save() returns, and if it fails, the whole image is written instead.
+
+class CFileSerializerXGRJ : public IFileSerializer
+{
+public:
+	virtual ~CFileSerializerXGRJ();
+
+	// full image is rewritten when the changes grow over the given % of the image size
+	void setCompactionRatio(int percent) { m_compactionRatio = percent; }
+
+	// reimp
+	virtual QString description() const {
+		return "QVGE journaled graph scene format";
+	}
+
+	virtual QString filters() const {
+		return "*.xgrj";
+	}
+
+	virtual QString defaultFileExtension() const {
+		return "xgrj";
+	}
+
+	virtual bool loadSupported() const {
+		return true;
+	}
+
+	virtual bool load(const QString& fileName, CEditorScene& scene, QString* lastError = nullptr) const;
+
+	virtual bool saveSupported() const {
+		return true;
+	}
+
+	virtual bool save(const QString& fileName, CEditorScene& scene, QString* lastError = nullptr) const;
+
+private:
+	bool writeImage(const QString& fileName, const QByteArray& state, QString* lastError) const;
+	bool appendChanges(const QByteArray& state) const;
+	void startSplitting() const;
+	void finishSplitting() const;
+	void resetState() const;
+
+	int m_compactionRatio = 100;
+
+	// last saved (or loaded) file & its state
+	mutable QString m_fileName;
+	mutable QByteArray m_savedState;
+	mutable CBlockDiff::Chunks m_savedChunks;	// empty if not split yet
+	mutable qint64 m_fileSize = 0;
+	mutable qint64 m_imageSize = 0;
+	mutable QDateTime m_fileModified;
+
+	// chunks of m_savedState, split in background
+	mutable QFuture<CBlockDiff::Chunks> m_splitting;
+};
@@ -0,0 +1,445 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#include "CGraphAnalytics.h"
+#include "CAdjacencySnapshot.h"
+#include "CNodeEditorScene.h"
+#include "CNode.h"
+#include "CPerfTrace.h"
+
+#include <QtConcurrent/QtConcurrentRun>
+#include <QFutureSynchronizer>
+#include <QThreadPool>
+#include <QThread>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <random>
+#include <algorithm>
+
+
+// items per parallel task at least
+static const int minChunkSize = 1024;
+
+
+// runs func(begin, end) over the chunks of [0, count) in the pool, or in place if not worth it
+template<class Func>
+static void parallelFor(QThreadPool& pool, int count, int minChunk, const Func& func)
+{
+	int chunks = qMin(pool.maxThreadCount(), count / qMax(1, minChunk));
+	if (chunks < 2)
+	{
+		func(0, count);
+		return;
+	}
+
+	QFutureSynchronizer<void> tasks;
+	for (int c = 0; c < chunks; ++c)
+	{
+		int begin = int(qint64(count) * c / chunks);
+		int end = int(qint64(count) * (c + 1) / chunks);
+		tasks.addFuture(QtConcurrent::run(&pool, [&func, begin, end]() { func(begin, end); }));
+	}
+
+	tasks.waitForFinished();
+}
+
+
+static bool isCanceled(const CGraphAnalytics::Options& options)
+{
+	return options.canceled && options.canceled->loadAcquire();
+}
+
+
+// metrics
+
+static void computeDegrees(const CAdjacencySnapshot& g, QThreadPool& pool, CGraphAnalytics::Result& result)
+{
+	PERF_SCOPE("analytics.degree");
+
+	const int n = g.nodeCount();
+	result.degree.resize(n);
+	result.inDegree.resize(n);
+	result.outDegree.resize(n);
+
+	// the tasks write to the own ranges only
+	int *degree = result.degree.data();
+	int *inDegree = result.inDegree.data();
+	int *outDegree = result.outDegree.data();
+
+	parallelFor(pool, n, minChunkSize, [&](int begin, int end)
+	{
+		for (int v = begin; v < end; ++v)
+		{
+			degree[v] = g.degree(v);
+			inDegree[v] = g.inDegree(v);
+			outDegree[v] = g.outDegree(v);
+		}
+	});
+}
+
+
+// union-find is linear in practice, not worth the threads
+static void computeComponents(const CAdjacencySnapshot& g, CGraphAnalytics::Result& result)
+{
+	PERF_SCOPE("analytics.components");
+
+	const int n = g.nodeCount();
+
+	QVector<int> parent(n);
+	for (int v = 0; v < n; ++v)
+		parent[v] = v;
+
+	auto find = [&parent](int v)
+	{
+		while (parent[v] != v)
+		{
+			parent[v] = parent[parent[v]];
+			v = parent[v];
+		}
+		return v;
+	};
+
+	for (int e = 0; e < g.edgeCount(); ++e)
+	{
+		int a = find(g.edgeSource(e));
+		int b = find(g.edgeTarget(e));
+		if (a != b)
+			parent[qMax(a, b)] = qMin(a, b);
+	}
+
+	// numbered in the order of the nodes
+	QVector<int> index(n, -1);
+	result.component.resize(n);
+	result.componentCount = 0;
+
+	for (int v = 0; v < n; ++v)
+	{
+		int root = find(v);
+		if (index[root] < 0)
+			index[root] = result.componentCount++;
+
+		result.component[v] = index[root];
+	}
+}
+
+
+// power iteration, each node pulls from its predecessors
+static void computePageRank(const CAdjacencySnapshot& g, QThreadPool& pool, const CGraphAnalytics::Options& options, CGraphAnalytics::Result& result)
+{
+	PERF_SCOPE("analytics.pagerank");
+
+	const int n = g.nodeCount();
+	if (n == 0)
+		return;
+
+	const double d = options.damping;
+
+	QVector<double> rank(n, 1.0 / n), next(n), contribution(n);
+
+	for (int iteration = 0; iteration < options.maxIterations && !isCanceled(options); ++iteration)
+	{
+		const double *rankData = rank.constData();
+		double *contributionData = contribution.data();
+		double *nextData = next.data();
+
+		parallelFor(pool, n, minChunkSize, [&](int begin, int end)
+		{
+			for (int v = begin; v < end; ++v)
+			{
+				int out = g.outDegree(v);
+				contributionData[v] = out ? rankData[v] / out : 0;
+			}
+		});
+
+		// rank of the dead ends is spread over all the nodes
+		double dangling = 0;
+		for (int v = 0; v < n; ++v)
+		{
+			if (g.outDegree(v) == 0)
+				dangling += rank[v];
+		}
+
+		const double base = (1.0 - d) / n + d * dangling / n;
+
+		parallelFor(pool, n, minChunkSize, [&](int begin, int end)
+		{
+			for (int v = begin; v < end; ++v)
+			{
+				double sum = 0;
+				for (const auto& arc : g.inArcs(v))
+					sum += contributionData[arc.node];
+
+				nextData[v] = base + d * sum;
+			}
+		});
+
+		double delta = 0;
+		for (int v = 0; v < n; ++v)
+			delta += qAbs(next[v] - rank[v]);
+
+		rank.swap(next);
+
+		if (delta < options.tolerance)
+			break;
+	}
+
+	result.pageRank = rank;
+}
+
+
+// Brandes over the sampled sources, scaled up to all the sources; every task has own buffers
+static void computeBetweenness(const CAdjacencySnapshot& g, QThreadPool& pool, const CGraphAnalytics::Options& options, CGraphAnalytics::Result& result)
+{
+	PERF_SCOPE("analytics.betweenness");
+
+	const int n = g.nodeCount();
+	result.betweenness.fill(0, n);
+	if (n == 0)
+		return;
+
+	QVector<int> sources(n);
+	for (int v = 0; v < n; ++v)
+		sources[v] = v;
+
+	int sampleCount = n;
+	if (options.betweennessSamples > 0 && options.betweennessSamples < n)
+	{
+		// partial Fisher-Yates, raw mt19937 output to be the same everywhere
+		std::mt19937 rng(options.seed);
+		sampleCount = options.betweennessSamples;
+
+		for (int i = 0; i < sampleCount; ++i)
+			std::swap(sources[i], sources[i + int(rng() % quint32(n - i))]);
+	}
+
+	const double scale = double(n) / sampleCount;
+
+	QMutex mutex;
+
+	parallelFor(pool, sampleCount, 1, [&](int begin, int end)
+	{
+		QVector<double> centrality(n, 0), delta(n);
+		QVector<double> sigma(n);
+		QVector<int> distance(n, -1);
+		QVector<int> order;
+		order.reserve(n);
+
+		for (int i = begin; i < end && !isCanceled(options); ++i)
+		{
+			const int s = sources[i];
+
+			// BFS: the order array is the queue as well
+			order.clear();
+			order << s;
+			distance[s] = 0;
+			sigma[s] = 1;
+
+			for (int head = 0; head < order.size(); ++head)
+			{
+				int v = order[head];
+
+				for (const auto& arc : g.outArcs(v))
+				{
+					int w = arc.node;
+					if (distance[w] < 0)
+					{
+						distance[w] = distance[v] + 1;
+						sigma[w] = 0;
+						order << w;
+					}
+
+					if (distance[w] == distance[v] + 1)
+						sigma[w] += sigma[v];
+				}
+			}
+
+			// dependencies in the reverse order
+			for (int v : order)
+				delta[v] = 0;
+
+			for (int k = order.size() - 1; k > 0; --k)
+			{
+				int w = order[k];
+
+				for (const auto& arc : g.inArcs(w))
+				{
+					int v = arc.node;
+					if (distance[v] == distance[w] - 1)
+						delta[v] += sigma[v] / sigma[w] * (1.0 + delta[w]);
+				}
+
+				centrality[w] += delta[w];
+			}
+
+			for (int v : order)
+				distance[v] = -1;
+		}
+
+		QMutexLocker lock(&mutex);
+
+		for (int v = 0; v < n; ++v)
+			result.betweenness[v] += centrality[v] * scale;
+	});
+}
+
+
+// local clustering coefficient of the simple undirected graph under the scene graph
+static void computeClustering(const CAdjacencySnapshot& g, QThreadPool& pool, const CGraphAnalytics::Options& options, CGraphAnalytics::Result& result)
+{
+	PERF_SCOPE("analytics.clustering");
+
+	const int n = g.nodeCount();
+	result.clustering.fill(0, n);
+
+	double *clustering = result.clustering.data();
+
+	parallelFor(pool, n, minChunkSize / 4, [&](int begin, int end)
+	{
+		// stamps instead of clearing: neighbor[x] == v means x is a neighbor of v
+		QVector<int> neighbor(n, -1), seen(n, -1);
+		QVector<int> neighbors;
+		int visit = 0;
+
+		for (int v = begin; v < end; ++v)
+		{
+			if ((v & 255) == 0 && isCanceled(options))
+				break;
+
+			neighbors.clear();
+
+			for (const auto& arc : g.allArcs(v))
+			{
+				if (arc.node != v && neighbor[arc.node] != v)
+				{
+					neighbor[arc.node] = v;
+					neighbors << arc.node;
+				}
+			}
+
+			const int k = neighbors.size();
+			if (k < 2)
+				continue;
+
+			// every link between the neighbors is met from both of its ends
+			qint64 links = 0;
+
+			for (int u : neighbors)
+			{
+				++visit;
+
+				for (const auto& arc : g.allArcs(u))
+				{
+					int w = arc.node;
+					if (w != u && w != v && neighbor[w] == v && seen[w] != visit)
+					{
+						seen[w] = visit;
+						links++;
+					}
+				}
+			}
+
+			clustering[v] = double(links) / (qint64(k) * (k - 1));
+		}
+	});
+}
+
+
+// public
+
+CGraphAnalytics::Result CGraphAnalytics::compute(const CAdjacencySnapshot& adjacency, int metrics, const Options& options)
+{
+	PERF_SCOPE("analytics.compute");
+
+	QThreadPool pool;
+	pool.setMaxThreadCount(options.threads > 0 ? options.threads : QThread::idealThreadCount());
+
+	Result result;
+	result.metrics = metrics;
+
+	if (metrics & Degree)
+		computeDegrees(adjacency, pool, result);
+
+	if (metrics & Components)
+		computeComponents(adjacency, result);
+
+	if ((metrics & PageRank) && !isCanceled(options))
+		computePageRank(adjacency, pool, options, result);
+
+	if ((metrics & Betweenness) && !isCanceled(options))
+		computeBetweenness(adjacency, pool, options, result);
+
+	if ((metrics & Clustering) && !isCanceled(options))
+		computeClustering(adjacency, pool, options, result);
+
+	result.canceled = isCanceled(options);
+
+	return result;
+}
+
+
+bool CGraphAnalytics::apply(const Result& result, const CAdjacencySnapshot& adjacency, CNodeEditorScene& scene)
+{
+	PERF_SCOPE("analytics.apply");
+
+	// the nodes could be gone
+	if (adjacency.revision() != scene.getTopologyRevision())
+		return false;
+
+	const int n = adjacency.nodeCount();
+
+	// class attributes first: the values are editable & usable by the styling
+	if (result.metrics & Degree)
+	{
+		scene.createClassAttribute("node", "degree", QObject::tr("Degree"), 0, ATTR_NONE);
+		scene.createClassAttribute("node", "indegree", QObject::tr("In-Degree"), 0, ATTR_NONE);
+		scene.createClassAttribute("node", "outdegree", QObject::tr("Out-Degree"), 0, ATTR_NONE);
+	}
+
+	if (result.metrics & Components)
+		scene.createClassAttribute("node", "component", QObject::tr("Component"), 0, ATTR_NONE);
+
+	if (result.metrics & PageRank)
+		scene.createClassAttribute("node", "pagerank", QObject::tr("PageRank"), 0.0, ATTR_NONE);
+
+	if (result.metrics & Betweenness)
+		scene.createClassAttribute("node", "betweenness", QObject::tr("Betweenness"), 0.0, ATTR_NONE);
+
+	if (result.metrics & Clustering)
+		scene.createClassAttribute("node", "clustering", QObject::tr("Clustering Coefficient"), 0.0, ATTR_NONE);
+
+	for (int v = 0; v < n; ++v)
+	{
+		CNode* node = adjacency.node(v);
+
+		if (result.degree.size() == n)
+		{
+			node->setAttribute("degree", result.degree[v]);
+			node->setAttribute("indegree", result.inDegree[v]);
+			node->setAttribute("outdegree", result.outDegree[v]);
+		}
+
+		if (result.component.size() == n)
+			node->setAttribute("component", result.component[v]);
+
+		if (result.pageRank.size() == n)
+			node->setAttribute("pagerank", result.pageRank[v]);
+
+		if (result.betweenness.size() == n)
+			node->setAttribute("betweenness", result.betweenness[v]);
+
+		if (result.clustering.size() == n)
+			node->setAttribute("clustering", result.clustering[v]);
+	}
+
+	// all the values in one step
+	scene.addUndoState();
+
+	return true;
+}
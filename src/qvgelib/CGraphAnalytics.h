@@ -0,0 +1,72 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#pragma once
+
+#include <QVector>
+#include <QByteArray>
+#include <QAtomicInt>
+
+class CAdjacencySnapshot;
+class CNodeEditorScene;
+
+
+// Node metrics of the scene graph computed over its adjacency snapshot on all the CPU cores.
+// compute() reads only the index arrays of the snapshot, so it may run on a worker thread;
+// apply() writes the results back as node attributes and must be called by the GUI thread.
+
+class CGraphAnalytics
+{
+public:
+	enum Metric
+	{
+		Degree = 1,				// "degree", "indegree", "outdegree"
+		Components = 2,			// "component": index of the weakly connected component
+		PageRank = 4,			// "pagerank"
+		Betweenness = 8,		// "betweenness": estimated from the sampled sources
+		Clustering = 16,		// "clustering": local clustering coefficient (directions ignored)
+		AllMetrics = 31
+	};
+
+	struct Options
+	{
+		double damping = 0.85;
+		int maxIterations = 100;
+		double tolerance = 1e-6;
+
+		// sources of the shortest paths for betweenness (all the nodes if there are less of them)
+		int betweennessSamples = 256;
+		quint32 seed = 1;
+
+		// 0: all the cores
+		int threads = 0;
+
+		// set to non-zero by another thread to stop the computation
+		const QAtomicInt *canceled = nullptr;
+	};
+
+	struct Result
+	{
+		int metrics = 0;
+		bool canceled = false;		// the values are incomplete then
+
+		QVector<int> degree, inDegree, outDegree;
+		QVector<int> component;
+		int componentCount = 0;
+		QVector<double> pageRank;
+		QVector<double> betweenness;
+		QVector<double> clustering;
+	};
+
+	static Result compute(const CAdjacencySnapshot& adjacency, int metrics, const Options& options);
+	static Result compute(const CAdjacencySnapshot& adjacency, int metrics) { return compute(adjacency, metrics, Options()); }
+
+	// sets the node attributes in one undoable step; false if the topology has changed since the snapshot
+	static bool apply(const Result& result, const CAdjacencySnapshot& adjacency, CNodeEditorScene& scene);
+};
@@ -16,7 +16,7 @@ CEdge* CGraphInterface::addEdge(const QString &edgeId, const QString &startNodeI
         return nullptr;
 
     // look for existing edge
-    if (m_scene->getItemsById<CEdge>(edgeId).count())
+    if (findEdge(edgeId))
         return nullptr;
 
     auto* edge = m_scene->createItemOfType<CDirectEdge>();
@@ -37,6 +37,9 @@ CEdge* CGraphInterface::addEdge(const QString &edgeId, const QString &startNodeI
 
 	m_scene->addItem(edge);
 
+	if (m_updating)
+		m_edgeIds[edgeId] = edge;
+
     return edge;
 }
 
@@ -47,7 +50,7 @@ CNode* CGraphInterface::addNode(const QString &nodeId)
         return nullptr;
 
     // look for existing node
-    if (m_scene->getItemsById<CNode>(nodeId).count())
+    if (findNode(nodeId))
         return nullptr;
 
     auto* node = m_scene->createItemOfType<CNode>();
@@ -58,6 +61,9 @@ CNode* CGraphInterface::addNode(const QString &nodeId)
 
 	m_scene->addItem(node);
 
+	if (m_updating)
+		m_nodeIds[nodeId] = node;
+
     return node;
 }
 
@@ -68,9 +74,8 @@ CNode* CGraphInterface::getNode(const QString &nodeId, bool autoCreate)
         return nullptr;
 
     // look for existing node
-    auto nodes = (m_scene->getItemsById<CNode>(nodeId));
-    if (nodes.count())
-        return nodes.first();
+    if (auto* node = findNode(nodeId))
+        return node;
 
     if (autoCreate)
     {
@@ -81,6 +86,9 @@ CNode* CGraphInterface::getNode(const QString &nodeId, bool autoCreate)
         node->setId(nodeId);
 
 		m_scene->addItem(node);
+
+		if (m_updating)
+			m_nodeIds[nodeId] = node;
 		
 		return node;
     }
@@ -95,11 +103,7 @@ CEdge* CGraphInterface::getEdge(const QString& edgeId)
 		return nullptr;
 
 	// look for existing edge
-	auto edges = (m_scene->getItemsById<CEdge>(edgeId));
-	if (edges.count())
-		return edges.first();
-
-	return nullptr;
+	return findEdge(edgeId);
 }
 
 
@@ -113,6 +117,58 @@ bool CGraphInterface::setEdgeAttr(const QString& edgeId, const QByteArray& attrI
 }
 
 
+bool CGraphInterface::setNodeAttr(const QString& nodeId, const QByteArray& attrId, const QVariant& value)
+{
+	CNode* node = getNode(nodeId);
+	if (node)
+		return node->setAttribute(attrId, value);
+	else
+		return false;
+}
+
+
+bool CGraphInterface::removeNode(const QString& nodeId)
+{
+	CNode* node = getNode(nodeId);
+	if (!node)
+		return false;
+
+	// an edge renamed since indexed would stay in the hash
+	bool reindex = false;
+
+	if (m_updating)
+	{
+		for (CEdge* edge : node->getConnections())
+			reindex |= (m_edgeIds.remove(edge->getId()) == 0);
+
+		m_nodeIds.remove(nodeId);
+	}
+
+	// the edges die with the node
+	delete node;
+
+	if (reindex)
+		indexItems();
+
+	return true;
+}
+
+
+bool CGraphInterface::removeEdge(const QString& edgeId)
+{
+	CEdge* edge = getEdge(edgeId);
+	if (!edge)
+		return false;
+
+	if (m_updating)
+		m_edgeIds.remove(edgeId);
+
+	delete edge;
+
+	return true;
+}
+
+
 QList<CEdge*> CGraphInterface::getEdges() const
 {
     QList<CEdge*> edges;
@@ -143,3 +199,93 @@ QList<CNode*> CGraphInterface::getNodes() const
 
     return nodes;
 }
+
+
+// batches
+
+void CGraphInterface::beginUpdate()
+{
+	if (m_scene == nullptr || m_updating)
+		return;
+
+	m_updating = true;
+
+	// the items have been added or removed by someone else
+	if (!m_indexValid || m_indexRevision != m_scene->getTopologyRevision())
+		indexItems();
+}
+
+
+void CGraphInterface::endUpdate()
+{
+	if (!m_updating)
+		return;
+
+	m_updating = false;
+
+	// the own changes only
+	m_indexRevision = m_scene->getTopologyRevision();
+
+	m_scene->invalidateState();
+	m_scene->needLabelsUpdate();
+}
+
+
+void CGraphInterface::indexItems()
+{
+	m_nodeIds.clear();
+	m_edgeIds.clear();
+
+	auto items = m_scene->items();
+	for (auto item: items)
+	{
+		if (auto node = dynamic_cast<CNode*>(item))
+			m_nodeIds[node->getId()] = node;
+		else if (auto edge = dynamic_cast<CEdge*>(item))
+			m_edgeIds[edge->getId()] = edge;
+	}
+
+	m_indexRevision = m_scene->getTopologyRevision();
+	m_indexValid = true;
+}
+
+
+CNode* CGraphInterface::findNode(const QString& nodeId)
+{
+	if (!m_updating)
+	{
+		auto nodes = (m_scene->getItemsById<CNode>(nodeId));
+		return nodes.count() ? nodes.first() : nullptr;
+	}
+
+	CNode* node = m_nodeIds.value(nodeId);
+
+	// renamed since indexed
+	if (node && node->getId() != nodeId)
+	{
+		indexItems();
+		node = m_nodeIds.value(nodeId);
+	}
+
+	return node;
+}
+
+
+CEdge* CGraphInterface::findEdge(const QString& edgeId)
+{
+	if (!m_updating)
+	{
+		auto edges = (m_scene->getItemsById<CEdge>(edgeId));
+		return edges.count() ? edges.first() : nullptr;
+	}
+
+	CEdge* edge = m_edgeIds.value(edgeId);
+
+	if (edge && edge->getId() != edgeId)
+	{
+		indexItems();
+		edge = m_edgeIds.value(edgeId);
+	}
+
+	return edge;
+}
@@ -3,6 +3,8 @@
 
 #include "IGraphInterface.h"
 
+#include <QHash>
+
 class CNodeEditorScene;
 
 
@@ -15,6 +17,7 @@ public:
 
     void setScene(CNodeEditorScene& scene) {
         m_scene = &scene;
+		m_indexValid = false;
     }
 
     // interface (to move out?)
@@ -24,12 +27,34 @@ public:
 	virtual CEdge* addEdge(const QString& edgeId, const QString& startNodeId, const QString& endNodeId);
 	virtual CEdge* getEdge(const QString& edgeId);
 	virtual bool setEdgeAttr(const QString& edgeId, const QByteArray& attrId, const QVariant& value);
+	virtual bool setNodeAttr(const QString& nodeId, const QByteArray& attrId, const QVariant& value);
+
+	// the edges of the node are removed as well
+	virtual bool removeNode(const QString& nodeId);
+	virtual bool removeEdge(const QString& edgeId);
 
     virtual QList<CEdge*> getEdges() const;
     virtual QList<CNode*> getNodes() const;
 
+	// batch of changes: the items are looked up by id in hashes instead of the scene,
+	// the labels are laid out once after endUpdate(). The hashes are kept between the batches
+	// while the topology of the scene is changed by the batches only.
+	void beginUpdate();
+	void endUpdate();
+	bool isUpdating() const { return m_updating; }
+
 private:
+	void indexItems();
+	CNode* findNode(const QString& nodeId);
+	CEdge* findEdge(const QString& edgeId);
+
     CNodeEditorScene *m_scene = nullptr;
+
+	bool m_updating = false;
+	quint64 m_indexRevision = 0;
+	bool m_indexValid = false;
+	QHash<QString, CNode*> m_nodeIds;
+	QHash<QString, CEdge*> m_edgeIds;
 };
 
 #endif // CGRAPHINTERFACE_H
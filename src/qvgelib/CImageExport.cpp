@@ -16,6 +16,7 @@ It can be used freely, maintaining the information above.
 #include <QScopedPointer>
 
 #include "CImageExport.h"
+#include "CPerfTrace.h"
 #include "CEditorScene.h"
 
 
@@ -88,6 +89,8 @@ QString CImageExport::filters() const
 
 bool CImageExport::save(const QString& fileName, CEditorScene& scene, QString* /*lastError*/) const
 {
+	PERF_SCOPE("io.image.export");
+
 	QScopedPointer<CEditorScene> tempScene(scene.clone());
 
 	if (m_cutContent)
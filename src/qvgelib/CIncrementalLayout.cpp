@@ -0,0 +1,342 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#include "CIncrementalLayout.h"
+#include "CEditorScene.h"
+#include "CNode.h"
+#include "CEdge.h"
+#include "CPerfTrace.h"
+
+#include <QHash>
+#include <QVector>
+#include <QPointF>
+#include <QRectF>
+#include <QLineF>
+#include <QGraphicsItem>
+#include <QtMath>
+
+#include <random>
+
+
+namespace
+{
+
+struct RegionNode
+{
+	CNode *node = nullptr;
+	QPointF pos;
+	QPointF origin;
+	QPointF disp;
+	int hop = 0;
+	bool dirty = false;
+};
+
+
+// uniform grid: neighbors of a point are in the 3x3 cells around it
+class SpatialGrid
+{
+public:
+	explicit SpatialGrid(double cellSize): m_cellSize(cellSize) {}
+
+	void clear() { m_cells.clear(); }
+
+	void insert(const QPointF& pos, int index)
+	{
+		m_cells[key(cellX(pos), cellY(pos))].append(index);
+	}
+
+	template<class Visitor>
+	void visitNear(const QPointF& pos, Visitor visitor) const
+	{
+		int cx = cellX(pos), cy = cellY(pos);
+
+		for (int x = cx - 1; x <= cx + 1; ++x)
+			for (int y = cy - 1; y <= cy + 1; ++y)
+			{
+				auto it = m_cells.constFind(key(x, y));
+				if (it != m_cells.constEnd())
+				{
+					for (int index : it.value())
+						visitor(index);
+				}
+			}
+	}
+
+private:
+	int cellX(const QPointF& pos) const { return qFloor(pos.x() / m_cellSize); }
+	int cellY(const QPointF& pos) const { return qFloor(pos.y() / m_cellSize); }
+
+	static quint64 key(int x, int y)
+	{
+		return (quint64(quint32(x)) << 32) | quint32(y);
+	}
+
+	double m_cellSize;
+	QHash<quint64, QVector<int>> m_cells;
+};
+
+
+CNode* otherNode(const CEdge* edge, const CNode* node)
+{
+	CNode* other = (edge->firstNode() == node) ? edge->lastNode() : edge->firstNode();
+	return (other == node) ? nullptr : other;
+}
+
+}	// namespace
+
+
+int CIncrementalLayout::run(const QSet<CNode*>& dirtyNodes, CEditorScene& scene, const Options& options)
+{
+	PERF_SCOPE("layout.incremental");
+
+	if (dirtyNodes.isEmpty())
+		return 0;
+
+	// region: dirty nodes + their neighborhood (breadth first)
+	QVector<RegionNode> region;
+	QHash<CNode*, int> regionIndex;
+
+	for (CNode* node : dirtyNodes)
+	{
+		RegionNode rn;
+		rn.node = node;
+		rn.pos = rn.origin = node->pos();
+		rn.dirty = true;
+
+		regionIndex[node] = region.size();
+		region.append(rn);
+	}
+
+	int hops = options.pinNeighborhood ? 0 : qMax(0, options.hops);
+
+	for (int i = 0; i < region.size(); ++i)
+	{
+		if (region[i].hop >= hops)
+			continue;
+
+		CNode *node = region[i].node;
+		int hop = region[i].hop + 1;
+
+		for (const CEdge* edge : node->getConnections())
+		{
+			CNode *other = otherNode(edge, node);
+			if (!other || regionIndex.contains(other))
+				continue;
+
+			RegionNode rn;
+			rn.node = other;
+			rn.pos = rn.origin = other->pos();
+			rn.hop = hop;
+
+			regionIndex[other] = region.size();
+			region.append(rn);
+		}
+	}
+
+	// ideal edge length: as in the existing layout around
+	double length = options.edgeLength;
+	if (length <= 0)
+	{
+		double sum = 0, sizeSum = 0;
+		int count = 0;
+
+		for (const RegionNode& rn : region)
+		{
+			sizeSum += rn.node->getSize().width() + rn.node->getSize().height();
+
+			if (rn.dirty)
+				continue;
+
+			for (const CEdge* edge : rn.node->getConnections())
+			{
+				CNode *other = otherNode(edge, rn.node);
+				if (other && !dirtyNodes.contains(other))
+				{
+					sum += QLineF(rn.node->pos(), other->pos()).length();
+					count++;
+				}
+			}
+		}
+
+		length = count ? sum / count : 0;
+
+		// nothing laid out yet: by the node size
+		if (length < 1)
+			length = qMax(50.0, sizeSum / region.size() * 1.5);
+	}
+
+	// dirty nodes start between their placed neighbors, going outwards from the placed part
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<double> angleDist(0, 2 * M_PI);
+
+	QVector<int> pending;
+	for (int i = 0; i < region.size(); ++i)
+	{
+		if (region[i].dirty)
+			pending << i;
+	}
+
+	QVector<bool> placed(region.size());
+	for (int i = 0; i < region.size(); ++i)
+		placed[i] = !region[i].dirty;
+
+	bool progress = true;
+	while (progress && pending.size())
+	{
+		progress = false;
+		QVector<int> left;
+
+		for (int i : pending)
+		{
+			RegionNode& rn = region[i];
+
+			QPointF center;
+			int count = 0;
+
+			for (const CEdge* edge : rn.node->getConnections())
+			{
+				CNode *other = otherNode(edge, rn.node);
+				if (!other)
+					continue;
+
+				int j = regionIndex.value(other, -1);
+				if (j < 0)
+				{
+					center += other->pos();
+					count++;
+				}
+				else if (placed[j])
+				{
+					center += region[j].pos;
+					count++;
+				}
+			}
+
+			if (count == 0)
+			{
+				left << i;
+				continue;
+			}
+
+			double angle = angleDist(rng);
+			rn.pos = center / count + QPointF(qCos(angle), qSin(angle)) * length * 0.5;
+			placed[i] = true;
+			progress = true;
+		}
+
+		pending = left;
+	}
+
+	// the rest of the graph around the region repels it
+	QRectF bounds;
+	for (const RegionNode& rn : region)
+		bounds |= QRectF(rn.pos, QSizeF(1, 1));
+	bounds.adjust(-2 * length, -2 * length, 2 * length, 2 * length);
+
+	QVector<QPointF> fixedPoints;
+	SpatialGrid fixedGrid(2 * length);
+
+	for (QGraphicsItem* item : scene.items(bounds))
+	{
+		CNode *node = dynamic_cast<CNode*>(item);
+		if (node && !regionIndex.contains(node))
+		{
+			fixedGrid.insert(node->pos(), fixedPoints.size());
+			fixedPoints << node->pos();
+		}
+	}
+
+	// force-directed iterations over the region only
+	SpatialGrid movingGrid(2 * length);
+	const double maxDistance = 2 * length;
+	const double minDistance = 0.01 * length;
+	const int iterations = qMax(1, options.iterations);
+
+	double temperature = length;
+	const double cooling = temperature / iterations;
+
+	auto repulse = [&](RegionNode& rn, const QPointF& from)
+	{
+		QPointF delta = rn.pos - from;
+		double d = qMax(minDistance, qSqrt(delta.x() * delta.x() + delta.y() * delta.y()));
+		if (d < maxDistance)
+		{
+			// coincident points: push in some direction
+			if (delta.isNull())
+				delta = QPointF(minDistance, 0);
+
+			rn.disp += delta / d * (length * length / d);
+		}
+	};
+
+	for (int iteration = 0; iteration < iterations; ++iteration)
+	{
+		movingGrid.clear();
+		for (int i = 0; i < region.size(); ++i)
+			movingGrid.insert(region[i].pos, i);
+
+		for (int i = 0; i < region.size(); ++i)
+		{
+			RegionNode& rn = region[i];
+			rn.disp = QPointF();
+
+			movingGrid.visitNear(rn.pos, [&](int j)
+			{
+				if (j != i)
+					repulse(rn, region[j].pos);
+			});
+
+			fixedGrid.visitNear(rn.pos, [&](int j)
+			{
+				repulse(rn, fixedPoints[j]);
+			});
+
+			// edges pull to the neighbors (inside & outside of the region)
+			for (const CEdge* edge : rn.node->getConnections())
+			{
+				CNode *other = otherNode(edge, rn.node);
+				if (!other)
+					continue;
+
+				int j = regionIndex.value(other, -1);
+				QPointF delta = ((j < 0) ? other->pos() : region[j].pos) - rn.pos;
+				double d = qSqrt(delta.x() * delta.x() + delta.y() * delta.y());
+				if (d > minDistance)
+					rn.disp += delta / d * (d * d / length);
+			}
+
+			// old positions hold the neighborhood
+			if (!rn.dirty && hops > 0)
+				rn.disp += (rn.origin - rn.pos) * (options.anchorStrength * rn.hop / hops);
+		}
+
+		for (RegionNode& rn : region)
+		{
+			double d = qSqrt(rn.disp.x() * rn.disp.x() + rn.disp.y() * rn.disp.y());
+			if (d > 0)
+				rn.pos += rn.disp / d * qMin(d, temperature);
+		}
+
+		temperature = qMax(temperature - cooling, length * 0.01);
+	}
+
+	// apply
+	int moved = 0;
+
+	for (const RegionNode& rn : region)
+	{
+		if (rn.pos != rn.node->pos())
+		{
+			rn.node->setPos(rn.pos);
+			moved++;
+		}
+	}
+
+	return moved;
+}
@@ -0,0 +1,46 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#pragma once
+
+#include <QSet>
+
+class CEditorScene;
+class CNode;
+
+
+// Incremental force-directed layout: only the dirty nodes (new or chosen by the user) and their
+// neighborhood of some hops are moved, the rest of the graph stays where it is and holds the region.
+// The work is proportional to the size of the region, not of the graph.
+
+class CIncrementalLayout
+{
+public:
+	struct Options
+	{
+		// depth of the neighborhood around the dirty nodes
+		int hops = 2;
+
+		int iterations = 60;
+
+		// pull of the neighborhood nodes to their old positions (0: free);
+		// grows with the hop distance, so the outer hops hardly move
+		double anchorStrength = 0.5;
+
+		// neighborhood stays as it is, only the dirty nodes are moved
+		bool pinNeighborhood = false;
+
+		// ideal edge length, <= 0: taken from the existing layout
+		double edgeLength = 0;
+	};
+
+	// returns count of the moved nodes
+	static int run(const QSet<CNode*>& dirtyNodes, CEditorScene& scene, const Options& options);
+	static int run(const QSet<CNode*>& dirtyNodes, CEditorScene& scene) { return run(dirtyNodes, scene, Options()); }
+};
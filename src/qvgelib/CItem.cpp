@@ -16,11 +16,13 @@ It can be used freely, maintaining the information above.
 
 
 bool CItem::s_duringRestore = false;
+quint64 CItem::s_lastStoreId = 0;
 
 
 CItem::CItem()
 {
 	m_labelItem = NULL;
+	m_storeId = 0;
 
 	// default item flags
 	m_itemFlags = IF_DeleteAllowed | IF_FramelessSelection;
@@ -38,6 +40,25 @@ CItem::~CItem()
 
 // IO
 
+quint64 CItem::getStoreId() const
+{
+	// given on the first store
+	if (m_storeId == 0)
+		m_storeId = ++s_lastStoreId;
+
+	return m_storeId;
+}
+
+
+void CItem::setStoreId(quint64 id)
+{
+	m_storeId = id;
+
+	// the new items must not get it again
+	s_lastStoreId = qMax(s_lastStoreId, id);
+}
+
+
 bool CItem::storeTo(QDataStream &out, quint64 version64) const
 {
 	if (version64 >= 2)
@@ -119,6 +119,10 @@ public:
 		bool changeSize, bool changePos) {}
 
 	// serialization 
+	// key of the item in the stored states: kept when restored, so the states of a document stay comparable
+	quint64 getStoreId() const;
+	void setStoreId(quint64 id);
+
 	virtual bool storeTo(QDataStream& out, quint64 version64) const;
 	virtual bool restoreFrom(QDataStream& out, quint64 version64);
 
@@ -156,9 +160,13 @@ protected:
 	QMap<QByteArray, QVariant> m_attributes;
 	QString m_id;
 	QGraphicsSimpleTextItem *m_labelItem;
+	mutable quint64 m_storeId;
 
 	// restore optimization
 	static bool s_duringRestore;
+
+	// the last given store id
+	static quint64 s_lastStoreId;
 };
 
 
@@ -0,0 +1,213 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#include "CLayoutCache.h"
+#include "CEditorScene.h"
+#include "CNode.h"
+#include "CEdge.h"
+#include "CPolyEdge.h"
+#include "CPerfTrace.h"
+
+#include <QCryptographicHash>
+#include <QStandardPaths>
+#include <QSaveFile>
+#include <QFile>
+#include <QDir>
+#include <QFileInfo>
+#include <QDataStream>
+#include <QHash>
+#include <QVector>
+#include <QPointF>
+
+#include <algorithm>
+
+
+// file format
+static const quint32 cacheMagic = 0x51564c43;	// QVLC
+static const quint32 cacheVersion = 1;
+
+
+CLayoutCache::CLayoutCache(const QString& path):
+	m_path(path)
+{
+	if (m_path.isEmpty())
+		m_path = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/layouts";
+}
+
+
+void CLayoutCache::setMaxEntries(int count)
+{
+	m_maxEntries = qMax(1, count);
+}
+
+
+QByteArray CLayoutCache::topologyKey(const CEditorScene& scene, const QString& engine, const QString& parameters)
+{
+	PERF_SCOPE("layout.cache.key");
+
+	// canonical order: does not depend on the order of the items in the scene
+	QVector<QByteArray> nodeRecords;
+	for (const CNode* node : scene.getItems<CNode>())
+	{
+		QSizeF size = node->getSize();
+
+		nodeRecords << node->getId().toUtf8() + '\t'
+			+ QByteArray::number(size.width(), 'f', 2) + '\t'
+			+ QByteArray::number(size.height(), 'f', 2);
+	}
+
+	QVector<QByteArray> edgeRecords;
+	for (const CEdge* edge : scene.getItems<CEdge>())
+	{
+		if (!edge->firstNode() || !edge->lastNode())
+			continue;
+
+		edgeRecords << edge->getId().toUtf8() + '\t'
+			+ edge->firstNode()->getId().toUtf8() + '\t' + edge->firstPortId() + '\t'
+			+ edge->lastNode()->getId().toUtf8() + '\t' + edge->lastPortId();
+	}
+
+	std::sort(nodeRecords.begin(), nodeRecords.end());
+	std::sort(edgeRecords.begin(), edgeRecords.end());
+
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+
+	hash.addData(engine.toUtf8() + '\n' + parameters.toUtf8() + '\n');
+
+	for (const QByteArray& record : nodeRecords)
+	{
+		hash.addData(record);
+		hash.addData("\n", 1);
+	}
+
+	hash.addData("\n", 1);
+
+	for (const QByteArray& record : edgeRecords)
+	{
+		hash.addData(record);
+		hash.addData("\n", 1);
+	}
+
+	return hash.result().toHex();
+}
+
+
+QString CLayoutCache::entryFileName(const QByteArray& key) const
+{
+	return m_path + "/" + QString::fromLatin1(key) + ".layout";
+}
+
+
+bool CLayoutCache::restore(const QByteArray& key, CEditorScene& scene) const
+{
+	PERF_SCOPE("layout.cache.restore");
+
+	QFile file(entryFileName(key));
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+
+	QDataStream ds(&file);
+	ds.setVersion(QDataStream::Qt_5_6);
+
+	quint32 magic = 0, version = 0;
+	ds >> magic >> version;
+	if (magic != cacheMagic || version != cacheVersion)
+		return false;
+
+	QVector<QPair<QString, QPointF>> nodePositions;
+	QVector<QPair<QString, QList<QPointF>>> edgePoints;
+	ds >> nodePositions >> edgePoints;
+
+	if (ds.status() != QDataStream::Ok)
+		return false;
+
+	QHash<QString, CNode*> nodes;
+	for (CNode* node : scene.getItems<CNode>())
+		nodes[node->getId()] = node;
+
+	QHash<QString, CPolyEdge*> polyEdges;
+	for (CPolyEdge* edge : scene.getItems<CPolyEdge>())
+		polyEdges[edge->getId()] = edge;
+
+	// same key but other items: something is wrong with the entry
+	if (nodePositions.size() != nodes.size())
+		return false;
+
+	for (const auto& nodePos : nodePositions)
+	{
+		if (!nodes.contains(nodePos.first))
+			return false;
+	}
+
+	for (const auto& nodePos : nodePositions)
+		nodes[nodePos.first]->setPos(nodePos.second);
+
+	for (const auto& points : edgePoints)
+	{
+		if (CPolyEdge* edge = polyEdges.value(points.first))
+			edge->setPoints(points.second);
+	}
+
+	return true;
+}
+
+
+bool CLayoutCache::store(const QByteArray& key, const CEditorScene& scene) const
+{
+	PERF_SCOPE("layout.cache.store");
+
+	if (!QDir().mkpath(m_path))
+		return false;
+
+	QVector<QPair<QString, QPointF>> nodePositions;
+	for (const CNode* node : scene.getItems<CNode>())
+		nodePositions << qMakePair(node->getId(), node->pos());
+
+	QVector<QPair<QString, QList<QPointF>>> edgePoints;
+	for (const CPolyEdge* edge : scene.getItems<CPolyEdge>())
+	{
+		if (edge->getPoints().size())
+			edgePoints << qMakePair(edge->getId(), edge->getPoints());
+	}
+
+	QSaveFile file(entryFileName(key));
+	if (!file.open(QIODevice::WriteOnly))
+		return false;
+
+	QDataStream ds(&file);
+	ds.setVersion(QDataStream::Qt_5_6);
+	ds << cacheMagic << cacheVersion << nodePositions << edgePoints;
+
+	if (ds.status() != QDataStream::Ok || !file.commit())
+		return false;
+
+	prune();
+
+	return true;
+}
+
+
+void CLayoutCache::clear()
+{
+	QDir dir(m_path);
+	for (const QString& fileName : dir.entryList({ "*.layout" }, QDir::Files))
+		dir.remove(fileName);
+}
+
+
+void CLayoutCache::prune() const
+{
+	QDir dir(m_path);
+
+	// newest stored first
+	QFileInfoList entries = dir.entryInfoList({ "*.layout" }, QDir::Files, QDir::Time);
+
+	for (int i = m_maxEntries; i < entries.size(); ++i)
+		QFile::remove(entries.at(i).absoluteFilePath());
+}
@@ -0,0 +1,48 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#pragma once
+
+#include <QString>
+#include <QByteArray>
+
+class CEditorScene;
+
+
+// Persistent cache of layout results: the key is a hash of the graph topology (node ids & sizes, edges)
+// and of the layout engine with its parameters; the node positions and the edge points are stored.
+// Running the same layout on an unchanged graph replays the stored result instead of computing it again.
+
+class CLayoutCache
+{
+public:
+	// empty path: the user's cache directory
+	explicit CLayoutCache(const QString& path = QString());
+
+	const QString& path() const { return m_path; }
+
+	// oldest entries are removed above this count
+	void setMaxEntries(int count);
+	int maxEntries() const { return m_maxEntries; }
+
+	static QByteArray topologyKey(const CEditorScene& scene, const QString& engine, const QString& parameters = QString());
+
+	// true on hit: the stored layout has been applied to the scene
+	bool restore(const QByteArray& key, CEditorScene& scene) const;
+	bool store(const QByteArray& key, const CEditorScene& scene) const;
+
+	void clear();
+
+private:
+	QString entryFileName(const QByteArray& key) const;
+	void prune() const;
+
+	QString m_path;
+	int m_maxEntries = 200;
+};
@@ -0,0 +1,463 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#include "CLiveUpdateServer.h"
+#include "CNodeEditorScene.h"
+#include "CNode.h"
+#include "CEdge.h"
+#include "CPerfTrace.h"
+
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QJsonParseError>
+
+
+// period of the batches & GUI time per batch (ms)
+static const int frameTime = 16;
+static const int batchTime = 10;
+
+// pause of the stream before the undo state is added (ms)
+static const int idleTime = 1000;
+
+// the scene rect follows the content with this period (ms)
+static const int sceneRectTime = 500;
+
+// the clients are not read while so many operations are queued (the writers get blocked)
+static const int maxPending = 1 << 20;
+
+// a longer line drops the client
+static const int maxLineSize = 64 << 20;
+
+// data of a client buffered by the socket: the rest stays in the pipe and blocks the writer
+static const int readBufferSize = 1 << 20;
+
+
+CLiveUpdateServer::CLiveUpdateServer(CNodeEditorScene& scene, QObject* parent):
+	QObject(parent),
+	m_scene(&scene),
+	m_graph(scene),
+	m_server(new QLocalServer(this))
+{
+	// the other users may not edit the document
+	m_server->setSocketOptions(QLocalServer::UserAccessOption);
+
+	connect(m_server, &QLocalServer::newConnection, this, &CLiveUpdateServer::onNewConnection);
+
+	m_frameTimer.setInterval(frameTime);
+	connect(&m_frameTimer, &QTimer::timeout, this, &CLiveUpdateServer::onFrame);
+
+	m_idleTimer.setSingleShot(true);
+	m_idleTimer.setInterval(idleTime);
+	connect(&m_idleTimer, &QTimer::timeout, this, &CLiveUpdateServer::onIdle);
+
+	m_sceneRectTimer.start();
+}
+
+
+CLiveUpdateServer::~CLiveUpdateServer()
+{
+	stop();
+}
+
+
+bool CLiveUpdateServer::start(const QString& name, QString* lastError)
+{
+	stop();
+
+	if (m_server->listen(name))
+		return true;
+
+	// a stale socket of a crashed instance is removed, a living one is kept
+	if (m_server->serverError() == QAbstractSocket::AddressInUseError)
+	{
+		QLocalSocket probe;
+		probe.connectToServer(name);
+
+		if (!probe.waitForConnected(100))
+		{
+			QLocalServer::removeServer(name);
+
+			if (m_server->listen(name))
+				return true;
+		}
+	}
+
+	if (lastError)
+		*lastError = m_server->errorString();
+
+	return false;
+}
+
+
+void CLiveUpdateServer::stop()
+{
+	m_server->close();
+
+	if (m_buffers.isEmpty())
+		return;
+
+	for (QLocalSocket* socket : m_buffers.keys())
+	{
+		socket->disconnect(this);
+		socket->abort();
+		socket->deleteLater();
+	}
+
+	m_buffers.clear();
+
+	Q_EMIT clientsChanged(0);
+}
+
+
+bool CLiveUpdateServer::isListening() const
+{
+	return m_server->isListening();
+}
+
+
+QString CLiveUpdateServer::serverName() const
+{
+	return m_server->fullServerName();
+}
+
+
+void CLiveUpdateServer::setPaused(bool on)
+{
+	m_paused = on;
+
+	if (m_paused)
+		m_frameTimer.stop();
+	else if (pendingCount())
+		m_frameTimer.start();
+}
+
+
+// clients
+
+void CLiveUpdateServer::onNewConnection()
+{
+	while (QLocalSocket* socket = m_server->nextPendingConnection())
+	{
+		m_buffers[socket];
+
+		socket->setReadBufferSize(readBufferSize);
+
+		connect(socket, &QLocalSocket::readyRead, this, &CLiveUpdateServer::onReadyRead);
+		connect(socket, &QLocalSocket::disconnected, this, &CLiveUpdateServer::onDisconnected);
+
+		Q_EMIT clientsChanged(m_buffers.size());
+
+		if (socket->bytesAvailable())
+			readClient(socket, false);
+	}
+}
+
+
+void CLiveUpdateServer::onReadyRead()
+{
+	if (QLocalSocket* socket = qobject_cast<QLocalSocket*>(sender()))
+		readClient(socket, false);
+}
+
+
+void CLiveUpdateServer::onDisconnected()
+{
+	QLocalSocket* socket = qobject_cast<QLocalSocket*>(sender());
+	if (!socket || !m_buffers.contains(socket))
+		return;
+
+	// the rest of the data, the last line may be not terminated
+	readClient(socket, true);
+
+	QByteArray tail = m_buffers.take(socket).trimmed();
+	if (!tail.isEmpty())
+	{
+		QString lastError;
+		if (!parseLine(tail, &lastError))
+			Q_EMIT protocolError(lastError);
+	}
+
+	socket->disconnect(this);
+	socket->deleteLater();
+
+	if (pendingCount() && !m_paused && !m_frameTimer.isActive())
+		m_frameTimer.start();
+
+	Q_EMIT clientsChanged(m_buffers.size());
+}
+
+
+void CLiveUpdateServer::readClient(QLocalSocket* socket, bool all)
+{
+	PERF_SCOPE("live.read");
+
+	QByteArray& buffer = m_buffers[socket];
+
+	while (socket->bytesAvailable() > 0 && (all || pendingCount() < maxPending))
+	{
+		buffer += socket->read(qMin<qint64>(socket->bytesAvailable(), readBufferSize));
+
+		// complete lines only
+		int start = 0;
+		for (int end = buffer.indexOf('\n'); end >= 0; end = buffer.indexOf('\n', start))
+		{
+			QByteArray line = buffer.mid(start, end - start).trimmed();
+			start = end + 1;
+
+			if (line.isEmpty())
+				continue;
+
+			QString lastError;
+			if (!parseLine(line, &lastError))
+				Q_EMIT protocolError(lastError);
+		}
+
+		buffer.remove(0, start);
+
+		if (buffer.size() > maxLineSize)
+		{
+			Q_EMIT protocolError(tr("Line is too long, the client is dropped"));
+
+			buffer.clear();
+			socket->abort();
+			return;
+		}
+	}
+
+	if (pendingCount() && !m_paused && !m_frameTimer.isActive())
+		m_frameTimer.start();
+}
+
+
+// protocol
+
+bool CLiveUpdateServer::parseLine(const QByteArray& line, QString* lastError)
+{
+	QJsonParseError parseError;
+	QJsonDocument doc = QJsonDocument::fromJson(line, &parseError);
+
+	if (doc.isNull())
+	{
+		*lastError = tr("Invalid JSON: %1").arg(parseError.errorString());
+		return false;
+	}
+
+	if (doc.isObject())
+		return parseOperation(doc.object(), lastError);
+
+	// the rest of the array is skipped after an error
+	const QJsonArray operations = doc.array();
+	for (const QJsonValue& value : operations)
+	{
+		if (!parseOperation(value.toObject(), lastError))
+			return false;
+	}
+
+	return true;
+}
+
+
+bool CLiveUpdateServer::parseOperation(const QJsonObject& json, QString* lastError)
+{
+	Operation op;
+
+	const QString name = json.value("op").toString();
+
+	if (name == "add-node")
+		op.type = AddNode;
+	else if (name == "add-edge")
+		op.type = AddEdge;
+	else if (name == "set-node")
+		op.type = SetNode;
+	else if (name == "set-edge")
+		op.type = SetEdge;
+	else if (name == "remove-node")
+		op.type = RemoveNode;
+	else if (name == "remove-edge")
+		op.type = RemoveEdge;
+	else
+	{
+		*lastError = tr("Unknown operation: \"%1\"").arg(name);
+		return false;
+	}
+
+	// numbers are fine as ids too
+	op.id = json.value("id").toVariant().toString();
+	if (op.id.isEmpty())
+	{
+		*lastError = tr("Operation \"%1\" without id").arg(name);
+		return false;
+	}
+
+	if (op.type == AddEdge)
+	{
+		op.source = json.value("source").toVariant().toString();
+		op.target = json.value("target").toVariant().toString();
+
+		if (op.source.isEmpty() || op.target.isEmpty())
+		{
+			*lastError = tr("Edge \"%1\" without source or target").arg(op.id);
+			return false;
+		}
+	}
+
+	op.attrs = json.value("attrs").toObject().toVariantMap();
+
+	m_pending << op;
+
+	return true;
+}
+
+
+// batches
+
+bool CLiveUpdateServer::apply(const Operation& op)
+{
+	CItem* item = nullptr;
+
+	switch (op.type)
+	{
+	case AddNode:
+		item = m_graph.getNode(op.id, true);
+		break;
+
+	case SetNode:
+		item = m_graph.getNode(op.id);
+		break;
+
+	case AddEdge:
+		item = m_graph.getEdge(op.id);
+		if (!item)
+			item = m_graph.addEdge(op.id, op.source, op.target);
+		break;
+
+	case SetEdge:
+		item = m_graph.getEdge(op.id);
+		break;
+
+	case RemoveNode:
+		return m_graph.removeNode(op.id);
+
+	case RemoveEdge:
+		return m_graph.removeEdge(op.id);
+	}
+
+	if (!item)
+		return false;
+
+	for (auto it = op.attrs.constBegin(); it != op.attrs.constEnd(); ++it)
+	{
+		// renaming would break the id lookup
+		if (it.key() != "id")
+			item->setAttribute(it.key().toUtf8(), it.value());
+	}
+
+	return true;
+}
+
+
+void CLiveUpdateServer::onFrame()
+{
+	if (pendingCount() == 0 || m_paused)
+	{
+		m_frameTimer.stop();
+		return;
+	}
+
+	// created in slices by a generator: wait for the whole graph
+	if (m_scene->isBuildingFromGraph())
+		return;
+
+	PERF_SCOPE("live.batch");
+
+	QElapsedTimer timer;
+	timer.start();
+
+	int count = 0, failed = 0;
+	bool added = false;
+
+	m_graph.beginUpdate();
+
+	while (m_pendingHead < m_pending.size())
+	{
+		const Operation& op = m_pending.at(m_pendingHead++);
+
+		added |= (op.type == AddNode || op.type == AddEdge);
+
+		if (!apply(op))
+			failed++;
+
+		if ((++count & 255) == 0 && timer.elapsed() >= batchTime)
+			break;
+	}
+
+	// labels & repaint once
+	m_graph.endUpdate();
+
+	// drop the applied operations
+	if (m_pendingHead == m_pending.size())
+	{
+		m_pending.clear();
+		m_pendingHead = 0;
+	}
+	else if (m_pendingHead > m_pending.size() / 2)
+	{
+		m_pending.remove(0, m_pendingHead);
+		m_pendingHead = 0;
+	}
+
+	if (added && m_sceneRectTimer.elapsed() > sceneRectTime)
+	{
+		m_scene->setSceneRect(m_scene->sceneRect().united(m_scene->itemsBoundingRect()));
+		m_sceneRectTimer.start();
+	}
+
+	m_applied += count;
+	m_changed = true;
+	m_idleTimer.start();
+
+	if (failed)
+		Q_EMIT protocolError(tr("%1 operation(s) refer to missing items").arg(failed));
+
+	Q_EMIT applied(count);
+
+	// resume the clients blocked by the queue
+	if (pendingCount() < maxPending / 2)
+	{
+		for (QLocalSocket* socket : m_buffers.keys())
+		{
+			if (m_buffers.contains(socket) && socket->bytesAvailable())
+				readClient(socket, false);
+		}
+	}
+
+	if (pendingCount() == 0)
+		m_frameTimer.stop();
+}
+
+
+void CLiveUpdateServer::onIdle()
+{
+	if (!m_changed || m_paused)
+		return;
+
+	if (m_scene->isBuildingFromGraph())
+	{
+		m_idleTimer.start();
+		return;
+	}
+
+	m_changed = false;
+
+	// all the changes since the last pause in one step
+	m_scene->addUndoState();
+}
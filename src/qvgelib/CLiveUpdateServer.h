@@ -0,0 +1,105 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QVector>
+#include <QHash>
+#include <QVariantMap>
+
+#include "CGraphInterface.h"
+
+class QLocalServer;
+class QLocalSocket;
+class QJsonObject;
+class CNodeEditorScene;
+
+
+// Live updates of the scene from the other processes over a local socket (named pipe on Windows).
+// Every line sent by a client is a JSON operation object or an array of them:
+//   {"op": "add-node", "id": "n1", "attrs": {"x": 10, "y": 20, "color": "#ff0000"}}
+//   {"op": "add-edge", "id": "e1", "source": "n1", "target": "n2", "attrs": {...}}
+//   {"op": "set-node", "id": "n1", "attrs": {...}}		(also "set-edge")
+//   {"op": "remove-node", "id": "n1"}					(also "remove-edge")
+// Adding an existing item sets its attributes; the missing end nodes of an edge are created.
+// The operations are queued and applied by the GUI thread in one batch per frame, so the labels
+// are laid out and the view is repainted once per frame; one undo state is added when the stream pauses.
+
+class CLiveUpdateServer : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit CLiveUpdateServer(CNodeEditorScene& scene, QObject* parent = nullptr);
+	virtual ~CLiveUpdateServer();
+
+	bool start(const QString& name, QString* lastError = nullptr);
+	// the operations received so far are still applied
+	void stop();
+
+	bool isListening() const;
+	QString serverName() const;
+
+	// the operations are queued but not applied while paused (i.e. while the document is loading)
+	void setPaused(bool on);
+	bool isPaused() const		{ return m_paused; }
+
+	int clientCount() const		{ return m_buffers.size(); }
+	int pendingCount() const	{ return m_pending.size() - m_pendingHead; }
+	qint64 appliedCount() const	{ return m_applied; }
+
+Q_SIGNALS:
+	void clientsChanged(int count);
+	// after every batch
+	void applied(int count);
+	// the line is skipped
+	void protocolError(const QString& message);
+
+private Q_SLOTS:
+	void onNewConnection();
+	void onReadyRead();
+	void onDisconnected();
+	void onFrame();
+	void onIdle();
+
+private:
+	enum OperationType { AddNode, AddEdge, SetNode, SetEdge, RemoveNode, RemoveEdge };
+
+	struct Operation
+	{
+		OperationType type = AddNode;
+		QString id, source, target;
+		QVariantMap attrs;
+	};
+
+	void readClient(QLocalSocket* socket, bool all);
+	bool parseLine(const QByteArray& line, QString* lastError);
+	bool parseOperation(const QJsonObject& json, QString* lastError);
+	bool apply(const Operation& op);
+
+	CNodeEditorScene *m_scene;
+	CGraphInterface m_graph;
+	QLocalServer *m_server;
+
+	// incomplete lines of the clients
+	QHash<QLocalSocket*, QByteArray> m_buffers;
+
+	QVector<Operation> m_pending;
+	int m_pendingHead = 0;
+
+	QTimer m_frameTimer, m_idleTimer;
+	QElapsedTimer m_sceneRectTimer;
+
+	qint64 m_applied = 0;
+	bool m_changed = false;		// since the last undo state
+	bool m_paused = false;
+};
@@ -2,6 +2,7 @@
 #include "CEdge.h"
 #include "CDirectEdge.h"
 #include "CEditorSceneDefines.h"
+#include "CPerfTrace.h"
 
 #include <QPen>
 #include <QBrush>
@@ -13,6 +14,10 @@
 // test
 #include <QGraphicsDropShadowEffect>
 
+
+static CPerfCounter paintedNodesCounter("paint.nodes");
+
+
 ////////////////////////////////////////////////////////////////////
 /// \brief CNode::CNode
 
@@ -640,6 +645,9 @@ void CNode::onConnectionAttach(CEdge *conn)
 
 	m_connections.insert(conn);
 
+	if (auto scene = getScene())
+		scene->invalidateTopology();
+
 	updateConnections();
 }
 
@@ -653,6 +661,9 @@ void CNode::onConnectionDetach(CEdge *conn)
 
 	m_connections.remove(conn);
 
+	if (auto scene = getScene())
+		scene->invalidateTopology();
+
 	updateConnections();
 }
 
@@ -815,8 +826,24 @@ ItemDragTestResult CNode::acceptDragFromItem(QGraphicsItem* draggedItem)
 
 QVariant CNode::itemChange(QGraphicsItem::GraphicsItemChange change, const QVariant &value)
 {
+	// leaves the old scene
+	if (change == ItemSceneChange)
+	{
+		if (auto scene = getScene())
+			scene->invalidateTopology();
+	}
+
 	if (change == ItemSceneHasChanged)
 	{
+		if (auto scene = getScene())
+		{
+			scene->invalidateTopology();
+
+			// restored states are not new
+			if (!s_duringRestore)
+				scene->onItemAdded(this);
+		}
+
 		// set default ID
 		setDefaultId();
 
@@ -849,6 +876,8 @@ QVariant CNode::itemChange(QGraphicsItem::GraphicsItemChange change, const QVari
 
 void CNode::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget*)
 {
+	PERF_COUNT(paintedNodesCounter, 1);
+
 	bool isSelected = (option->state & QStyle::State_Selected);
 
 	painter->setClipRect(boundingRect());
@@ -8,8 +8,10 @@
 #include "CControlPoint.h"
 #include "CEditorSceneDefines.h"
 #include "CEditorScene_p.h"
+#include "CPerfTrace.h"
 
 #include <qvgeio/CGraphBase.h>
+#include <qvgeio/CGraphDiff.h>
 
 #include <QGraphicsView>
 #include <QGraphicsSceneMouseEvent>
@@ -43,10 +45,114 @@ CNodeEditorScene::CNodeEditorScene(QObject *parent) :
 
 
 bool CNodeEditorScene::fromGraph(const Graph& g)
+{
+	PERF_SCOPE("scene.fromGraph");
+
+	beginFromGraph(g);
+	continueFromGraph(g.nodes.size() + g.edges.size());
+	finishFromGraph();
+
+	return true;
+}
+
+
+void CNodeEditorScene::beginFromGraph(const Graph& g)
 {
 	reset();
 
-	
+	m_buildGraph = &g;
+	m_buildNodes.clear();
+	m_buildNodes.reserve(g.nodes.size());
+	m_buildIndex = 0;
+
+	addClassAttributesFromGraph(g);
+}
+
+
+int CNodeEditorScene::continueFromGraph(int maxItems)
+{
+	Q_ASSERT(m_buildGraph);
+
+	PERF_SCOPE("scene.fromGraph.batch");
+
+	const Graph& g = *m_buildGraph;
+	const int nodesCount = g.nodes.size();
+	const int itemsCount = nodesCount + g.edges.size();
+
+	int lastIndex = qMin(itemsCount, m_buildIndex + qMax(1, maxItems));
+
+	// Nodes
+	for (; m_buildIndex < qMin(lastIndex, nodesCount); ++m_buildIndex)
+	{
+		const Node& n = g.nodes.at(m_buildIndex);
+
+		m_buildNodes[n.id] = addNodeFromGraph(n);
+	}
+
+
+	// Edges
+	for (; m_buildIndex < lastIndex; ++m_buildIndex)
+	{
+		const Edge& e = g.edges.at(m_buildIndex - nodesCount);
+
+		addEdgeFromGraph(e, m_buildNodes.value(e.startNodeId), m_buildNodes.value(e.endNodeId));
+	}
+
+	return itemsCount - m_buildIndex;
+}
+
+
+CNode* CNodeEditorScene::addNodeFromGraph(const Node& n)
+{
+	CNode* node = createNewNode();
+	addItem(node);
+
+	node->setId(n.id);
+
+	for (auto it = n.attrs.constBegin(); it != n.attrs.constEnd(); ++it)
+	{
+		node->setAttribute(it.key(), it.value());
+	}
+
+	for (auto it = n.ports.constBegin(); it != n.ports.constEnd(); ++it)
+	{
+		CNodePort* port = node->addPort(it.key().toLatin1(), it.value().anchor, it.value().x, it.value().y);
+		Q_ASSERT(port != nullptr);
+		port->setColor(it.value().color);
+	}
+
+	return node;
+}
+
+
+CEdge* CNodeEditorScene::addEdgeFromGraph(const Edge& e, CNode* startNode, CNode* endNode)
+{
+	bool isPolyEdge = e.attrs.contains("points");
+	CPolyEdge* polyEdge = isPolyEdge ? new CPolyEdge : nullptr;
+	if (polyEdge)
+	{
+		QString pointStr = e.attrs["points"].toString();
+		polyEdge->setPoints(CUtils::pointsFromString(pointStr));
+	}
+
+	CEdge* edge = polyEdge ? polyEdge : new CDirectEdge;
+	addItem(edge);
+
+	edge->setId(e.id);
+	edge->setFirstNode(startNode, e.startPortId);
+	edge->setLastNode(endNode, e.endPortId);
+
+	for (auto it = e.attrs.constBegin(); it != e.attrs.constEnd(); ++it)
+	{
+		edge->setAttribute(it.key(), it.value());
+	}
+
+	return edge;
+}
+
+
+void CNodeEditorScene::addClassAttributesFromGraph(const Graph& g)
+{
 	// Graph attrs
 	for (const auto& attr : g.graphAttrs)
 	{
@@ -97,68 +203,124 @@ bool CNodeEditorScene::fromGraph(const Graph& g)
 
 		createClassAttribute("edge", attr.id, attr.name, attr.defaultValue, ATTR_NONE);
 	}
+}
 
 
-	// Nodes
-	QMap<QByteArray, CNode*> nodesMap;
+void CNodeEditorScene::finishFromGraph()
+{
+	m_buildGraph = nullptr;
+	m_buildNodes.clear();
+	m_buildIndex = 0;
+
+	setSceneRect(itemsBoundingRect());
+
+	addUndoState();
+}
+
+
+void CNodeEditorScene::abortFromGraph()
+{
+	m_buildGraph = nullptr;
+	m_buildNodes.clear();
+	m_buildIndex = 0;
+
+	reset();
+}
+
 
-	for (const Node& n : g.nodes)
+void CNodeEditorScene::updateFromGraph(const Graph& g, const CGraphDiff& diff)
+{
+	PERF_SCOPE("scene.updateFromGraph");
+
+	// the ids as given by toGraph()
+	QHash<QByteArray, CNode*> nodes;
+	for (CNode* node : getItems<CNode>())
+		nodes.insert(node->getId().toUtf8(), node);
+
+	QHash<QByteArray, CEdge*> edges;
+	for (CEdge* edge : getItems<CEdge>())
+		edges.insert(edge->getId().toUtf8(), edge);
+
+	addClassAttributesFromGraph(g);
+
+	// edges first: the removed nodes delete the rest of theirs
+	for (const QByteArray& id : diff.removedEdges)
+		delete edges.take(id);
+
+	for (const QByteArray& id : diff.removedNodes)
 	{
-		CNode* node = createNewNode();
-		addItem(node);
+		CNode* node = nodes.take(id);
+		if (!node)
+			continue;
 
-		node->setId(n.id);
-		nodesMap[n.id] = node;
+		for (CEdge* edge : node->getConnections())
+			edges.remove(edge->getId().toUtf8());
 
-		for (auto it = n.attrs.constBegin(); it != n.attrs.constEnd(); ++it)
-		{
-			node->setAttribute(it.key(), it.value());
-		}
+		delete node;
+	}
 
-		for (auto it = n.ports.constBegin(); it != n.ports.constEnd(); ++it)
-		{
-			CNodePort* port = node->addPort(it.key().toLatin1(), it.value().anchor, it.value().x, it.value().y);
-			Q_ASSERT(port != nullptr);
-			port->setColor(it.value().color);
-		}
+	// nodes
+	for (int index : diff.addedNodes)
+	{
+		const Node& n = g.nodes.at(index);
+		nodes[n.id] = addNodeFromGraph(n);
 	}
 
+	for (const CGraphDiff::Change& change : diff.changedNodes)
+	{
+		CNode* node = nodes.value(change.id);
+		if (!node)
+			continue;
 
-	// Edges
-	for (const Edge& e : g.edges)
+		for (auto it = change.set.constBegin(); it != change.set.constEnd(); ++it)
+			node->setAttribute(it.key(), it.value());
+
+		for (const QByteArray& attrId : change.removed)
+			node->removeAttribute(attrId);
+	}
+
+	// edges
+	for (int index : diff.addedEdges)
 	{
-		bool isPolyEdge = e.attrs.contains("points");
-		CPolyEdge* polyEdge = isPolyEdge ? new CPolyEdge : nullptr;
-		if (polyEdge)
-		{
-			QString pointStr = e.attrs["points"].toString();
-			polyEdge->setPoints(CUtils::pointsFromString(pointStr));
-		}
+		const Edge& e = g.edges.at(index);
 
-		CEdge* edge = polyEdge ? polyEdge : new CDirectEdge;
-		addItem(edge);
+		// the ends could be missing in the file
+		CNode* startNode = nodes.value(e.startNodeId);
+		CNode* endNode = nodes.value(e.endNodeId);
+		if (startNode && endNode)
+			edges[e.id] = addEdgeFromGraph(e, startNode, endNode);
+	}
 
-		edge->setId(e.id);
-		edge->setFirstNode(nodesMap[e.startNodeId], e.startPortId);
-		edge->setLastNode(nodesMap[e.endNodeId], e.endPortId);
+	for (const CGraphDiff::Change& change : diff.changedEdges)
+	{
+		CEdge* edge = edges.value(change.id);
+		if (!edge)
+			continue;
 
-		for (auto it = e.attrs.constBegin(); it != e.attrs.constEnd(); ++it)
+		for (auto it = change.set.constBegin(); it != change.set.constEnd(); ++it)
 		{
 			edge->setAttribute(it.key(), it.value());
+
+			if (it.key() == "points")
+			{
+				if (CPolyEdge* polyEdge = dynamic_cast<CPolyEdge*>(edge))
+					polyEdge->setPoints(CUtils::pointsFromString(it.value().toString()));
+			}
 		}
-	}
 
-	// finalize
-	setSceneRect(itemsBoundingRect());
+		for (const QByteArray& attrId : change.removed)
+			edge->removeAttribute(attrId);
+	}
 
+	// labels & canvas updated, one undo step
 	addUndoState();
-
-	return true;
 }
 
 
 bool CNodeEditorScene::toGraph(Graph& g)
 {
+	PERF_SCOPE("scene.toGraph");
+
 	g.clear();
 
 
@@ -225,7 +387,7 @@ bool CNodeEditorScene::toGraph(Graph& g)
 	for (const auto &node : nodes)
 	{
 		Node n;
-		n.id = node->getId().toLatin1();
+		n.id = node->getId().toUtf8();
 
 		QByteArrayList ports = node->getPortIds();
 		for (const auto &portId : ports)
@@ -261,9 +423,9 @@ bool CNodeEditorScene::toGraph(Graph& g)
 	for (const auto &edge : edges)
 	{
 		Edge e;
-		e.id = edge->getId().toLatin1();
-		e.startNodeId = edge->firstNode()->getId().toLatin1();
-		e.endNodeId = edge->lastNode()->getId().toLatin1();
+		e.id = edge->getId().toUtf8();
+		e.startNodeId = edge->firstNode()->getId().toUtf8();
+		e.endNodeId = edge->lastNode()->getId().toUtf8();
 		e.startPortId = edge->firstPortId();
 		e.endPortId = edge->lastPortId();
 
@@ -1032,7 +1194,7 @@ QList<QGraphicsItem*> CNodeEditorScene::getTransformableItems() const
 {
 	QList<QGraphicsItem*> result;
 	
-	auto items = getSelectedItems();
+	const auto& items = getSelectedNodesEdges();
 	for (auto item : items)
 		result << item->getSceneItem();
 
@@ -1089,7 +1251,7 @@ void CNodeEditorScene::drawBackground(QPainter *painter, const QRectF &r)
 
 const QList<CNode*>& CNodeEditorScene::getSelectedNodes() const
 {
-    if (m_selNodes.isEmpty())
+    if (!m_selectionCached)
         prefetchSelection();
 
     return m_selNodes;
@@ -1098,7 +1260,7 @@ const QList<CNode*>& CNodeEditorScene::getSelectedNodes() const
 
 const QList<CEdge*>& CNodeEditorScene::getSelectedEdges() const
 {
-    if (m_selEdges.isEmpty())
+    if (!m_selectionCached)
         prefetchSelection();
 
     return m_selEdges;
@@ -1107,21 +1269,18 @@ const QList<CEdge*>& CNodeEditorScene::getSelectedEdges() const
 
 const QList<CItem*>& CNodeEditorScene::getSelectedNodesEdges() const
 {
-	if (m_selItems.isEmpty())
-		prefetchSelection();
-
-	return m_selItems;
+	return getSelectedCItems();
 }
 
 
-void CNodeEditorScene::onSelectionChanged()
+// topology
+
+QSharedPointer<const CAdjacencySnapshot> CNodeEditorScene::getAdjacency() const
 {
-    // drop cached selections
-    m_selNodes.clear();
-    m_selEdges.clear();
-	m_selItems.clear();
+	if (!m_adjacency || m_adjacency->revision() != getTopologyRevision())
+		m_adjacency.reset(new CAdjacencySnapshot(*this));
 
-	Super::onSelectionChanged();
+	return m_adjacency;
 }
 
 
@@ -1149,6 +1308,8 @@ void CNodeEditorScene::prefetchSelection() const
             continue;
         }
     }
+
+	m_selectionCached = true;
 }
 
 
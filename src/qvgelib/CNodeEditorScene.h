@@ -11,11 +11,15 @@ It can be used freely, maintaining the information above.
 
 #include "CEditorScene.h"
 #include "CEdge.h"
+#include "CAdjacencySnapshot.h"
+
+#include <QSharedPointer>
 
 class CNode;
 //class CEdge;
 class CNodePort;
 class CNodeSceneActions;
+class CGraphDiff;
 
 
 enum EditMode 
@@ -46,6 +50,20 @@ public:
 	virtual bool fromGraph(const Graph& g);
 	virtual bool toGraph(Graph& g);
 
+	// fromGraph() in steps (i.e. a batch per event loop cycle); g must be kept until finishFromGraph()
+	void beginFromGraph(const Graph& g);
+	// creates up to maxItems next nodes & edges, returns the number of the items left
+	int continueFromGraph(int maxItems);
+	void finishFromGraph();
+	// discards the items created so far
+	void abortFromGraph();
+	// between beginFromGraph() & finishFromGraph(): the scene is incomplete
+	bool isBuildingFromGraph() const { return m_buildGraph != nullptr; }
+
+	// turns the scene, as it was given by toGraph(), into g in one undoable step:
+	// only the items in the diff (see CGraphDiff::compute()) are created, deleted or updated
+	void updateFromGraph(const Graph& g, const CGraphDiff& diff);
+
 	// operations
 	bool startNewConnection(const QPointF& pos);
 	void cancel(const QPointF& pos = QPointF());
@@ -79,19 +97,19 @@ public:
     const QList<CEdge*>& getSelectedEdges() const;
 	const QList<CItem*>& getSelectedNodesEdges() const;
 
+	// topology for the graph algorithms: cached until nodes or edges are added, removed or reconnected
+	QSharedPointer<const CAdjacencySnapshot> getAdjacency() const;
+
 Q_SIGNALS:
 	void editModeChanged(int mode);
 
 public Q_SLOTS:
 	void setEditMode(EditMode mode);
 
-protected Q_SLOTS:
-	virtual void onSelectionChanged();
-
 protected:
 	// selection
 	void moveSelectedEdgesBy(const QPointF& d);
-    void prefetchSelection() const;
+    virtual void prefetchSelection() const;
 
 	// scene events
 	//virtual void mousePressEvent(QGraphicsSceneMouseEvent *mouseEvent);
@@ -117,6 +135,11 @@ protected:
     // draw
     virtual void drawBackground(QPainter *painter, const QRectF &);
 
+	// items of the Graph model
+	CNode* addNodeFromGraph(const Node& n);
+	CEdge* addEdgeFromGraph(const Edge& e, CNode* startNode, CNode* endNode);
+	void addClassAttributesFromGraph(const Graph& g);
+
 protected:
 	// edit mode
 	EditMode m_editMode;
@@ -138,10 +161,17 @@ protected:
     // cached selections
     mutable QList<CNode*> m_selNodes;
 	mutable QList<CEdge*> m_selEdges;
-	mutable QList<CItem*> m_selItems;
 
     // drawing
     int m_nextIndex = 0;
+
+	// cached topology
+	mutable QSharedPointer<const CAdjacencySnapshot> m_adjacency;
+
+	// incremental fromGraph()
+	const Graph *m_buildGraph = nullptr;
+	QHash<QByteArray, CNode*> m_buildNodes;
+	int m_buildIndex = 0;
 };
 
 
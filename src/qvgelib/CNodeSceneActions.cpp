@@ -16,6 +16,7 @@ It can be used freely, maintaining the information above.
 #include "CEditorSceneDefines.h"
 #include "CNode.h"
 #include "CEdge.h"
+#include "CAdjacencySnapshot.h"
 
 
 CNodeSceneActions::CNodeSceneActions(CNodeEditorScene *scene) : 
@@ -347,3 +348,112 @@ void CNodeSceneActions::onActionNodeEdgeClear()
 	onActionNodeClear();
 	onActionEdgeClear();
 }
+
+
+// topology selections
+
+void CNodeSceneActions::onActionSelectNeighbors()
+{
+	expandSelection(CTopologySelection::AnyDirection, 1);
+}
+
+
+void CNodeSceneActions::onActionSelectInNeighbors()
+{
+	expandSelection(CTopologySelection::Backward, 1);
+}
+
+
+void CNodeSceneActions::onActionSelectOutNeighbors()
+{
+	expandSelection(CTopologySelection::Forward, 1);
+}
+
+
+void CNodeSceneActions::onActionExpandSelection()
+{
+	if (nodeScene.getSelectedNodes().isEmpty())
+		return;
+
+	bool ok = false;
+	int hops = QInputDialog::getInt(0,
+		tr("Expand Selection"),
+		tr("Select the nodes within this number of hops:"),
+		2, 1, 1000000, 1, &ok);
+
+	if (ok)
+		expandSelection(CTopologySelection::AnyDirection, hops);
+}
+
+
+void CNodeSceneActions::onActionSelectComponent()
+{
+	expandSelection(CTopologySelection::AnyDirection, -1);
+}
+
+
+void CNodeSceneActions::onActionSelectAncestors()
+{
+	expandSelection(CTopologySelection::Backward, -1);
+}
+
+
+void CNodeSceneActions::onActionSelectDescendants()
+{
+	expandSelection(CTopologySelection::Forward, -1);
+}
+
+
+void CNodeSceneActions::onActionSelectShortestPath()
+{
+	auto nodes = nodeScene.getSelectedNodes();
+	if (nodes.size() != 2)
+	{
+		QMessageBox::information(0, tr("Select Shortest Path"), tr("Select exactly two nodes to find the path between them."));
+		return;
+	}
+
+	auto adjacency = nodeScene.getAdjacency();
+
+	auto result = CTopologySelection::shortestPath(*adjacency, adjacency->indexOf(nodes.first()), adjacency->indexOf(nodes.last()));
+	if (result.nodes.isEmpty())
+	{
+		QMessageBox::information(0, tr("Select Shortest Path"), tr("The nodes are not connected."));
+		return;
+	}
+
+	selectTopology(*adjacency, result);
+}
+
+
+void CNodeSceneActions::expandSelection(int direction, int hops)
+{
+	auto nodes = nodeScene.getSelectedNodes();
+	if (nodes.isEmpty())
+		return;
+
+	auto adjacency = nodeScene.getAdjacency();
+
+	QVector<int> seeds;
+	seeds.reserve(nodes.size());
+	for (auto node : nodes)
+		seeds << adjacency->indexOf(node);
+
+	selectTopology(*adjacency, CTopologySelection::expand(*adjacency, seeds, CTopologySelection::Direction(direction), hops));
+}
+
+
+void CNodeSceneActions::selectTopology(const CAdjacencySnapshot& adjacency, const CTopologySelection::Result& result)
+{
+	QList<CItem*> items;
+	items.reserve(result.nodes.size() + result.edges.size());
+
+	for (int index : result.nodes)
+		items << adjacency.node(index);
+
+	for (int index : result.edges)
+		items << adjacency.edge(index);
+
+	// a single selection update
+	nodeScene.selectItems(items);
+}
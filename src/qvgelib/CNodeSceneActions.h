@@ -10,10 +10,12 @@ It can be used freely, maintaining the information above.
 #pragma once
 
 #include "CEditorSceneActions.h"
+#include "CTopologySelection.h"
 
 class CNodeEditorScene;
 class CNode;
 class CEdge;
+class CAdjacencySnapshot;
 
 
 class CNodeSceneActions : public CEditorSceneActions
@@ -41,7 +43,20 @@ public Q_SLOTS:
 
 	void onActionNodeEdgeClear();
 
+	// topology selections, starting from the selected nodes
+	void onActionSelectNeighbors();
+	void onActionSelectInNeighbors();
+	void onActionSelectOutNeighbors();
+	void onActionExpandSelection();
+	void onActionSelectComponent();
+	void onActionSelectAncestors();
+	void onActionSelectDescendants();
+	void onActionSelectShortestPath();
+
 private:
+	void expandSelection(int direction, int hops);
+	void selectTopology(const CAdjacencySnapshot& adjacency, const CTopologySelection::Result& result);
+
 	CNodeEditorScene &nodeScene;
 };
 
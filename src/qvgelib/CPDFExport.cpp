@@ -16,6 +16,7 @@ It can be used freely, maintaining the information above.
 #include <QScopedPointer>
 
 #include "CPDFExport.h"
+#include "CPerfTrace.h"
 #include "CEditorScene.h"
 
 
@@ -124,6 +125,8 @@ bool CPDFExport::setupDialog(CEditorScene& scene)
 
 bool CPDFExport::save(const QString& fileName, CEditorScene& scene, QString* /*lastError*/) const
 {
+	PERF_SCOPE("io.pdf.export");
+
 	Q_ASSERT(m_printer);
 
 	QScopedPointer<CEditorScene> tempScene(scene.clone());
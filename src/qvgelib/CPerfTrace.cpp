@@ -0,0 +1,401 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#include "CPerfTrace.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QSaveFile>
+#include <QtCore/QTextStream>
+#include <QtCore/QThread>
+#include <QtCore/QVector>
+#include <QtCore/QMap>
+#include <QtCore/QStringList>
+
+
+// recording limit (~64 MB)
+static const int maxEvents = 2000000;
+
+// nesting of the tracked GUI scopes, the deeper ones are counted but not named
+static const int maxOperationDepth = 32;
+
+
+struct TraceEvent
+{
+	const char* name;
+	qint64 time;
+	qint64 value;		// duration of scope or value of counter
+	int threadId;
+	char phase;			// 'X': scope, 'C': counter
+};
+
+
+struct TraceData
+{
+	QMutex mutex;
+	QVector<TraceEvent> events;
+	int dropped = 0;
+	QMap<int, QString> threadNames;
+	QAtomicInt lastThreadId;
+
+	QElapsedTimer clock;
+
+	// written by the GUI thread only, read by the watchdog
+	QAtomicPointer<const char> operations[maxOperationDepth];
+	QAtomicInt operationDepth;
+
+	TraceData()
+	{
+		clock.start();
+	}
+};
+
+
+static TraceData& traceData()
+{
+	static TraceData data;
+	return data;
+}
+
+
+// small sequential thread ids for the trace viewers (the real ones are not readable)
+static int currentThreadId()
+{
+	static thread_local int id = 0;
+
+	if (id == 0)
+	{
+		TraceData& data = traceData();
+		id = data.lastThreadId.fetchAndAddRelaxed(1) + 1;
+
+		QString name = QThread::currentThread()->objectName();
+		if (name.isEmpty())
+		{
+			if (QCoreApplication::instance() && QThread::currentThread() == QCoreApplication::instance()->thread())
+				name = "GUI";
+			else
+				name = QString("Worker %1").arg(id);
+		}
+
+		QMutexLocker lock(&data.mutex);
+		data.threadNames[id] = name;
+	}
+
+	return id;
+}
+
+
+static bool isGuiThread()
+{
+	static thread_local int gui = -1;
+
+	if (gui < 0)
+	{
+		// undecided until the application object exists
+		if (!QCoreApplication::instance())
+			return false;
+
+		gui = (QThread::currentThread() == QCoreApplication::instance()->thread());
+	}
+
+	return gui;
+}
+
+
+static void appendEvent(const TraceEvent& event)
+{
+	TraceData& data = traceData();
+	QMutexLocker lock(&data.mutex);
+
+	if (data.events.size() < maxEvents)
+		data.events.append(event);
+	else
+		data.dropped++;
+}
+
+
+// CPerfTrace
+
+QAtomicInt CPerfTrace::s_flags;
+
+
+void CPerfTrace::startTracing()
+{
+	TraceData& data = traceData();
+	{
+		QMutexLocker lock(&data.mutex);
+		data.events.clear();
+		data.dropped = 0;
+	}
+
+	setFlag(Tracing, true);
+}
+
+
+void CPerfTrace::stopTracing()
+{
+	setFlag(Tracing, false);
+}
+
+
+int CPerfTrace::eventCount()
+{
+	TraceData& data = traceData();
+	QMutexLocker lock(&data.mutex);
+	return data.events.size();
+}
+
+
+void CPerfTrace::setCountingEnabled(bool on)
+{
+	setFlag(Counting, on);
+}
+
+
+void CPerfTrace::setWatchingEnabled(bool on)
+{
+	setFlag(Watching, on);
+}
+
+
+QString CPerfTrace::currentOperation()
+{
+	TraceData& data = traceData();
+
+	int depth = data.operationDepth.load();
+
+	QStringList names;
+	for (int i = 0; i < qMin(depth, maxOperationDepth); ++i)
+	{
+		if (const char* name = data.operations[i].load())
+			names << name;
+	}
+
+	return names.join(" > ");
+}
+
+
+void CPerfTrace::setFlag(Flags flag, bool on)
+{
+	if (on)
+		s_flags.fetchAndOrRelaxed(flag);
+	else
+		s_flags.fetchAndAndRelaxed(~flag);
+}
+
+
+qint64 CPerfTrace::now()
+{
+	return traceData().clock.nsecsElapsed() / 1000;
+}
+
+
+qint64 CPerfTrace::enterScope(const char* name, int flags)
+{
+	if ((flags & Watching) && isGuiThread())
+	{
+		TraceData& data = traceData();
+		int depth = data.operationDepth.load();
+		if (depth < maxOperationDepth)
+			data.operations[depth].store(name);
+
+		data.operationDepth.store(depth + 1);
+	}
+
+	return (flags & Tracing) ? now() : -1;
+}
+
+
+void CPerfTrace::leaveScope(const char* name, qint64 startTime, int flags)
+{
+	if (flags & Tracing)
+		addEvent(name, startTime);
+
+	if ((flags & Watching) && isGuiThread())
+	{
+		TraceData& data = traceData();
+		int depth = data.operationDepth.load() - 1;
+		if (depth < maxOperationDepth)
+			data.operations[depth].store(nullptr);
+
+		data.operationDepth.store(depth);
+	}
+}
+
+
+void CPerfTrace::addEvent(const char* name, qint64 startTime)
+{
+	TraceEvent event;
+	event.name = name;
+	event.time = startTime;
+	event.value = now() - startTime;
+	event.threadId = currentThreadId();
+	event.phase = 'X';
+
+	appendEvent(event);
+}
+
+
+void CPerfTrace::sampleCounters()
+{
+	if (!isActive(Tracing))
+		return;
+
+	TraceEvent event;
+	event.time = now();
+	event.threadId = currentThreadId();
+	event.phase = 'C';
+
+	for (CPerfCounter* counter : CPerfCounter::counters())
+	{
+		event.name = counter->name();
+		event.value = counter->value();
+		appendEvent(event);
+	}
+}
+
+
+// contents of a JSON string literal
+static QString jsonEscaped(const QString& text)
+{
+	QString result;
+	result.reserve(text.size());
+
+	for (QChar c : text)
+	{
+		switch (c.unicode())
+		{
+		case '"':	result += "\\\""; break;
+		case '\\':	result += "\\\\"; break;
+		case '\n':	result += "\\n"; break;
+		case '\r':	result += "\\r"; break;
+		case '\t':	result += "\\t"; break;
+		case '\b':	result += "\\b"; break;
+		case '\f':	result += "\\f"; break;
+		default:
+			if (c.unicode() < 0x20)
+				result += QString("\\u%1").arg(c.unicode(), 4, 16, QChar('0'));
+			else
+				result += c;
+		}
+	}
+
+	return result;
+}
+
+
+bool CPerfTrace::writeChromeTrace(const QString& fileName, QString* lastError)
+{
+	TraceData& data = traceData();
+
+	QVector<TraceEvent> events;
+	QMap<int, QString> threadNames;
+	int dropped = 0;
+	{
+		QMutexLocker lock(&data.mutex);
+		events = data.events;
+		threadNames = data.threadNames;
+		dropped = data.dropped;
+	}
+
+	QSaveFile saveFile(fileName);
+	if (!saveFile.open(QIODevice::WriteOnly))
+	{
+		if (lastError)
+			*lastError = QObject::tr("Cannot open file for writing");
+		return false;
+	}
+
+	QTextStream ts(&saveFile);
+	ts.setCodec("UTF-8");
+
+	ts << "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"application\":\"" << jsonEscaped(QCoreApplication::applicationName())
+		<< "\",\"droppedEvents\":" << dropped << "},\n\"traceEvents\":[\n";
+
+	bool first = true;
+
+	// thread names
+	for (auto it = threadNames.constBegin(); it != threadNames.constEnd(); ++it)
+	{
+		if (!first)
+			ts << ",\n";
+		first = false;
+
+		ts << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << it.key()
+			<< ",\"args\":{\"name\":\"" << jsonEscaped(it.value()) << "\"}}";
+	}
+
+	for (const TraceEvent& event : events)
+	{
+		if (!first)
+			ts << ",\n";
+		first = false;
+
+		if (event.phase == 'X')
+		{
+			ts << "{\"name\":\"" << event.name << "\",\"cat\":\"qvge\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.threadId
+				<< ",\"ts\":" << event.time << ",\"dur\":" << event.value << "}";
+		}
+		else
+		{
+			ts << "{\"name\":\"" << event.name << "\",\"ph\":\"C\",\"pid\":1,\"tid\":" << event.threadId
+				<< ",\"ts\":" << event.time << ",\"args\":{\"value\":" << event.value << "}}";
+		}
+	}
+
+	ts << "\n]}\n";
+	ts.flush();
+
+	if (ts.status() != QTextStream::Ok || !saveFile.commit())
+	{
+		if (lastError)
+			*lastError = QObject::tr("Cannot write file");
+		return false;
+	}
+
+	return true;
+}
+
+
+// CPerfCounter
+
+static QList<CPerfCounter*>& counterList()
+{
+	static QList<CPerfCounter*> list;
+	return list;
+}
+
+
+CPerfCounter::CPerfCounter(const char* name):
+	m_name(name),
+	m_value(0)
+{
+	// static objects: registered before main()
+	counterList().append(this);
+}
+
+
+QList<CPerfCounter*> CPerfCounter::counters()
+{
+	return counterList();
+}
+
+
+CPerfCounter* CPerfCounter::find(const char* name)
+{
+	for (CPerfCounter* counter : counterList())
+	{
+		if (qstrcmp(counter->name(), name) == 0)
+			return counter;
+	}
+
+	return nullptr;
+}
@@ -0,0 +1,150 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#pragma once
+
+#include <QtCore/QAtomicInteger>
+#include <QtCore/QList>
+#include <QtCore/QString>
+
+
+// Lightweight instrumentation of the hot paths: scoped timers & counters.
+// While nothing is active, a scope or a counter costs a single flag check.
+// Names must be string literals (they are stored as pointers).
+
+class CPerfTrace
+{
+public:
+	enum Flags
+	{
+		Tracing = 1,		// timed events are recorded
+		Counting = 2,		// counters are updated (also while tracing)
+		Watching = 4		// the scopes entered in the GUI thread are tracked (stall watchdog)
+	};
+
+	static bool isActive() {
+		return s_flags.load() != 0;
+	}
+
+	static int flags() {
+		return s_flags.load();
+	}
+
+	static bool isActive(Flags flag) {
+		return (s_flags.load() & flag) != 0;
+	}
+
+	// recording of the events: between start & stop
+	static void startTracing();
+	static void stopTracing();
+	static int eventCount();
+
+	// writes the recorded events in Chrome trace event format (chrome://tracing, Perfetto UI)
+	static bool writeChromeTrace(const QString& fileName, QString* lastError = nullptr);
+
+	static void setCountingEnabled(bool on);
+
+	// adds the current counter values to the trace
+	static void sampleCounters();
+
+	static void setWatchingEnabled(bool on);
+
+	// scopes being executed by the GUI thread, outermost first ("a > b > c"); can be called from any thread
+	static QString currentOperation();
+
+	// microseconds since the application start
+	static qint64 now();
+
+	// internal
+	static qint64 enterScope(const char* name, int flags);
+	static void leaveScope(const char* name, qint64 startTime, int flags);
+
+private:
+	static void setFlag(Flags flag, bool on);
+
+	// records a finished scope
+	static void addEvent(const char* name, qint64 startTime);
+
+	static QAtomicInt s_flags;
+};
+
+
+// Named counter, should be a static object
+
+class CPerfCounter
+{
+public:
+	explicit CPerfCounter(const char* name);
+
+	void add(qint64 value = 1) {
+		if (CPerfTrace::isActive())
+			m_value.fetchAndAddRelaxed(value);
+	}
+
+	void set(qint64 value) {
+		if (CPerfTrace::isActive())
+			m_value.store(value);
+	}
+
+	qint64 value() const {
+		return m_value.load();
+	}
+
+	const char* name() const {
+		return m_name;
+	}
+
+	static QList<CPerfCounter*> counters();
+	static CPerfCounter* find(const char* name);
+
+private:
+	const char* m_name;
+	QAtomicInteger<qint64> m_value;
+};
+
+
+// Timed scope
+
+class CPerfScope
+{
+public:
+	explicit CPerfScope(const char* name):
+		m_name(name),
+		m_flags(CPerfTrace::flags() & (CPerfTrace::Tracing | CPerfTrace::Watching)),
+		m_startTime(m_flags ? CPerfTrace::enterScope(name, m_flags) : -1)
+	{
+	}
+
+	~CPerfScope()
+	{
+		if (m_flags)
+			CPerfTrace::leaveScope(m_name, m_startTime, m_flags);
+	}
+
+private:
+	const char* m_name;
+	int m_flags;		// as on enter: a scope is left the same way it was entered
+	qint64 m_startTime;
+};
+
+
+// instrumentation macros, compiled out with QVGE_NO_PERF_TRACE
+
+#define PERF_CONCAT_(a, b) a##b
+#define PERF_CONCAT(a, b) PERF_CONCAT_(a, b)
+
+#ifdef QVGE_NO_PERF_TRACE
+	#define PERF_SCOPE(name)
+	#define PERF_COUNT(counter, value)
+	#define PERF_SET(counter, value)
+#else
+	#define PERF_SCOPE(name) CPerfScope PERF_CONCAT(perfScope_, __LINE__)(name)
+	#define PERF_COUNT(counter, value) (counter).add(value)
+	#define PERF_SET(counter, value) (counter).set(value)
+#endif
@@ -331,6 +331,8 @@ void CPolyEdge::onParentGeometryChanged()
 	if (!m_firstNode || !m_lastNode)
 		return;
 
+	countGeometryUpdate();
+
 	prepareGeometryChange();
 
 	// update line position
@@ -13,11 +13,14 @@ It can be used freely, maintaining the information above.
 #include <QScopedPointer>
 
 #include "CSVGExport.h"
+#include "CPerfTrace.h"
 #include "CEditorScene.h"
 
 
 bool CSVGExport::save(const QString& fileName, CEditorScene& scene, QString* /*lastError*/) const
 {
+	PERF_SCOPE("io.svg.export");
+
 	QScopedPointer<CEditorScene> tempScene(scene.clone());
 
 	if (m_cutContent)
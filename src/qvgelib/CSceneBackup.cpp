@@ -0,0 +1,240 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#include "CSceneBackup.h"
+#include "CStateJournal.h"
+#include "CEditorScene.h"
+#include "CPerfTrace.h"
+
+#include <QtConcurrent/QtConcurrentRun>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QDateTime>
+
+
+CSceneBackup::CSceneBackup(CEditorScene& scene, QObject* parent):
+	QObject(parent),
+	m_scene(&scene)
+{
+	connect(&m_watcher, &QFutureWatcher<Result>::finished, this, &CSceneBackup::onWriteFinished);
+}
+
+
+CSceneBackup::~CSceneBackup()
+{
+	waitForFinished();
+}
+
+
+void CSceneBackup::setFileName(const QString& fileName)
+{
+	if (fileName == m_fileName)
+		return;
+
+	waitForFinished();
+
+	m_fileName = fileName;
+
+	// new journal
+	m_baseState.clear();
+	m_deltasSize = 0;
+}
+
+
+void CSceneBackup::waitForFinished()
+{
+	if (m_watcher.isRunning())
+	{
+		m_watcher.waitForFinished();
+
+		// process result synchronously
+		onWriteFinished();
+	}
+}
+
+
+void CSceneBackup::backup()
+{
+	if (m_fileName.isEmpty())
+		return;
+
+	// coalesce requests while writing
+	if (m_watcher.isRunning())
+	{
+		m_pending = true;
+		return;
+	}
+
+	PERF_SCOPE("backup.snapshot");
+
+	// implicitly shared: no copy here
+	QByteArray state = m_scene->getStateSnapshot();
+	if (state.isEmpty())
+		return;
+
+	// nothing changed
+	if (state.constData() == m_baseState.constData() || state == m_baseState)
+		return;
+
+	m_job.fileName = m_fileName;
+	m_job.state = state;
+	m_job.baseState = m_baseState;
+	m_job.writeImage = m_baseState.isEmpty() || (m_deltasSize * 100 > qint64(state.size()) * m_compactionRatio);
+
+	m_watcher.setFuture(QtConcurrent::run(&CSceneBackup::writeJob, m_job));
+}
+
+
+void CSceneBackup::discard()
+{
+	// drop pending writes
+	m_pending = false;
+
+	waitForFinished();
+
+	if (m_fileName.size())
+		QFile::remove(m_fileName);
+
+	m_baseState.clear();
+	m_deltasSize = 0;
+}
+
+
+void CSceneBackup::onWriteFinished()
+{
+	// already processed
+	if (m_job.fileName.isEmpty())
+		return;
+
+	Result result = m_watcher.result();
+
+	if (result.ok)
+	{
+		if (m_job.writeImage)
+			m_deltasSize = 0;
+		else
+			m_deltasSize += result.bytesWritten;
+
+		m_baseState = m_job.state;
+	}
+	else
+	{
+		// start from the full image next time
+		m_baseState.clear();
+		m_deltasSize = 0;
+	}
+
+	QString fileName = m_job.fileName;
+	m_job = Job();
+
+	Q_EMIT backupFinished(result.ok, fileName, result.bytesWritten);
+
+	if (m_pending)
+	{
+		m_pending = false;
+		backup();
+	}
+}
+
+
+// worker thread
+
+CSceneBackup::Result CSceneBackup::writeJob(const Job& job)
+{
+	PERF_SCOPE("backup.write");
+
+	Result result;
+
+	if (job.writeImage)
+	{
+		// atomic replace of the whole journal
+		QSaveFile saveFile(job.fileName);
+		if (!saveFile.open(QIODevice::WriteOnly))
+			return result;
+
+		if (!CStateJournal::writeImage(saveFile, job.state, QDataStream().version()))
+		{
+			saveFile.cancelWriting();
+			return result;
+		}
+
+		result.bytesWritten = saveFile.pos();
+		result.ok = saveFile.commit();
+		return result;
+	}
+
+	CStateDelta delta = CStateJournal::diff(job.baseState, job.state);
+	if (delta.isEmpty())
+	{
+		result.ok = true;
+		return result;
+	}
+
+	QFile journalFile(job.fileName);
+	if (!journalFile.open(QIODevice::WriteOnly | QIODevice::Append))
+		return result;
+
+	qint64 startPos = journalFile.size();
+
+	result.ok = CStateJournal::appendDelta(journalFile, delta) && journalFile.flush();
+	result.bytesWritten = journalFile.size() - startPos;
+
+	return result;
+}
+
+
+// recovery
+
+bool CSceneBackup::hasBackup(const QString& fileName, const QString& documentFileName)
+{
+	QFileInfo backupInfo(fileName);
+	if (!backupInfo.exists())
+		return false;
+
+	// older than the document itself
+	QFileInfo documentInfo(documentFileName);
+	if (documentInfo.exists() && backupInfo.lastModified() < documentInfo.lastModified())
+		return false;
+
+	return true;
+}
+
+
+bool CSceneBackup::restore(const QString& fileName, CEditorScene& scene, QString* lastError)
+{
+	QFile journalFile(fileName);
+	if (!journalFile.open(QIODevice::ReadOnly))
+	{
+		if (lastError)
+			*lastError = tr("Cannot open file");
+		return false;
+	}
+
+	QByteArray state;
+	int streamVersion = 0;
+	if (!CStateJournal::read(journalFile, state, streamVersion, nullptr, lastError))
+		return false;
+
+	QDataStream ds(&state, QIODevice::ReadOnly);
+	ds.setVersion(streamVersion);
+
+	// restored state becomes an undo step over the current one
+	if (!scene.restoreFrom(ds, true))
+	{
+		if (lastError)
+			*lastError = tr("Backup data is corrupted");
+		return false;
+	}
+
+	scene.addUndoState();
+
+	return true;
+}
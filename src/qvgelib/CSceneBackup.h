@@ -0,0 +1,82 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+#include <QString>
+#include <QFutureWatcher>
+
+class CEditorScene;
+
+
+// Background autosave: the scene state is taken from the undo manager (no serialization on GUI thread),
+// and written by a worker thread as a journal: a full image followed by the compact deltas.
+
+class CSceneBackup : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit CSceneBackup(CEditorScene& scene, QObject* parent = nullptr);
+	virtual ~CSceneBackup();
+
+	// journal file; changing it starts a new journal
+	void setFileName(const QString& fileName);
+	const QString& getFileName() const { return m_fileName; }
+
+	// full image is rewritten when the deltas grow over the given % of the state size
+	void setCompactionRatio(int percent) { m_compactionRatio = percent; }
+
+	bool isBusy() const { return m_watcher.isRunning(); }
+	void waitForFinished();
+
+	// crash recovery
+	static bool hasBackup(const QString& fileName, const QString& documentFileName);
+	static bool restore(const QString& fileName, CEditorScene& scene, QString* lastError = nullptr);
+
+public Q_SLOTS:
+	void backup();
+	void discard();
+
+Q_SIGNALS:
+	void backupFinished(bool ok, const QString& fileName, qint64 bytesWritten);
+
+private Q_SLOTS:
+	void onWriteFinished();
+
+private:
+	struct Job
+	{
+		QString fileName;
+		QByteArray state, baseState;
+		bool writeImage = false;
+	};
+
+	struct Result
+	{
+		bool ok = false;
+		qint64 bytesWritten = 0;
+	};
+
+	static Result writeJob(const Job& job);
+
+	CEditorScene *m_scene;
+	QString m_fileName;
+	int m_compactionRatio = 50;
+
+	// state stored in the journal & size of the deltas after its image
+	QByteArray m_baseState;
+	qint64 m_deltasSize = 0;
+
+	Job m_job;
+	bool m_pending = false;
+	QFutureWatcher<Result> m_watcher;
+};
@@ -10,6 +10,7 @@ It can be used freely, maintaining the information above.
 
 #include "CSimpleUndoManager.h"
 #include "CEditorScene.h"
+#include "CPerfTrace.h"
 
 #include <QDataStream>
 
@@ -24,10 +25,13 @@ void CSimpleUndoManager::reset()
 {
 	m_stackIndex = -1;
 	m_stateStack.clear();
+	m_stackSize = 0;
 }
 
 void CSimpleUndoManager::addState()
 {
+	PERF_SCOPE("undo.addState");
+
 	// serialize & compress
 	QByteArray snap;
 	QDataStream ds(&snap, QIODevice::WriteOnly);
@@ -42,10 +46,14 @@ void CSimpleUndoManager::addState()
 	else
 	{
 		while (m_stateStack.size() > m_stackIndex)
-			m_stateStack.takeLast();
+			m_stackSize -= m_stateStack.takeLast().size();
 
 		m_stateStack.append(compressedSnap);
 	}
+
+	m_stackSize += compressedSnap.size();
+
+	checkMemoryBudget();
 }
 
 void CSimpleUndoManager::revertState()
@@ -61,6 +69,8 @@ void CSimpleUndoManager::revertState()
 
 void CSimpleUndoManager::undo()
 {
+	PERF_SCOPE("undo.undo");
+
 	if (availableUndoCount())
 	{
 		QByteArray &compressedSnap = m_stateStack[--m_stackIndex];
@@ -72,6 +82,8 @@ void CSimpleUndoManager::undo()
 
 void CSimpleUndoManager::redo()
 {
+	PERF_SCOPE("undo.redo");
+
 	if (availableRedoCount())
 	{
 		QByteArray &compressedSnap = m_stateStack[++m_stackIndex];
@@ -90,3 +102,34 @@ int CSimpleUndoManager::availableRedoCount() const
 {
 	return (m_stackIndex >= 0) && (m_stackIndex < m_stateStack.size() - 1);
 }
+
+QByteArray CSimpleUndoManager::currentState() const
+{
+	// states are stored without options
+	return QByteArray();
+}
+
+void CSimpleUndoManager::setMemoryBudget(qint64 bytes)
+{
+	m_memoryBudget = bytes;
+
+	checkMemoryBudget();
+}
+
+qint64 CSimpleUndoManager::memoryUsage() const
+{
+	return m_stackSize;
+}
+
+void CSimpleUndoManager::checkMemoryBudget()
+{
+	if (m_memoryBudget <= 0)
+		return;
+
+	// drop the oldest snapshots, the current one is always kept
+	while (m_stackIndex > 0 && m_stackSize > m_memoryBudget)
+	{
+		m_stackSize -= m_stateStack.takeFirst().size();
+		--m_stackIndex;
+	}
+}
@@ -31,11 +31,18 @@ public:
 	virtual void redo();
 	virtual int availableUndoCount() const;
 	virtual int availableRedoCount() const;
+	virtual QByteArray currentState() const;
+	virtual void setMemoryBudget(qint64 bytes);
+	virtual qint64 memoryUsage() const;
 
 private:
+	void checkMemoryBudget();
+
 	CEditorScene *m_scene;
 	QList<QByteArray> m_stateStack;
 	int m_stackIndex;
+	qint64 m_stackSize = 0;
+	qint64 m_memoryBudget = 0;
 };
 
 #endif // CUNDOMANAGER_H
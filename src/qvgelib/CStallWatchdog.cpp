@@ -0,0 +1,284 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#include "CStallWatchdog.h"
+#include "CPerfTrace.h"
+
+#include <QMutexLocker>
+#include <QMap>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QTextStream>
+#include <QStringList>
+
+#include <algorithm>
+
+
+// ms
+static const int heartbeatInterval = 100;
+static const int checkInterval = 50;
+
+// a hang is logged before it ends (the application may never come back)
+static const int hangTime = 10000;
+
+
+static QString operationName(const QString& scopes)
+{
+	return scopes.isEmpty() ? QString("(not instrumented)") : scopes;
+}
+
+
+CStallWatchdog::CStallWatchdog(QObject* parent): QThread(parent)
+{
+	setObjectName("Stall Watchdog");
+
+	m_heartbeatTimer.setInterval(heartbeatInterval);
+	connect(&m_heartbeatTimer, &QTimer::timeout, this, &CStallWatchdog::onHeartbeat);
+}
+
+
+CStallWatchdog::~CStallWatchdog()
+{
+	stopWatching();
+}
+
+
+void CStallWatchdog::setThreshold(int ms)
+{
+	m_threshold = qMax(ms, heartbeatInterval * 2);
+}
+
+
+void CStallWatchdog::setLogFile(const QString& fileName, qint64 maxSize, int maxFiles)
+{
+	QMutexLocker lock(&m_mutex);
+
+	m_logFileName = fileName;
+	m_maxLogSize = maxSize;
+	m_maxLogFiles = qMax(1, maxFiles);
+
+	QDir().mkpath(QFileInfo(fileName).absolutePath());
+}
+
+
+void CStallWatchdog::setContext(const QString& context)
+{
+	QMutexLocker lock(&m_mutex);
+
+	m_context = context;
+}
+
+
+void CStallWatchdog::startWatching()
+{
+	if (isRunning())
+		return;
+
+	m_stop.store(0);
+	m_lastHeartbeat.store(CPerfTrace::now());
+
+	// the scopes are tracked only while watching
+	CPerfTrace::setWatchingEnabled(true);
+
+	m_heartbeatTimer.start();
+	start();
+}
+
+
+void CStallWatchdog::stopWatching()
+{
+	if (!isRunning())
+		return;
+
+	m_stop.store(1);
+	wait();
+
+	m_heartbeatTimer.stop();
+
+	CPerfTrace::setWatchingEnabled(false);
+}
+
+
+void CStallWatchdog::onHeartbeat()
+{
+	m_lastHeartbeat.store(CPerfTrace::now());
+}
+
+
+// watchdog thread
+
+void CStallWatchdog::run()
+{
+	const qint64 threshold = qint64(m_threshold) * 1000;	// us
+
+	bool inStall = false;
+	bool hangLogged = false;
+	qint64 stallBeat = 0;
+	QMap<QString, int> samples;
+
+	qint64 lastCheck = CPerfTrace::now();
+
+	while (!m_stop.load())
+	{
+		msleep(checkInterval);
+
+		qint64 now = CPerfTrace::now();
+
+		// the whole process was suspended (system sleep, debugger): not a stall
+		if (now - lastCheck > threshold)
+		{
+			m_lastHeartbeat.store(now);
+			inStall = false;
+			lastCheck = now;
+			continue;
+		}
+
+		lastCheck = now;
+
+		qint64 beat = m_lastHeartbeat.load();
+
+		if (now - beat > threshold)
+		{
+			if (!inStall)
+			{
+				inStall = true;
+				hangLogged = false;
+				stallBeat = beat;
+				samples.clear();
+			}
+
+			samples[CPerfTrace::currentOperation()]++;
+
+			if (!hangLogged && now - stallBeat > hangTime * 1000)
+			{
+				hangLogged = true;
+
+				Stall stall;
+				stall.duration = int((now - stallBeat) / 1000);
+				stall.time = QDateTime::currentDateTime().addMSecs(-stall.duration);
+				stall.operation = operationName(CPerfTrace::currentOperation()) + " (not finished)";
+				writeStall(stall);
+			}
+
+			continue;
+		}
+
+		if (!inStall)
+			continue;
+
+		inStall = false;
+
+		// the longest sampled operation
+		auto it = std::max_element(samples.constBegin(), samples.constEnd());
+
+		Stall stall;
+		stall.duration = int((beat - stallBeat) / 1000);
+		stall.time = QDateTime::currentDateTime().addMSecs(-stall.duration);
+		stall.operation = operationName(it.key());
+		writeStall(stall);
+
+		Q_EMIT stallDetected(stall.duration, stall.operation);
+	}
+}
+
+
+// log: a line per stall, tab separated
+
+void CStallWatchdog::writeStall(const Stall& stall)
+{
+	QMutexLocker lock(&m_mutex);
+
+	if (m_logFileName.isEmpty())
+		return;
+
+	rotateLog();
+
+	QFile logFile(m_logFileName);
+	if (!logFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))
+		return;
+
+	QString context = m_context;
+	context.replace('\t', ' ').replace('\n', ' ');
+
+	QTextStream ts(&logFile);
+	ts.setCodec("UTF-8");
+	ts << stall.time.toString(Qt::ISODate) << '\t' << stall.duration << '\t' << stall.operation << '\t' << context << '\n';
+}
+
+
+void CStallWatchdog::rotateLog()
+{
+	if (QFileInfo(m_logFileName).size() < m_maxLogSize)
+		return;
+
+	QFile::remove(m_logFileName + QString(".%1").arg(m_maxLogFiles - 1));
+
+	for (int i = m_maxLogFiles - 2; i > 0; --i)
+		QFile::rename(m_logFileName + QString(".%1").arg(i), m_logFileName + QString(".%1").arg(i + 1));
+
+	if (m_maxLogFiles > 1)
+		QFile::rename(m_logFileName, m_logFileName + ".1");
+	else
+		QFile::remove(m_logFileName);
+}
+
+
+QList<CStallWatchdog::Stall> CStallWatchdog::lastStalls(int maxCount) const
+{
+	QMutexLocker lock(&m_mutex);
+
+	QList<Stall> stalls;
+
+	if (m_logFileName.isEmpty())
+		return stalls;
+
+	// current log first, then the rotated ones
+	for (int i = 0; i < m_maxLogFiles && stalls.size() < maxCount; ++i)
+	{
+		QString fileName = i ? m_logFileName + QString(".%1").arg(i) : m_logFileName;
+
+		QList<Stall> fileStalls = readLog(fileName);
+		for (int j = fileStalls.size() - 1; j >= 0 && stalls.size() < maxCount; --j)
+			stalls << fileStalls.at(j);
+	}
+
+	return stalls;
+}
+
+
+QList<CStallWatchdog::Stall> CStallWatchdog::readLog(const QString& fileName)
+{
+	QList<Stall> stalls;
+
+	QFile logFile(fileName);
+	if (!logFile.open(QIODevice::ReadOnly | QIODevice::Text))
+		return stalls;
+
+	QTextStream ts(&logFile);
+	ts.setCodec("UTF-8");
+
+	while (!ts.atEnd())
+	{
+		QStringList fields = ts.readLine().split('\t');
+		if (fields.size() < 3)
+			continue;
+
+		Stall stall;
+		stall.time = QDateTime::fromString(fields.at(0), Qt::ISODate);
+		stall.duration = fields.at(1).toInt();
+		stall.operation = fields.at(2);
+		stall.context = fields.value(3);
+
+		if (stall.time.isValid())
+			stalls << stall;
+	}
+
+	return stalls;
+}
@@ -0,0 +1,88 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#pragma once
+
+#include <QThread>
+#include <QTimer>
+#include <QMutex>
+#include <QString>
+#include <QDateTime>
+#include <QList>
+#include <QAtomicInteger>
+
+
+// Detects the stalls of the GUI event loop: the GUI thread sends heartbeats via a timer,
+// the watchdog thread checks them and samples the instrumented scopes (PERF_SCOPE) being executed.
+// Each stall is appended to a rotating log file together with the context set by the application.
+
+class CStallWatchdog : public QThread
+{
+	Q_OBJECT
+
+public:
+	struct Stall
+	{
+		QDateTime time;			// start
+		int duration = 0;		// ms
+		QString operation;		// the scopes sampled most often, "(not instrumented)" if none
+		QString context;
+	};
+
+	explicit CStallWatchdog(QObject* parent = nullptr);
+	virtual ~CStallWatchdog();
+
+	// minimal duration of a stall to be logged (ms)
+	void setThreshold(int ms);
+	int getThreshold() const { return m_threshold; }
+
+	// the log is rotated when it grows over maxSize (bytes): log -> log.1 -> log.2 ...
+	void setLogFile(const QString& fileName, qint64 maxSize = 256 * 1024, int maxFiles = 3);
+	const QString& getLogFile() const { return m_logFileName; }
+
+	// free text stored with the stalls (i.e. scene stats); can be called from any thread
+	void setContext(const QString& context);
+
+	// should be called from the GUI thread
+	void startWatching();
+	void stopWatching();
+	bool isWatching() const { return isRunning(); }
+
+	// newest first
+	QList<Stall> lastStalls(int maxCount = 50) const;
+
+Q_SIGNALS:
+	// emitted when the event loop is running again
+	void stallDetected(int duration, const QString& operation);
+
+protected:
+	virtual void run();
+
+private Q_SLOTS:
+	void onHeartbeat();
+
+private:
+	void writeStall(const Stall& stall);
+	void rotateLog();
+
+	static QList<Stall> readLog(const QString& fileName);
+
+	QTimer m_heartbeatTimer;
+	QAtomicInteger<qint64> m_lastHeartbeat;
+	QAtomicInt m_stop;
+
+	int m_threshold = 500;
+
+	QString m_logFileName;
+	qint64 m_maxLogSize = 256 * 1024;
+	int m_maxLogFiles = 3;
+
+	mutable QMutex m_mutex;		// context & log file
+	QString m_context;
+};
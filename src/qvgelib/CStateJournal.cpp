@@ -0,0 +1,284 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#include "CStateJournal.h"
+#include "CBlockDiff.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QObject>
+#include <QtCore/QVector>
+
+
+static const char* journalMagic = "QVGEJRNL";
+static const int journalMagicSize = 8;
+static const quint32 journalVersion = 2;		// 2: patches records
+
+static const quint32 imageTag = 0x494d4147;	// IMAG
+static const quint32 deltaTag = 0x444c5441;	// DLTA
+static const quint32 patchesTag = 0x50544353;	// PTCS
+
+
+// blocks: tag, payload size, payload, checksum
+
+static bool writeBlock(QIODevice& out, quint32 tag, const QByteArray& payload)
+{
+	QDataStream ds(&out);
+	ds << tag << quint32(payload.size());
+	ds.writeRawData(payload.constData(), payload.size());
+	ds << quint32(qChecksum(payload.constData(), payload.size()));
+
+	return ds.status() == QDataStream::Ok;
+}
+
+
+static bool readBlock(QIODevice& in, quint32& tag, QByteArray& payload)
+{
+	QDataStream ds(&in);
+
+	quint32 size = 0;
+	ds >> tag >> size;
+	if (ds.status() != QDataStream::Ok)
+		return false;
+
+	// incomplete block
+	if (in.bytesAvailable() < qint64(size) + 4)
+		return false;
+
+	payload.resize(size);
+	if (ds.readRawData(payload.data(), size) != int(size))
+		return false;
+
+	quint32 checksum = 0;
+	ds >> checksum;
+
+	return ds.status() == QDataStream::Ok && checksum == qChecksum(payload.constData(), payload.size());
+}
+
+
+// diff
+
+CStateDelta CStateJournal::diff(const QByteArray& from, const QByteArray& to)
+{
+	const char* p1 = from.constData();
+	const char* p2 = to.constData();
+	int size1 = from.size();
+	int size2 = to.size();
+
+	// common prefix
+	int left = CBlockDiff::commonPrefix(p1, p2, qMin(size1, size2));
+
+	// common suffix (not overlapping the prefix)
+	int right = CBlockDiff::commonSuffix(p1 + size1, p2 + size2, qMin(size1, size2) - left);
+	int right1 = size1 - right, right2 = size2 - right;
+
+	CStateDelta delta;
+	delta.index = left;
+	delta.sizeToReplace = right1 - left;
+	delta.data = to.mid(left, right2 - left);
+	return delta;
+}
+
+
+bool CStateJournal::apply(QByteArray& state, const CStateDelta& delta)
+{
+	if (delta.index < 0 || delta.sizeToReplace < 0 || delta.index + delta.sizeToReplace > state.size())
+		return false;
+
+	state.replace(delta.index, delta.sizeToReplace, delta.data);
+	return true;
+}
+
+
+// IO
+
+bool CStateJournal::writeImage(QIODevice& out, const QByteArray& state, int streamVersion)
+{
+	QDataStream ds(&out);
+	ds.writeRawData(journalMagic, journalMagicSize);
+	ds << journalVersion << qint32(streamVersion);
+	if (ds.status() != QDataStream::Ok)
+		return false;
+
+	return writeBlock(out, imageTag, qCompress(state));
+}
+
+
+bool CStateJournal::appendDelta(QIODevice& out, const CStateDelta& delta)
+{
+	QByteArray payload;
+	QDataStream ds(&payload, QIODevice::WriteOnly);
+	ds << qint32(delta.index) << qint32(delta.sizeToReplace) << qCompress(delta.data);
+
+	return writeBlock(out, deltaTag, payload);
+}
+
+
+bool CStateJournal::appendPatches(QIODevice& out, const QList<CStateDelta>& patches)
+{
+	QByteArray payload;
+	QDataStream ds(&payload, QIODevice::WriteOnly);
+	ds << qint32(patches.size());
+
+	// the data compressed all at once
+	QByteArray data;
+	for (const CStateDelta& patch : patches)
+	{
+		ds << qint32(patch.index) << qint32(patch.sizeToReplace) << qint32(patch.data.size());
+		data += patch.data;
+	}
+
+	ds << qCompress(data);
+
+	return writeBlock(out, patchesTag, payload);
+}
+
+
+bool CStateJournal::isJournal(QIODevice& in)
+{
+	return in.peek(journalMagicSize) == QByteArray(journalMagic, journalMagicSize);
+}
+
+
+// reads a record of patches
+
+static bool readPatches(const QByteArray& payload, QList<CStateDelta>& patches)
+{
+	QDataStream ds(payload);
+
+	qint32 count = 0;
+	ds >> count;
+	if (ds.status() != QDataStream::Ok || count < 0)
+		return false;
+
+	QVector<qint32> sizes;
+	for (int i = 0; i < count && ds.status() == QDataStream::Ok; ++i)
+	{
+		qint32 index = 0, sizeToReplace = 0, size = 0;
+		ds >> index >> sizeToReplace >> size;
+
+		CStateDelta patch;
+		patch.index = index;
+		patch.sizeToReplace = sizeToReplace;
+		patches << patch;
+		sizes << size;
+	}
+
+	QByteArray data;
+	ds >> data;
+	if (ds.status() != QDataStream::Ok)
+		return false;
+
+	data = qUncompress(data);
+
+	int offset = 0;
+	for (int i = 0; i < count; ++i)
+	{
+		if (sizes[i] < 0 || offset + sizes[i] > data.size())
+			return false;
+
+		patches[i].data = data.mid(offset, sizes[i]);
+		offset += sizes[i];
+	}
+
+	return true;
+}
+
+
+bool CStateJournal::read(QIODevice& in, QByteArray& state, int& streamVersion, int* deltaCount, QString* lastError, qint64* imageSize)
+{
+	if (deltaCount)
+		*deltaCount = 0;
+
+	// header
+	if (!isJournal(in))
+	{
+		if (lastError)
+			*lastError = QObject::tr("Not a journal file");
+		return false;
+	}
+
+	QDataStream ds(&in);
+	ds.skipRawData(journalMagicSize);
+
+	quint32 version = 0;
+	qint32 dsVersion = 0;
+	ds >> version >> dsVersion;
+	if (ds.status() != QDataStream::Ok || version > journalVersion)
+	{
+		if (lastError)
+			*lastError = QObject::tr("Unsupported journal version");
+		return false;
+	}
+
+	streamVersion = dsVersion;
+
+	// base image
+	quint32 tag = 0;
+	QByteArray payload;
+	if (!readBlock(in, tag, payload) || tag != imageTag)
+	{
+		if (lastError)
+			*lastError = QObject::tr("Journal base image is corrupted");
+		return false;
+	}
+
+	state = qUncompress(payload);
+
+	if (imageSize)
+		*imageSize = in.pos();
+
+	// replay deltas until the end or the first broken one
+	while (!in.atEnd())
+	{
+		if (!readBlock(in, tag, payload))
+			break;
+
+		if (tag == patchesTag)
+		{
+			QList<CStateDelta> patches;
+			if (!readPatches(payload, patches))
+				break;
+
+			// all or none
+			QByteArray patched = state;
+			if (!CBlockDiff::apply(patched, patches))
+				break;
+
+			state = patched;
+
+			if (deltaCount)
+				(*deltaCount)++;
+
+			continue;
+		}
+
+		if (tag != deltaTag)
+			break;
+
+		QDataStream pds(payload);
+		qint32 index = 0, sizeToReplace = 0;
+		QByteArray data;
+		pds >> index >> sizeToReplace >> data;
+		if (pds.status() != QDataStream::Ok)
+			break;
+
+		CStateDelta delta;
+		delta.index = index;
+		delta.sizeToReplace = sizeToReplace;
+		delta.data = qUncompress(data);
+
+		if (!apply(state, delta))
+			break;
+
+		if (deltaCount)
+			(*deltaCount)++;
+	}
+
+	return true;
+}
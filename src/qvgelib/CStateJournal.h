@@ -0,0 +1,58 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+#include <QtCore/QIODevice>
+#include <QtCore/QList>
+
+
+// Change of a serialized scene state: replace sizeToReplace bytes at index by data
+
+struct CStateDelta
+{
+	int index = 0;
+	int sizeToReplace = 0;
+	QByteArray data;
+
+	bool isEmpty() const {
+		return sizeToReplace == 0 && data.isEmpty();
+	}
+};
+
+
+// Journal of serialized scene states: a compressed base image followed by appended deltas.
+// Every block is checksummed, so a torn tail (i.e. after a crash) is just ignored on reading.
+
+class CStateJournal
+{
+public:
+	// computes delta which turns `from` into `to`
+	static CStateDelta diff(const QByteArray& from, const QByteArray& to);
+
+	// applies delta to the state
+	static bool apply(QByteArray& state, const CStateDelta& delta);
+
+	// writes header & base image (the device should be empty)
+	static bool writeImage(QIODevice& out, const QByteArray& state, int streamVersion);
+
+	// appends single delta record
+	static bool appendDelta(QIODevice& out, const CStateDelta& delta);
+
+	// appends a record of several deltas ordered by position (as made by CBlockDiff)
+	static bool appendPatches(QIODevice& out, const QList<CStateDelta>& patches);
+
+	// checks if the device contains a journal
+	static bool isJournal(QIODevice& in);
+
+	// reads base image & replays all the complete deltas; imageSize is the size of the header & image in the file
+	static bool read(QIODevice& in, QByteArray& state, int& streamVersion, int* deltaCount = nullptr, QString* lastError = nullptr, qint64* imageSize = nullptr);
+};
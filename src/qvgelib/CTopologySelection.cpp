@@ -0,0 +1,141 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#include "CTopologySelection.h"
+#include "CAdjacencySnapshot.h"
+#include "CPerfTrace.h"
+
+#include <algorithm>
+
+
+static CAdjacencySnapshot::Arcs arcsOf(const CAdjacencySnapshot& adjacency, int node, CTopologySelection::Direction direction)
+{
+	switch (direction)
+	{
+	case CTopologySelection::Forward:
+		return adjacency.outArcs(node);
+
+	case CTopologySelection::Backward:
+		return adjacency.inArcs(node);
+
+	default:
+		return adjacency.allArcs(node);
+	}
+}
+
+
+CTopologySelection::Result CTopologySelection::expand(const CAdjacencySnapshot& adjacency, const QVector<int>& seeds, Direction direction, int hops)
+{
+	PERF_SCOPE("selection.expand");
+
+	const int n = adjacency.nodeCount();
+
+	Result result;
+
+	// breadth first, the result list is the queue; hop of a node = its level
+	QVector<bool> visited(n, false);
+	QVector<int> level;
+
+	for (int seed : seeds)
+	{
+		if (seed >= 0 && seed < n && !visited[seed])
+		{
+			visited[seed] = true;
+			result.nodes << seed;
+			level << 0;
+		}
+	}
+
+	for (int head = 0; head < result.nodes.size(); ++head)
+	{
+		if (hops >= 0 && level[head] >= hops)
+			continue;
+
+		for (const auto& arc : arcsOf(adjacency, result.nodes[head], direction))
+		{
+			if (!visited[arc.node])
+			{
+				visited[arc.node] = true;
+				result.nodes << arc.node;
+				level << level[head] + 1;
+			}
+		}
+	}
+
+	// edges inside of the reached part
+	for (int e = 0; e < adjacency.edgeCount(); ++e)
+	{
+		if (visited[adjacency.edgeSource(e)] && visited[adjacency.edgeTarget(e)])
+			result.edges << e;
+	}
+
+	return result;
+}
+
+
+CTopologySelection::Result CTopologySelection::shortestPath(const CAdjacencySnapshot& adjacency, int from, int to)
+{
+	PERF_SCOPE("selection.path");
+
+	const int n = adjacency.nodeCount();
+
+	Result result;
+
+	if (from < 0 || from >= n || to < 0 || to >= n)
+		return result;
+
+	// arc used to reach every node (-1: not reached yet)
+	QVector<int> viaEdge(n), viaNode(n);
+	QVector<int> queue;
+	queue.reserve(n);
+
+	for (Direction direction : { Forward, AnyDirection })
+	{
+		viaEdge.fill(-1);
+		viaNode.fill(-1);
+		queue.clear();
+
+		queue << from;
+		viaNode[from] = from;
+
+		for (int head = 0; head < queue.size() && viaNode[to] < 0; ++head)
+		{
+			int v = queue[head];
+
+			for (const auto& arc : arcsOf(adjacency, v, direction))
+			{
+				if (viaNode[arc.node] < 0)
+				{
+					viaNode[arc.node] = v;
+					viaEdge[arc.node] = arc.edge;
+					queue << arc.node;
+				}
+			}
+		}
+
+		if (viaNode[to] < 0)
+			continue;
+
+		// back from the target
+		for (int v = to; v != from; v = viaNode[v])
+		{
+			result.nodes << v;
+			result.edges << viaEdge[v];
+		}
+
+		result.nodes << from;
+
+		std::reverse(result.nodes.begin(), result.nodes.end());
+		std::reverse(result.edges.begin(), result.edges.end());
+
+		break;
+	}
+
+	return result;
+}
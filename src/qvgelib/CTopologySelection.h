@@ -0,0 +1,60 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#pragma once
+
+#include <QVector>
+
+class CAdjacencySnapshot;
+
+
+// Topology-based selections over the adjacency snapshot: node & edge indices of the snapshot
+// in, node & edge indices out. Every operation is a single traversal, linear in the graph size.
+
+class CTopologySelection
+{
+public:
+	enum Direction
+	{
+		AnyDirection,	// edge directions ignored
+		Forward,		// along the edges (mutual & undirected edges go both ways)
+		Backward		// against the edges
+	};
+
+	struct Result
+	{
+		QVector<int> nodes;
+		QVector<int> edges;
+	};
+
+	// seeds and the nodes reachable from them in at most `hops` steps (< 0: unlimited),
+	// with the edges between all these nodes
+	static Result expand(const CAdjacencySnapshot& adjacency, const QVector<int>& seeds, Direction direction, int hops);
+
+	// whole connected components of the seeds
+	static Result components(const CAdjacencySnapshot& adjacency, const QVector<int>& seeds)
+	{
+		return expand(adjacency, seeds, AnyDirection, -1);
+	}
+
+	// seeds & their predecessors / successors of any depth
+	static Result ancestors(const CAdjacencySnapshot& adjacency, const QVector<int>& seeds)
+	{
+		return expand(adjacency, seeds, Backward, -1);
+	}
+
+	static Result descendants(const CAdjacencySnapshot& adjacency, const QVector<int>& seeds)
+	{
+		return expand(adjacency, seeds, Forward, -1);
+	}
+
+	// fewest edges from `from` to `to` along the directions, or ignoring them if there is no such path;
+	// empty if not connected at all
+	static Result shortestPath(const CAdjacencySnapshot& adjacency, int from, int to);
+};
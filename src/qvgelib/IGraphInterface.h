@@ -18,6 +18,10 @@ public:
 	virtual CEdge* addEdge(const QString& edgeId, const QString& startNodeId, const QString& endNodeId) = 0;
 	virtual CEdge* getEdge(const QString& edgeId) = 0;
 	virtual bool setEdgeAttr(const QString& edgeId, const QByteArray& attrId, const QVariant& value) = 0;
+	virtual bool setNodeAttr(const QString& nodeId, const QByteArray& attrId, const QVariant& value) = 0;
+
+	virtual bool removeNode(const QString& nodeId) = 0;
+	virtual bool removeEdge(const QString& edgeId) = 0;
 
     virtual QList<CEdge*> getEdges() const = 0;
     virtual QList<CNode*> getNodes() const = 0;
@@ -9,6 +9,8 @@ It can be used freely, maintaining the information above.
 
 #pragma once
 
+#include <QtCore/QByteArray>
+
 
 class IUndoManager
 {
@@ -20,4 +22,9 @@ public:
 	virtual void redo() = 0;
 	virtual int availableUndoCount() const = 0;
 	virtual int availableRedoCount() const = 0;
+	// serialized current state (with options) if kept by the manager, else empty
+	virtual QByteArray currentState() const = 0;
+	// max. bytes of the history kept in RAM (0: unlimited) & the actual usage
+	virtual void setMemoryBudget(qint64 bytes) = 0;
+	virtual qint64 memoryUsage() const = 0;
 };
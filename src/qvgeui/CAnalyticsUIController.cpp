@@ -0,0 +1,157 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#include "CAnalyticsUIController.h"
+
+#include <appbase/CMainWindow.h>
+
+#include <qvgelib/CNodeEditorScene.h>
+#include <qvgelib/CAdjacencySnapshot.h>
+#include <qvgelib/CGraphAnalytics.h>
+
+#include <QMenuBar>
+#include <QMenu>
+#include <QStatusBar>
+#include <QMessageBox>
+#include <QProgressDialog>
+#include <QEventLoop>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrentRun>
+
+
+CAnalyticsUIController::CAnalyticsUIController(CMainWindow *parent, CNodeEditorScene *scene) :
+	QObject(parent),
+	m_parent(parent), m_scene(scene)
+{
+	// add analytics menu
+	QMenu *analyticsMenu = new QMenu(tr("&Analytics"));
+	m_parent->menuBar()->insertMenu(m_parent->getWindowMenuAction(), analyticsMenu);
+
+	QAction *degreeAction = analyticsMenu->addAction(tr("Degree"), this, SLOT(doDegree()));
+	degreeAction->setStatusTip(tr("Count of the edges of every node (\"degree\", \"indegree\", \"outdegree\" attributes)"));
+
+	QAction *componentsAction = analyticsMenu->addAction(tr("Connected Components"), this, SLOT(doComponents()));
+	componentsAction->setStatusTip(tr("Index of the connected component of every node (\"component\" attribute)"));
+
+	QAction *pageRankAction = analyticsMenu->addAction(tr("PageRank"), this, SLOT(doPageRank()));
+	pageRankAction->setStatusTip(tr("PageRank of every node (\"pagerank\" attribute)"));
+
+	QAction *betweennessAction = analyticsMenu->addAction(tr("Betweenness (Sampled)"), this, SLOT(doBetweenness()));
+	betweennessAction->setStatusTip(tr("Estimated betweenness centrality of every node (\"betweenness\" attribute)"));
+
+	QAction *clusteringAction = analyticsMenu->addAction(tr("Clustering Coefficient"), this, SLOT(doClustering()));
+	clusteringAction->setStatusTip(tr("Local clustering coefficient of every node (\"clustering\" attribute)"));
+
+	analyticsMenu->addSeparator();
+
+	analyticsMenu->addAction(tr("All Metrics"), this, SLOT(doAllMetrics()));
+}
+
+
+void CAnalyticsUIController::doDegree()
+{
+	run(CGraphAnalytics::Degree);
+}
+
+
+void CAnalyticsUIController::doComponents()
+{
+	run(CGraphAnalytics::Components);
+}
+
+
+void CAnalyticsUIController::doPageRank()
+{
+	run(CGraphAnalytics::PageRank);
+}
+
+
+void CAnalyticsUIController::doBetweenness()
+{
+	run(CGraphAnalytics::Betweenness);
+}
+
+
+void CAnalyticsUIController::doClustering()
+{
+	run(CGraphAnalytics::Clustering);
+}
+
+
+void CAnalyticsUIController::doAllMetrics()
+{
+	run(CGraphAnalytics::AllMetrics);
+}
+
+
+void CAnalyticsUIController::run(int metrics)
+{
+	QSharedPointer<const CAdjacencySnapshot> adjacency = m_scene->getAdjacency();
+	if (adjacency->nodeCount() == 0)
+	{
+		m_parent->statusBar()->showMessage(tr("Nothing to analyze: the graph is empty"), 3000);
+		return;
+	}
+
+	// the worker reads the snapshot only, the GUI stays responsive; modal from the start, so the scene is not edited meanwhile
+	QProgressDialog progressDialog(tr("Computing metrics of %1 node(s)...").arg(adjacency->nodeCount()), tr("Cancel"), 0, 0, m_parent);
+	progressDialog.setWindowTitle(tr("Analytics"));
+	progressDialog.setWindowModality(Qt::WindowModal);
+	progressDialog.setMinimumDuration(0);
+	progressDialog.setAutoClose(false);
+	progressDialog.setAutoReset(false);
+	progressDialog.show();
+
+	QSharedPointer<QAtomicInt> canceled(new QAtomicInt(0));
+
+	QFutureWatcher<CGraphAnalytics::Result> watcher;
+	QEventLoop loop;
+	connect(&watcher, &QFutureWatcher<CGraphAnalytics::Result>::finished, &loop, &QEventLoop::quit);
+
+	connect(&progressDialog, &QProgressDialog::canceled, &loop, [&]()
+	{
+		canceled->storeRelease(1);
+
+		// hidden by the cancel: modal again until the worker stops
+		progressDialog.setLabelText(tr("Canceling..."));
+		progressDialog.show();
+	});
+
+	watcher.setFuture(QtConcurrent::run([adjacency, metrics, canceled]()
+	{
+		CGraphAnalytics::Options options;
+		options.canceled = canceled.data();
+
+		return CGraphAnalytics::compute(*adjacency, metrics, options);
+	}));
+
+	if (!watcher.isFinished())
+		loop.exec();
+
+	progressDialog.hide();
+
+	CGraphAnalytics::Result result = watcher.result();
+
+	if (result.canceled)
+	{
+		m_parent->statusBar()->showMessage(tr("Analytics canceled"), 3000);
+		return;
+	}
+
+	if (!CGraphAnalytics::apply(result, *adjacency, *m_scene))
+	{
+		QMessageBox::warning(m_parent, tr("Analytics"), tr("The graph has been changed during the computation, please try again."));
+		return;
+	}
+
+	if (metrics & CGraphAnalytics::Components)
+		m_parent->statusBar()->showMessage(tr("Analytics done: %1 connected component(s)").arg(result.componentCount), 3000);
+	else
+		m_parent->statusBar()->showMessage(tr("Analytics done"), 3000);
+}
@@ -0,0 +1,40 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#pragma once
+
+#include <QObject>
+
+class CMainWindow;
+class CNodeEditorScene;
+
+
+// Graph analytics menu: node metrics are computed by worker threads and stored as node attributes
+
+class CAnalyticsUIController : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit CAnalyticsUIController(CMainWindow *parent, CNodeEditorScene *scene);
+
+private Q_SLOTS:
+	void doDegree();
+	void doComponents();
+	void doPageRank();
+	void doBetweenness();
+	void doClustering();
+	void doAllMetrics();
+
+private:
+	void run(int metrics);
+
+	CMainWindow *m_parent = nullptr;
+	CNodeEditorScene *m_scene = nullptr;
+};
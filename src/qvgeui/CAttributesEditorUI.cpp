@@ -15,11 +15,14 @@ It can be used freely, maintaining the information above.
 #include <qvgelib/CItem.h>
 
 #include <QMessageBox>
+#include <QDataStream>
 
 
 CAttributesEditorUI::CAttributesEditorUI(QWidget *parent) :
 	QWidget(parent),
-	ui(new Ui::CAttributesEditorUI)
+	ui(new Ui::CAttributesEditorUI),
+	m_scene(nullptr),
+	m_updateLock(false)
 {
 	ui->setupUi(this);
 
@@ -46,114 +49,214 @@ CPropertyEditorUIBase* CAttributesEditorUI::getEditor()
 }
 
 
+static QByteArray valueKey(const QVariant& v)
+{
+	// exact binary form: differs for the values which are not equal
+	QByteArray key;
+	QDataStream ds(&key, QIODevice::WriteOnly);
+	ds << v;
+	return key;
+}
+
+
 int CAttributesEditorUI::setupFromItems(CEditorScene& scene, QList<CItem*> &items)
 {
-	QString oldName = ui->Editor->getCurrentTopPropertyName();
+	m_scene = &scene;
 
-	// order of clear() is important!
-	ui->Editor->setUpdatesEnabled(false);
-	ui->Editor->clear();
+	// values could be changed: rebuild the aggregates, but keep the properties
+	m_items.clear();
+	m_attrs.clear();
 
-	m_manager.blockSignals(true);
-	m_manager.clear();
+	for (auto item : items)
+		addItemValues(item);
 
-	m_scene = &scene;
-	m_items = items;
+	return updateProperties();
+}
 
-	struct AttrData
+
+int CAttributesEditorUI::updateFromItems(CEditorScene& scene, const QList<CItem*>& added, const QList<CItem*>& removed)
+{
+	if (m_scene != &scene)
 	{
-		QVariant data;
-        int dataType = -1;
-		bool isSet = false;
-	};
+		// another scene: nothing to update incrementally
+		m_items.clear();
+		m_attrs.clear();
+		m_scene = &scene;
+	}
 
-	QSet<QByteArray> ids;
-	QMap<QByteArray, AttrData> attrs;
+	for (auto item : removed)
+		removeItemValues(item);
 
-	// merge ids
-	for (auto item : items)
+	for (auto item : added)
+		addItemValues(item);
+
+	return updateProperties();
+}
+
+
+void CAttributesEditorUI::addItemValues(CItem* item)
+{
+	if (m_items.contains(item))
+		return;
+
+	const auto& localAttrs = item->getLocalAttributes();
+	m_items[item] = localAttrs;
+
+	for (auto it = localAttrs.constBegin(); it != localAttrs.constEnd(); ++it)
+	{
+		auto& attr = m_attrs[it.key()];
+
+		// trick: float -> double
+		if (it.value().type() == QMetaType::Float)
+			attr.dataType = QMetaType::Double;
+		else
+			attr.dataType = it.value().type();
+
+		attr.typeCounts[attr.dataType]++;
+
+		auto& attrValue = attr.values[valueKey(it.value())];
+		if (attrValue.count++ == 0)
+			attrValue.value = it.value();
+
+		attr.count++;
+	}
+}
+
+
+void CAttributesEditorUI::removeItemValues(CItem* item)
+{
+	auto itemIt = m_items.find(item);
+	if (itemIt == m_items.end())
+		return;
+
+	// do not touch the item itself: use the stored values only
+	const auto& localAttrs = itemIt.value();
+
+	for (auto it = localAttrs.constBegin(); it != localAttrs.constEnd(); ++it)
 	{
-		auto localAttrs = item->getLocalAttributes();
-		ids = ids.unite(localAttrs.keys().toSet());
+		auto attrIt = m_attrs.find(it.key());
+		if (attrIt == m_attrs.end())
+			continue;
+
+		auto& attr = attrIt.value();
+
+		auto valueIt = attr.values.find(valueKey(it.value()));
+		if (valueIt != attr.values.end() && --valueIt.value().count == 0)
+			attr.values.erase(valueIt);
+
+		if (--attr.count == 0)
+		{
+			m_attrs.erase(attrIt);
+			continue;
+		}
+
+		// the type of the removed value could be gone: take one of the remaining ones
+		int dataType = (it.value().type() == QMetaType::Float) ? QMetaType::Double : it.value().type();
+		auto typeIt = attr.typeCounts.find(dataType);
+		if (typeIt != attr.typeCounts.end() && --typeIt.value() == 0)
+		{
+			attr.typeCounts.erase(typeIt);
+
+			if (attr.dataType == dataType && !attr.typeCounts.isEmpty())
+				attr.dataType = attr.typeCounts.constBegin().key();
+		}
 	}
 
-	// merge attrs
-	for (auto id : ids)
+	m_items.erase(itemIt);
+}
+
+
+int CAttributesEditorUI::updateProperties()
+{
+	QString oldName = ui->Editor->getCurrentTopPropertyName();
+
+	ui->Editor->setUpdatesEnabled(false);
+
+	// reused properties must notify the browser, so do not block the manager
+	m_updateLock = true;
+
+	// drop unused properties
+	for (auto it = m_properties.begin(); it != m_properties.end(); )
 	{
-		for (auto item : items)
+		auto attrIt = m_attrs.constFind(it.key());
+
+		// unknown types are shown as strings
+		int dataType = -1;
+		if (attrIt != m_attrs.constEnd())
+			dataType = m_manager.isPropertyTypeSupported(attrIt.value().dataType) ? attrIt.value().dataType : QMetaType::QString;
+
+		if (dataType != it.value()->valueType())
 		{
-			if (item->hasLocalAttribute(id))
-			{
-				auto itemValue = item->getAttribute(id);
-
-				// trick: float -> double
-				if (itemValue.type() == QMetaType::Float)
-					attrs[id].dataType = QMetaType::Double;
-				else
-					attrs[id].dataType = itemValue.type();
-
-
-                if (attrs[id].isSet && attrs[id].data != itemValue)
-                {
-                    attrs[id].data = QVariant();
-                    break;
-                }
-				else
-				{
-					attrs[id].data = itemValue;
-					attrs[id].isSet = true;
-				}
-			}
-			else
-			{
-                attrs[id].data = QVariant();
-				attrs[id].isSet = true;
-			}
+			delete it.value();
+			it = m_properties.erase(it);
 		}
+		else
+			++it;
 	}
 
-	int topCount = 0;
+	// update existing & add new ones, keeping them sorted
+	QtVariantProperty *lastProp = nullptr;
 
-	for (auto it = attrs.constBegin(); it != attrs.constEnd(); ++it)
+	for (auto it = m_attrs.constBegin(); it != m_attrs.constEnd(); ++it)
 	{
-        auto prop = m_manager.addProperty(it.value().dataType, it.key());
-		Q_ASSERT(prop != NULL);
+		const auto& attr = it.value();
 
-		// add as string if unknown
-		if (!prop)
-			prop = m_manager.addProperty(QMetaType::QString, it.key());
+		// common value if every item has the same one, else mixed
+		QVariant value;
+		if (attr.count == m_items.size() && attr.values.size() == 1)
+			value = attr.values.constBegin().value().value;
 
+		auto prop = m_properties.value(it.key());
 		if (!prop)
-			continue;	// ignore
+		{
+			prop = m_manager.addProperty(attr.dataType, it.key());
+			Q_ASSERT(prop != NULL);
 
-		// add 13 commas if double
-		if (it.value().dataType == QMetaType::Double)
-			prop->setAttribute("decimals", 13);
+			// add as string if unknown
+			if (!prop)
+				prop = m_manager.addProperty(QMetaType::QString, it.key());
 
-        prop->setValue(it.value().data);
-		ui->Editor->updateTooltip(prop);
+			if (!prop)
+				continue;	// ignore
+
+			// add 13 commas if double
+			if (attr.dataType == QMetaType::Double)
+				prop->setAttribute("decimals", 13);
+
+			auto item = ui->Editor->insertProperty(prop, lastProp);
+			ui->Editor->setExpanded(item, false);
+
+			m_properties[it.key()] = prop;
+		}
 
-        auto item = ui->Editor->addProperty(prop);
-        ui->Editor->setExpanded(item, false);
+		if (value.isValid())
+		{
+			prop->setValue(value);
+			prop->setModified(false);
+		}
+		else
+		{
+			prop->setValue(QVariant((QVariant::Type)prop->valueType()));
+			prop->setModified(true);
+		}
 
-        if (!it.value().data.isValid())
-            prop->setModified(true);
+		ui->Editor->updateTooltip(prop);
 
-		topCount++;
+		lastProp = prop;
 	}
 
 	ui->Editor->setUpdatesEnabled(true);
 
-    m_manager.blockSignals(false);
+	m_updateLock = false;
 
 	// restore selection
-	if (oldName.size())
+	if (oldName.size() && oldName != ui->Editor->getCurrentTopPropertyName())
 		ui->Editor->selectItemByName(oldName);
 
 	// force update
 	on_Editor_currentItemChanged(ui->Editor->currentItem());
 
-    return topCount;
+	return m_properties.size();
 }
 
 
@@ -174,7 +277,7 @@ void CAttributesEditorUI::on_AddButton_clicked()
 
 	bool used = false;
 
-	for (auto sceneItem : m_items)
+	for (auto sceneItem : m_items.keys())
 	{
         if (sceneItem->hasLocalAttribute(id))
 			continue;
@@ -190,7 +293,8 @@ void CAttributesEditorUI::on_AddButton_clicked()
 	m_scene->addUndoState();
 
 	// rebuild tree
-	setupFromItems(*m_scene, m_items);
+	auto items = m_items.keys();
+	setupFromItems(*m_scene, items);
 
 	// select item
 	ui->Editor->selectItemByName(id);
@@ -240,7 +344,7 @@ void CAttributesEditorUI::on_ChangeButton_clicked()
 			attrValue = QVariant((QVariant::Type)newType);	// we will loose the value but not type
 	}
 
-	for (auto sceneItem : m_items)
+	for (auto sceneItem : m_items.keys())
 	{
 		//if (!sceneItem->hasLocalAttribute(attrId))
 		//	continue;
@@ -281,11 +385,12 @@ void CAttributesEditorUI::on_RemoveButton_clicked()
 	if (r == QMessageBox::Cancel)
 		return;
 
+	m_properties.remove(attrId);
 	delete prop;
 
 	bool used = false;
 
-	for (auto sceneItem : m_items)
+	for (auto sceneItem : m_items.keys())
 	{
 		bool ok = sceneItem->removeAttribute(attrId);
 		if (ok)
@@ -315,6 +420,9 @@ void CAttributesEditorUI::onValueChanged(QtProperty *property, const QVariant &v
 {
 	ui->Editor->updateTooltip(dynamic_cast<QtVariantProperty*>(property));
 
+	if (m_updateLock)
+		return;
+
 	if (!m_scene || m_items.isEmpty())
 		return;
 
@@ -324,7 +432,7 @@ void CAttributesEditorUI::onValueChanged(QtProperty *property, const QVariant &v
 
 	auto attrId = property->propertyName().toLatin1();
 
-	for (auto sceneItem : m_items)
+	for (auto sceneItem : m_items.keys())
 	{
         sceneItem->setAttribute(attrId, val);
 	}
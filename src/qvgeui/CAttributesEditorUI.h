@@ -12,6 +12,9 @@ It can be used freely, maintaining the information above.
 
 #include <QWidget>
 #include <QList>
+#include <QMap>
+#include <QHash>
+#include <QVariant>
 
 #include <QtVariantPropertyManager>
 #include <QtVariantEditorFactory>
@@ -35,6 +38,7 @@ public:
     ~CAttributesEditorUI();
 
     int setupFromItems(CEditorScene& scene, QList<CItem*>& items);
+	int updateFromItems(CEditorScene& scene, const QList<CItem*>& added, const QList<CItem*>& removed);
 
 	CPropertyEditorUIBase* getEditor();
 
@@ -46,10 +50,37 @@ private Q_SLOTS:
     void onValueChanged(QtProperty *property, const QVariant &val);
 
 private:
+	void addItemValues(CItem* item);
+	void removeItemValues(CItem* item);
+	int updateProperties();
+
     Ui::CAttributesEditorUI *ui;
 
     CEditorScene *m_scene;
-	QList<CItem*> m_items;
+	bool m_updateLock;
+
+	// attributes of the items as they were when added (removed items could be already deleted)
+	QHash<CItem*, QMap<QByteArray, QVariant>> m_items;
+
+	// running aggregates of the local attributes over m_items
+	struct AttrValue
+	{
+		QVariant value;
+		int count = 0;
+	};
+
+	struct AttrData
+	{
+		int dataType = -1;
+		int count = 0;
+		QHash<QByteArray, AttrValue> values;
+		QHash<int, int> typeCounts;	// to recompute dataType on removal
+	};
+
+	QMap<QByteArray, AttrData> m_attrs;
+
+	// property widgets are kept & reused between the updates
+	QMap<QByteArray, QtVariantProperty*> m_properties;
 
     QtVariantPropertyManager m_manager;
     QtVariantEditorFactory m_factory;
@@ -12,6 +12,7 @@ It can be used freely, maintaining the information above.
 #include <qvgelib/CNodeEditorScene.h>
 #include <qvgelib/CEdge.h>
 #include <qvgelib/CNode.h>
+#include <qvgelib/CPerfTrace.h>
 
 #include <QDebug>
 #include <QElapsedTimer>
@@ -116,7 +117,8 @@ void CCommutationTable::setScene(CNodeEditorScene* scene)
 void CCommutationTable::connectSignals(CEditorScene* scene)
 {
     connect(scene, SIGNAL(sceneChanged()), this, SLOT(onSceneChanged()), Qt::QueuedConnection);
-    connect(scene, SIGNAL(selectionChanged()), this, SLOT(onSelectionChanged()), Qt::QueuedConnection);
+    connect(scene, SIGNAL(selectionUpdated(const QList<CItem*>&, const QList<CItem*>&)), this, SLOT(onSelectionChanged(const QList<CItem*>&, const QList<CItem*>&)));
+    connect(scene, SIGNAL(itemDestroyed(CItem*)), this, SLOT(onItemDestroyed(CItem*)));
 }
 
 
@@ -136,6 +138,8 @@ void CCommutationTable::onSceneDetached(CEditorScene* scene)
 
 void CCommutationTable::onSceneChanged()
 {
+	PERF_SCOPE("ui.connectionsTable");
+
 	ui.Table->setUpdatesEnabled(false);
 	ui.Table->blockSignals(true);
 
@@ -188,11 +192,77 @@ void CCommutationTable::onSceneChanged()
 	ui.Table->blockSignals(false);
 
 	// update active selections if any
-	onSelectionChanged();
+	updateSelection();
+}
+
+
+void CCommutationTable::onSelectionChanged(const QList<CItem*>& added, const QList<CItem*>& removed)
+{
+	ui.Table->setUpdatesEnabled(false);
+	ui.Table->blockSignals(true);
+
+	QTreeWidgetItem* scrollItem = NULL;
+
+	QItemSelection selection, deselection;
+
+	// removed items could be already deleted: lookup only, no casts
+	for (auto item : removed)
+	{
+		auto edgeIt = m_edgeItemMap.constFind(item);
+		if (edgeIt != m_edgeItemMap.constEnd())
+			deselection.append(rowSelection(edgeIt.value()));
+	}
+
+	for (auto item : added)
+	{
+		if (auto edge = dynamic_cast<CEdge*>(item))
+		{
+			auto edgeIt = m_edgeItemMap.constFind(edge);
+			if (edgeIt != m_edgeItemMap.constEnd())
+			{
+				scrollItem = edgeIt.value();
+				selection.append(rowSelection(scrollItem));
+			}
+		}
+	}
+
+	ui.Table->selectionModel()->select(deselection, QItemSelectionModel::Deselect);
+	ui.Table->selectionModel()->select(selection, QItemSelectionModel::Select);
+
+	if (scrollItem)
+		ui.Table->scrollToItem(scrollItem);
+
+	ui.Table->setUpdatesEnabled(true);
+	ui.Table->blockSignals(false);
+}
+
+
+void CCommutationTable::onItemDestroyed(CItem* item)
+{
+	// the item is being destroyed: drop its row, so the pointer is never looked up again
+	auto tableItem = m_edgeItemMap.take(item);
+	if (tableItem)
+	{
+		// do not feed the selection change back into the scene while it is deleting items
+		ui.Table->blockSignals(true);
+		delete tableItem;
+		ui.Table->blockSignals(false);
+	}
+}
+
+
+QItemSelection CCommutationTable::rowSelection(QTreeWidgetItem* item) const
+{
+	int row = ui.Table->indexOfTopLevelItem(item);
+
+	QModelIndex leftIndex = ui.Table->model()->index(row, 0);
+	QModelIndex rightIndex = ui.Table->model()->index(row, ui.Table->columnCount() - 1);
+
+	return QItemSelection(leftIndex, rightIndex);
 }
 
 
-void CCommutationTable::onSelectionChanged()
+void CCommutationTable::updateSelection()
 {
 	ui.Table->setUpdatesEnabled(false);
 	ui.Table->blockSignals(true);
@@ -14,10 +14,12 @@ It can be used freely, maintaining the information above.
 #include <QMap>
 #include <QList>
 #include <QSettings>
+#include <QItemSelection>
 
 class CEditorScene;
 class CNodeEditorScene;
 struct CAttribute;
+class CItem;
 class CEdge;
 
 #include "ui_CCommutationTable.h"
@@ -43,7 +45,8 @@ protected:
 
 protected Q_SLOTS:
 	void onSceneChanged();
-	void onSelectionChanged();
+	void onSelectionChanged(const QList<CItem*>& added, const QList<CItem*>& removed);
+	void onItemDestroyed(CItem* item);
 	void on_Table_itemSelectionChanged();
 	void on_Table_itemDoubleClicked(QTreeWidgetItem *item, int column);
 	void onCustomContextMenu(const QPoint &);
@@ -53,11 +56,15 @@ protected Q_SLOTS:
 	void on_RestoreButton_clicked();
 
 private:
+	void updateSelection();
+	QItemSelection rowSelection(QTreeWidgetItem* item) const;
+
 	Ui::CCommutationTable ui;
 
 	CNodeEditorScene *m_scene;
 
-	QMap<CEdge*, QTreeWidgetItem*> m_edgeItemMap;
+	// keyed by CItem* to never cast destroyed items
+	QMap<CItem*, QTreeWidgetItem*> m_edgeItemMap;
 	
 	QByteArrayList m_extraSectionIds;
 };
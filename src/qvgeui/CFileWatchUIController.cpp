@@ -0,0 +1,294 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#include "CFileWatchUIController.h"
+
+#include <appbase/CMainWindow.h>
+
+#include <qvgeioui/CImportExportUIController.h>
+
+#include <qvgelib/CNodeEditorScene.h>
+#include <qvgelib/CPerfTrace.h>
+
+#include <QMenu>
+#include <QStatusBar>
+#include <QFileInfo>
+#include <QtConcurrent/QtConcurrentRun>
+
+
+// the writers may need several steps to rewrite the file (ms)
+static const int reloadDelay = 300;
+
+
+CFileWatchUIController::CFileWatchUIController(CMainWindow *parent, CNodeEditorScene *scene) :
+	QObject(parent),
+	m_parent(parent), m_scene(scene)
+{
+	connect(&m_watcher, &QFileSystemWatcher::fileChanged, this, &CFileWatchUIController::onFileChanged);
+
+	m_reloadTimer.setSingleShot(true);
+	m_reloadTimer.setInterval(reloadDelay);
+	connect(&m_reloadTimer, &QTimer::timeout, this, &CFileWatchUIController::reload);
+
+	connect(&m_parseWatcher, &QFutureWatcher<ParseResult>::finished, this, &CFileWatchUIController::onParsed);
+	connect(&m_diffWatcher, &QFutureWatcher<CGraphDiff>::finished, this, &CFileWatchUIController::onCompared);
+
+	// after the export actions
+	QMenu *fileMenu = m_parent->getFileMenu();
+	QList<QAction*> fileActions = fileMenu->actions();
+	QAction *nextAction = fileActions.value(fileActions.indexOf(m_parent->getFileExportAction()) + 1);
+
+	m_watchAction = new QAction(tr("&Reload on File Change"), this);
+	m_watchAction->setCheckable(true);
+	m_watchAction->setStatusTip(tr("Applies the changes of the document file made by other programs, keeping the view"));
+	connect(m_watchAction, &QAction::toggled, this, &CFileWatchUIController::onWatchToggled);
+
+	fileMenu->insertAction(nextAction, m_watchAction);
+	fileMenu->insertSeparator(m_watchAction);
+}
+
+
+void CFileWatchUIController::setFile(const QString &format, const QString &fileName)
+{
+	m_format = format;
+	m_fileName = fileName;
+	m_fileIndex++;
+
+	// CSV & the other import-only formats
+	m_watchAction->setEnabled(m_fileName.isEmpty() || isReloadable());
+
+	rememberFileState();
+
+	watchFile();
+}
+
+
+void CFileWatchUIController::onWatchToggled(bool on)
+{
+	if (on)
+	{
+		// the changes made meanwhile are not applied
+		rememberFileState();
+	}
+
+	watchFile();
+}
+
+
+void CFileWatchUIController::watchFile()
+{
+	if (!m_watcher.files().isEmpty())
+		m_watcher.removePaths(m_watcher.files());
+
+	if (m_watchAction->isChecked() && !m_fileName.isEmpty() && isReloadable() && QFileInfo::exists(m_fileName))
+		m_watcher.addPath(m_fileName);
+}
+
+
+bool CFileWatchUIController::isReloadable() const
+{
+	return CImportExportUIController::graphParser(m_format, m_fileName) || CImportExportUIController::canReadGraphViaScene(m_format);
+}
+
+
+bool CFileWatchUIController::isFileChanged() const
+{
+	QFileInfo fi(m_fileName);
+	return fi.lastModified() != m_lastModified || fi.size() != m_lastSize;
+}
+
+
+void CFileWatchUIController::rememberFileState()
+{
+	QFileInfo fi(m_fileName);
+	m_lastModified = fi.lastModified();
+	m_lastSize = fi.size();
+}
+
+
+// reloading
+
+void CFileWatchUIController::onFileChanged()
+{
+	m_reloadTimer.start();
+}
+
+
+void CFileWatchUIController::reload()
+{
+	if (!m_watchAction->isChecked() || m_fileName.isEmpty() || !isReloadable())
+		return;
+
+	// replaced files (written & renamed) are not watched anymore
+	if (!QFileInfo::exists(m_fileName))
+	{
+		m_reloadTimer.start();
+		return;
+	}
+
+	if (!m_watcher.files().contains(m_fileName))
+		m_watcher.addPath(m_fileName);
+
+	if (m_busy)
+	{
+		m_reloadAgain = true;
+		return;
+	}
+
+	// the scene is being generated: later
+	if (m_scene->isBuildingFromGraph())
+	{
+		m_reloadTimer.start();
+		return;
+	}
+
+	// i.e. the own save
+	if (!isFileChanged())
+		return;
+
+	rememberFileState();
+
+	m_busy = true;
+	m_reloadAgain = false;
+	m_reloadIndex = m_fileIndex;
+
+	CAsyncGraphLoader::Parser parser = CImportExportUIController::graphParser(m_format, m_fileName);
+	if (!parser)
+	{
+		// the formats read by the scene itself: by the GUI thread, only the diff is done by a worker
+		QSharedPointer<Graph> graph(new Graph);
+		QString lastError;
+
+		bool ok = false;
+		{
+			PERF_SCOPE("io.reload.parse");
+
+			ok = CImportExportUIController::readGraphViaScene(m_format, m_fileName, *graph, &lastError);
+		}
+
+		if (!ok)
+		{
+			// could be written at the moment: the next change is waited for
+			m_parent->statusBar()->showMessage(tr("File could not be reloaded: %1").arg(lastError), 3000);
+			finish();
+			return;
+		}
+
+		compare(graph);
+		return;
+	}
+
+	m_parseWatcher.setFuture(QtConcurrent::run([parser]()
+	{
+		PERF_SCOPE("io.reload.parse");
+
+		ParseResult result;
+		result.graph.reset(new Graph);
+
+		// must not reach the GUI thread
+		try
+		{
+			result.ok = parser(*result.graph, &result.lastError);
+		}
+		catch (...)
+		{
+			result.ok = false;
+		}
+
+		return result;
+	}));
+}
+
+
+void CFileWatchUIController::onParsed()
+{
+	ParseResult result = m_parseWatcher.result();
+
+	// another document meanwhile
+	if (m_reloadIndex != m_fileIndex)
+	{
+		finish();
+		return;
+	}
+
+	if (!result.ok)
+	{
+		// could be written at the moment: the next change is waited for
+		m_parent->statusBar()->showMessage(tr("File could not be reloaded: %1").arg(result.lastError), 3000);
+		finish();
+		return;
+	}
+
+	compare(result.graph);
+}
+
+
+void CFileWatchUIController::compare(QSharedPointer<Graph> graph)
+{
+	m_graph = graph;
+
+	// the scene as it is now
+	QSharedPointer<Graph> current(new Graph);
+	m_scene->toGraph(*current);
+	m_revision = m_scene->getStateRevision();
+
+	m_diffWatcher.setFuture(QtConcurrent::run([current, graph]()
+	{
+		PERF_SCOPE("io.reload.diff");
+
+		return CGraphDiff::compute(*current, *graph);
+	}));
+}
+
+
+void CFileWatchUIController::onCompared()
+{
+	// another document or a generated graph meanwhile
+	if (m_reloadIndex != m_fileIndex || m_scene->isBuildingFromGraph())
+	{
+		finish();
+		return;
+	}
+
+	// edited meanwhile (not only the topology): compare again
+	if (m_scene->getStateRevision() != m_revision)
+	{
+		compare(m_graph);
+		return;
+	}
+
+	CGraphDiff diff = m_diffWatcher.result();
+
+	if (diff.isEmpty())
+	{
+		m_parent->statusBar()->showMessage(tr("File reloaded: no changes"), 3000);
+	}
+	else
+	{
+		m_scene->updateFromGraph(*m_graph, diff);
+
+		m_parent->statusBar()->showMessage(tr("File reloaded: %1 item(s) added, %2 removed, %3 changed")
+			.arg(diff.addedNodes.size() + diff.addedEdges.size())
+			.arg(diff.removedNodes.size() + diff.removedEdges.size())
+			.arg(diff.changedNodes.size() + diff.changedEdges.size()), 3000);
+	}
+
+	finish();
+}
+
+
+void CFileWatchUIController::finish()
+{
+	m_busy = false;
+	m_graph.clear();
+
+	// changed again while reloading
+	if (m_reloadAgain)
+		m_reloadTimer.start();
+}
@@ -0,0 +1,87 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#pragma once
+
+#include <QObject>
+#include <QFileSystemWatcher>
+#include <QFutureWatcher>
+#include <QSharedPointer>
+#include <QDateTime>
+#include <QTimer>
+
+#include <qvgeio/CGraphDiff.h>
+
+class QAction;
+class CMainWindow;
+class CNodeEditorScene;
+
+
+// Watch mode of the document file: when the file is rewritten by another program, it is parsed
+// by a worker thread and only the difference to the scene (by the node & edge ids) is applied,
+// as one undoable step. The view, the selection and the rest of the items stay untouched.
+// The formats without a Graph model parser (XGR, XGRJ, GEXF) are read by the GUI thread instead.
+
+class CFileWatchUIController : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit CFileWatchUIController(CMainWindow *parent, CNodeEditorScene *scene);
+
+	// the document file, called after it has been loaded or saved (so the own saves are not reloaded);
+	// empty while another document is loading: a running reload is dropped then
+	void setFile(const QString &format, const QString &fileName);
+
+private Q_SLOTS:
+	void onWatchToggled(bool on);
+	void onFileChanged();
+	void reload();
+	void onParsed();
+	void onCompared();
+
+private:
+	struct ParseResult
+	{
+		QSharedPointer<Graph> graph;
+		bool ok = false;
+		QString lastError;
+	};
+
+	void watchFile();
+	bool isReloadable() const;
+	bool isFileChanged() const;
+	void rememberFileState();
+
+	void compare(QSharedPointer<Graph> graph);
+	void finish();
+
+	CMainWindow *m_parent = nullptr;
+	CNodeEditorScene *m_scene = nullptr;
+	QAction *m_watchAction = nullptr;
+
+	QString m_format, m_fileName;
+
+	// state of the file as loaded, saved or reloaded
+	QDateTime m_lastModified;
+	qint64 m_lastSize = -1;
+
+	QFileSystemWatcher m_watcher;
+	QTimer m_reloadTimer;
+
+	// reloading
+	bool m_busy = false;
+	bool m_reloadAgain = false;
+	int m_fileIndex = 0;		// changed by setFile(): the running reload is stale then
+	int m_reloadIndex = 0;
+	quint64 m_revision = 0;
+	QSharedPointer<Graph> m_graph;
+	QFutureWatcher<ParseResult> m_parseWatcher;
+	QFutureWatcher<CGraphDiff> m_diffWatcher;
+};
@@ -0,0 +1,395 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#include "CGraphCompareUIController.h"
+
+#include <appbase/CMainWindow.h>
+
+#include <qvgeioui/CImportExportUIController.h>
+
+#include <qvgelib/CNodeEditorScene.h>
+#include <qvgelib/CNode.h>
+#include <qvgelib/CEdge.h>
+#include <qvgelib/CPerfTrace.h>
+
+#include <QMenu>
+#include <QStatusBar>
+#include <QMessageBox>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QDir>
+#include <QProgressDialog>
+#include <QEventLoop>
+#include <QFutureWatcher>
+#include <QAtomicInt>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QDockWidget>
+#include <QTreeWidget>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QVBoxLayout>
+
+
+// more items of a kind are only counted in the report
+static const int maxListedItems = 10000;
+
+static const QColor addedColor(0, 170, 0);
+static const QColor changedColor(255, 140, 0);
+static const QColor removedColor(220, 0, 0);
+
+// data of the report items
+static const int idRole = Qt::UserRole;
+static const int kindRole = Qt::UserRole + 1;
+
+
+static QString valueText(const QVariant& value)
+{
+	return value.isValid() ? value.toString() : QString();
+}
+
+
+CGraphCompareUIController::CGraphCompareUIController(CMainWindow *parent, CNodeEditorScene *scene) :
+	QObject(parent),
+	m_parent(parent), m_scene(scene)
+{
+	// after the export actions
+	QMenu *fileMenu = m_parent->getFileMenu();
+	QList<QAction*> fileActions = fileMenu->actions();
+	QAction *nextAction = fileActions.value(fileActions.indexOf(m_parent->getFileExportAction()) + 1);
+
+	QAction *compareAction = new QAction(tr("&Compare with File..."), this);
+	compareAction->setStatusTip(tr("Shows the nodes & edges added, removed or changed since another version of the document"));
+	connect(compareAction, &QAction::triggered, this, &CGraphCompareUIController::compareWithFile);
+
+	fileMenu->insertAction(nextAction, compareAction);
+	fileMenu->insertSeparator(compareAction);
+
+	// report panel
+	QWidget *reportPanel = new QWidget(m_parent);
+	QVBoxLayout *reportLayout = new QVBoxLayout(reportPanel);
+	reportLayout->setContentsMargins(0, 0, 0, 0);
+
+	m_summaryLabel = new QLabel(reportPanel);
+	m_summaryLabel->setWordWrap(true);
+	reportLayout->addWidget(m_summaryLabel);
+
+	m_reportTree = new QTreeWidget(reportPanel);
+	m_reportTree->setHeaderLabels({ tr("Item"), tr("Old Value"), tr("New Value") });
+	m_reportTree->setUniformRowHeights(true);
+	m_reportTree->header()->setSectionResizeMode(QHeaderView::Interactive);
+	m_reportTree->setToolTip(tr("Double click to select the item in the scene"));
+	connect(m_reportTree, &QTreeWidget::itemActivated, this, &CGraphCompareUIController::onReportItemActivated);
+	reportLayout->addWidget(m_reportTree);
+
+	QPushButton *clearButton = new QPushButton(tr("Clear Comparison"), reportPanel);
+	connect(clearButton, &QPushButton::clicked, this, &CGraphCompareUIController::clearComparison);
+	reportLayout->addWidget(clearButton);
+
+	m_reportDock = m_parent->createDockWindow("compareDock", tr("Comparison"), Qt::BottomDockWidgetArea, reportPanel);
+	m_reportDock->hide();
+}
+
+
+void CGraphCompareUIController::compareWithFile()
+{
+	QString fileName = QFileDialog::getOpenFileName(m_parent, tr("Compare with File"), QString(),
+		tr("Graph files (*.graphml *.xgr *.gexf *.dot *.gv *.plain *.txt)"));
+	if (fileName.isEmpty())
+		return;
+
+	QString format = QFileInfo(fileName).suffix().toLower();
+
+	// the document as it is now: the newer version
+	QSharedPointer<Graph> current(new Graph);
+	m_scene->toGraph(*current);
+
+	QSharedPointer<Graph> other(new Graph);
+
+	// modal from the start: the scene may not be edited meanwhile
+	QProgressDialog progressDialog(tr("Comparing with %1...").arg(QFileInfo(fileName).fileName()), tr("Cancel"), 0, 0, m_parent);
+	progressDialog.setWindowTitle(tr("Compare with File"));
+	progressDialog.setWindowModality(Qt::WindowModal);
+	progressDialog.setMinimumDuration(0);
+	progressDialog.setAutoClose(false);
+	progressDialog.setAutoReset(false);
+	progressDialog.show();
+	progressDialog.setValue(0);
+
+	// the formats read by the scene itself: by the GUI thread, behind the dialog
+	CAsyncGraphLoader::Parser parser = CImportExportUIController::graphParser(format, fileName);
+	if (!parser)
+	{
+		QString lastError;
+		if (!CImportExportUIController::readGraphViaScene(format, fileName, *other, &lastError))
+		{
+			progressDialog.hide();
+
+			QMessageBox::critical(m_parent, tr("Compare with File"), tr("File could not be read: %1").arg(lastError));
+			return;
+		}
+	}
+
+	// parsing & matching by a worker thread
+	QSharedPointer<QAtomicInt> canceled(new QAtomicInt(0));
+
+	QFutureWatcher<CompareResult> watcher;
+	QEventLoop loop;
+	connect(&watcher, &QFutureWatcher<CompareResult>::finished, &loop, &QEventLoop::quit);
+
+	connect(&progressDialog, &QProgressDialog::canceled, &loop, [&]()
+	{
+		canceled->storeRelease(1);
+
+		// hidden by the cancel: modal again until the worker stops
+		progressDialog.setLabelText(tr("Canceling..."));
+		progressDialog.show();
+	});
+
+	watcher.setFuture(QtConcurrent::run([parser, current, other, canceled]()
+	{
+		PERF_SCOPE("compare.file");
+
+		CompareResult result;
+		result.ok = true;
+
+		// must not reach the GUI thread
+		if (parser)
+		{
+			try
+			{
+				result.ok = parser(*other, &result.lastError);
+			}
+			catch (...)
+			{
+				result.ok = false;
+			}
+		}
+
+		// the parser cannot be interrupted, the matching is skipped at least
+		if (result.ok && !canceled->loadAcquire())
+			result.diff = CGraphDiff::compute(*other, *current);
+
+		return result;
+	}));
+
+	if (!watcher.isFinished())
+		loop.exec();
+
+	progressDialog.hide();
+
+	if (canceled->loadAcquire())
+	{
+		m_parent->statusBar()->showMessage(tr("Comparison canceled"), 3000);
+		return;
+	}
+
+	CompareResult result = watcher.result();
+	if (!result.ok)
+	{
+		QMessageBox::critical(m_parent, tr("Compare with File"), tr("File could not be read: %1").arg(result.lastError));
+		return;
+	}
+
+	highlight(result.diff, *current);
+
+	m_summaryLabel->setText(tr("Compared with %1 (older version)").arg(QDir::toNativeSeparators(fileName)));
+
+	showReport(result.diff, *current, *other);
+
+	m_parent->statusBar()->showMessage(tr("Comparison: %1 difference(s)").arg(result.diff.size()), 3000);
+}
+
+
+void CGraphCompareUIController::clearComparison()
+{
+	m_scene->clearItemHighlights();
+
+	m_reportTree->clear();
+	m_summaryLabel->clear();
+
+	m_reportDock->hide();
+}
+
+
+void CGraphCompareUIController::highlight(const CGraphDiff& diff, const Graph& current)
+{
+	PERF_SCOPE("compare.highlight");
+
+	// the ids as given by toGraph()
+	QHash<QByteArray, CItem*> nodes, edges;
+	for (CNode* node : m_scene->getItems<CNode>())
+		nodes.insert(node->getId().toUtf8(), node);
+	for (CEdge* edge : m_scene->getItems<CEdge>())
+		edges.insert(edge->getId().toUtf8(), edge);
+
+	QHash<CItem*, QColor> highlights;
+
+	auto mark = [&highlights](CItem* item, const QColor& color)
+	{
+		if (item)
+			highlights[item] = color;
+	};
+
+	for (int index : diff.addedNodes)
+		mark(nodes.value(current.nodes.at(index).id), addedColor);
+
+	for (int index : diff.addedEdges)
+		mark(edges.value(current.edges.at(index).id), addedColor);
+
+	for (const CGraphDiff::Change& change : diff.changedNodes)
+		mark(nodes.value(change.id), changedColor);
+
+	for (const CGraphDiff::Change& change : diff.changedEdges)
+		mark(edges.value(change.id), changedColor);
+
+	m_scene->setItemHighlights(highlights);
+}
+
+
+void CGraphCompareUIController::showReport(const CGraphDiff& diff, const Graph& current, const Graph& other)
+{
+	PERF_SCOPE("compare.report");
+
+	m_reportTree->setUpdatesEnabled(false);
+	m_reportTree->clear();
+
+	auto addGroup = [this](const QString& title, int count, const QColor& color)
+	{
+		QTreeWidgetItem *group = new QTreeWidgetItem(m_reportTree, { tr("%1 (%2)").arg(title).arg(count) });
+		group->setForeground(0, color);
+		group->setFirstColumnSpanned(true);
+		return group;
+	};
+
+	auto addItem = [](QTreeWidgetItem *group, const QString& text, const QByteArray& id, const char* kind)
+	{
+		// the rest is counted only
+		if (group->childCount() == maxListedItems)
+		{
+			QTreeWidgetItem *more = new QTreeWidgetItem(group, { tr("...") });
+			more->setFirstColumnSpanned(true);
+		}
+
+		if (group->childCount() > maxListedItems)
+			return (QTreeWidgetItem*)nullptr;
+
+		QTreeWidgetItem *item = new QTreeWidgetItem(group, { text });
+		item->setData(0, idRole, QString(id));
+		item->setData(0, kindRole, QByteArray(kind));
+		return item;
+	};
+
+	auto edgeText = [](const Edge& edge)
+	{
+		return QString("%1 (%2 -> %3)").arg(QString(edge.id), QString(edge.startNodeId), QString(edge.endNodeId));
+	};
+
+	auto addChanges = [&](QTreeWidgetItem *group, const QList<CGraphDiff::Change>& changes, const char* kind)
+	{
+		for (const CGraphDiff::Change& change : changes)
+		{
+			QTreeWidgetItem *item = addItem(group, QString(change.id), change.id, kind);
+			if (!item)
+				break;
+
+			for (auto it = change.set.constBegin(); it != change.set.constEnd(); ++it)
+				new QTreeWidgetItem(item, { QString(it.key()), valueText(change.old.value(it.key())), valueText(it.value()) });
+
+			for (const QByteArray& attrId : change.removed)
+				new QTreeWidgetItem(item, { QString(attrId), valueText(change.old.value(attrId)), tr("(removed)") });
+		}
+	};
+
+	// nodes
+	QTreeWidgetItem *group = addGroup(tr("Added Nodes"), diff.addedNodes.size(), addedColor);
+	for (int index : diff.addedNodes)
+	{
+		const QByteArray& id = current.nodes.at(index).id;
+		if (!addItem(group, QString(id), id, "node"))
+			break;
+	}
+
+	// not in the scene anymore
+	group = addGroup(tr("Removed Nodes"), diff.removedNodes.size(), removedColor);
+	for (const QByteArray& id : diff.removedNodes)
+	{
+		if (!addItem(group, QString(id), QByteArray(), ""))
+			break;
+	}
+
+	group = addGroup(tr("Changed Nodes"), diff.changedNodes.size(), changedColor);
+	addChanges(group, diff.changedNodes, "node");
+
+	// edges
+	group = addGroup(tr("Added Edges"), diff.addedEdges.size(), addedColor);
+	for (int index : diff.addedEdges)
+	{
+		const Edge& edge = current.edges.at(index);
+		if (!addItem(group, edgeText(edge), edge.id, "edge"))
+			break;
+	}
+
+	group = addGroup(tr("Removed Edges"), diff.removedEdges.size(), removedColor);
+	if (diff.removedEdges.size())
+	{
+		QHash<QByteArray, int> otherEdges;
+		otherEdges.reserve(other.edges.size());
+		for (int i = 0; i < other.edges.size(); ++i)
+			otherEdges.insert(other.edges.at(i).id, i);
+
+		for (const QByteArray& id : diff.removedEdges)
+		{
+			int index = otherEdges.value(id, -1);
+			QString text = index < 0 ? QString(id) : edgeText(other.edges.at(index));
+
+			if (!addItem(group, text, QByteArray(), ""))
+				break;
+		}
+	}
+
+	group = addGroup(tr("Changed Edges"), diff.changedEdges.size(), changedColor);
+	addChanges(group, diff.changedEdges, "edge");
+
+	m_reportTree->resizeColumnToContents(0);
+	m_reportTree->setUpdatesEnabled(true);
+
+	m_reportDock->show();
+	m_reportDock->raise();
+}
+
+
+void CGraphCompareUIController::onReportItemActivated(QTreeWidgetItem *reportItem)
+{
+	QString id = reportItem->data(0, idRole).toString();
+	QByteArray kind = reportItem->data(0, kindRole).toByteArray();
+	if (id.isEmpty())
+		return;
+
+	QList<CItem*> items;
+	if (kind == "node")
+	{
+		for (CNode* node : m_scene->getItemsById<CNode>(id))
+			items << node;
+	}
+	else if (kind == "edge")
+	{
+		for (CEdge* edge : m_scene->getItemsById<CEdge>(id))
+			items << edge;
+	}
+
+	if (items.isEmpty())
+	{
+		m_parent->statusBar()->showMessage(tr("%1 is not in the document anymore").arg(id), 3000);
+		return;
+	}
+
+	m_scene->selectItems(items);
+	m_scene->ensureSelectionVisible();
+}
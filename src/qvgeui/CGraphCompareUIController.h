@@ -0,0 +1,57 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#pragma once
+
+#include <QObject>
+
+#include <qvgeio/CGraphDiff.h>
+
+class QLabel;
+class QTreeWidget;
+class QTreeWidgetItem;
+class QDockWidget;
+class CMainWindow;
+class CNodeEditorScene;
+
+
+// Comparison of the document with another version of it: the graphs are matched by the ids
+// of the nodes & edges. The added and changed items are highlighted in the scene, the report
+// panel lists all the differences down to the attribute values.
+
+class CGraphCompareUIController : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit CGraphCompareUIController(CMainWindow *parent, CNodeEditorScene *scene);
+
+private Q_SLOTS:
+	void compareWithFile();
+	void clearComparison();
+	void onReportItemActivated(QTreeWidgetItem *reportItem);
+
+private:
+	struct CompareResult
+	{
+		bool ok = false;
+		QString lastError;
+		CGraphDiff diff;
+	};
+
+	void showReport(const CGraphDiff& diff, const Graph& current, const Graph& other);
+	void highlight(const CGraphDiff& diff, const Graph& current);
+
+	CMainWindow *m_parent = nullptr;
+	CNodeEditorScene *m_scene = nullptr;
+
+	QDockWidget *m_reportDock = nullptr;
+	QLabel *m_summaryLabel = nullptr;
+	QTreeWidget *m_reportTree = nullptr;
+};
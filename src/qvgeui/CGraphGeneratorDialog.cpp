@@ -0,0 +1,111 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#include "CGraphGeneratorDialog.h"
+#include "ui_CGraphGeneratorDialog.h"
+
+#include <qvgeio/CGraphGenerators.h>
+
+#include <QtMath>
+
+
+enum GraphTypes
+{
+	Grid,
+	ErdosRenyi,
+	BarabasiAlbert,
+	Tree,
+	PlantedPartition
+};
+
+
+CGraphGeneratorDialog::CGraphGeneratorDialog(QWidget *parent) :
+	QDialog(parent),
+	ui(new Ui::CGraphGeneratorDialog)
+{
+	ui->setupUi(this);
+
+	QStringList graphTypes;
+	graphTypes << tr("Grid");
+	graphTypes << tr("Random Graph (Erdos-Renyi)");
+	graphTypes << tr("Scale-Free Graph (Barabasi-Albert)");
+	graphTypes << tr("Tree");
+	graphTypes << tr("Planted Partition");
+
+	ui->List->addItems(graphTypes);
+
+	ui->List->setCurrentRow(0);
+}
+
+
+CGraphGeneratorDialog::~CGraphGeneratorDialog()
+{
+	delete ui;
+}
+
+
+void CGraphGeneratorDialog::on_List_itemActivated(QListWidgetItem *item)
+{
+	if (item)
+		accept();
+}
+
+
+void CGraphGeneratorDialog::on_List_currentRowChanged(int currentRow)
+{
+	bool random = (currentRow != Grid && currentRow != Tree);
+
+	ui->Edges->setEnabled(currentRow == ErdosRenyi);
+	ui->Links->setEnabled(currentRow == BarabasiAlbert || currentRow == Tree);
+	ui->Groups->setEnabled(currentRow == PlantedPartition);
+	ui->PIn->setEnabled(currentRow == PlantedPartition);
+	ui->POut->setEnabled(currentRow == PlantedPartition);
+	ui->Seed->setEnabled(random);
+}
+
+
+CGraphGeneratorDialog::Generator CGraphGeneratorDialog::generator() const
+{
+	// values are copied: the dialog may be gone when the generator runs
+	const int nodes = ui->Nodes->value();
+	const int edges = ui->Edges->value();
+	const int links = ui->Links->value();
+	const int groups = ui->Groups->value();
+	const double pIn = ui->PIn->value();
+	const double pOut = ui->POut->value();
+	const quint32 seed = quint32(ui->Seed->value());
+
+	switch (ui->List->currentRow())
+	{
+	case Grid:
+		return [=](Graph& graph)
+		{
+			int rows = qMax(1, int(qSqrt(nodes)));
+			CGraphGenerators::grid(rows, qMax(1, nodes / rows), graph);
+		};
+
+	case ErdosRenyi:
+		return [=](Graph& graph) { CGraphGenerators::erdosRenyi(nodes, edges, graph, seed); };
+
+	case BarabasiAlbert:
+		return [=](Graph& graph) { CGraphGenerators::barabasiAlbert(nodes, links, graph, seed); };
+
+	case Tree:
+		return [=](Graph& graph) { CGraphGenerators::tree(nodes, links, graph); };
+
+	case PlantedPartition:
+		return [=](Graph& graph)
+		{
+			int groupCount = qMin(groups, nodes);
+			CGraphGenerators::plantedPartition(groupCount, nodes / groupCount, pIn, pOut, graph, seed);
+		};
+	}
+
+	return Generator();
+}
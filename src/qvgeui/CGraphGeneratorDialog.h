@@ -0,0 +1,45 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#pragma once
+
+#include <QDialog>
+#include <QListWidgetItem>
+
+#include <functional>
+
+struct Graph;
+
+namespace Ui {
+	class CGraphGeneratorDialog;
+}
+
+
+// Parameters of the built-in graph generators (see CGraphGenerators)
+
+class CGraphGeneratorDialog : public QDialog
+{
+	Q_OBJECT
+
+public:
+	typedef std::function<void(Graph& graph)> Generator;
+
+	explicit CGraphGeneratorDialog(QWidget *parent = nullptr);
+	~CGraphGeneratorDialog();
+
+	// generation with the chosen parameters; may be run by a worker thread
+	Generator generator() const;
+
+private Q_SLOTS:
+	void on_List_currentRowChanged(int currentRow);
+	void on_List_itemActivated(QListWidgetItem *item);
+
+private:
+	Ui::CGraphGeneratorDialog *ui;
+};
@@ -0,0 +1,262 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#include "CLayoutUIController.h"
+#include "CGraphGeneratorDialog.h"
+
+#include <appbase/CMainWindow.h>
+
+#include <qvgelib/CNodeEditorScene.h>
+#include <qvgelib/CNode.h>
+#include <qvgelib/CEdge.h>
+#include <qvgelib/CPolyEdge.h>
+#include <qvgelib/CIncrementalLayout.h>
+#include <qvgelib/CPerfTrace.h>
+#include <qvgelib/CAsyncGraphLoader.h>
+#include <qvgeio/CLayeredLayout.h>
+
+#include <QMenuBar>
+#include <QMenu>
+#include <QStatusBar>
+#include <QApplication>
+#include <QProgressDialog>
+#include <QEventLoop>
+#include <QMessageBox>
+
+
+CLayoutUIController::CLayoutUIController(CMainWindow *parent, CNodeEditorScene *scene) :
+	QObject(parent),
+	m_parent(parent), m_scene(scene)
+{
+	// add layout menu
+	QMenu *layoutMenu = new QMenu(tr("&Layout"));
+	m_parent->menuBar()->insertMenu(m_parent->getWindowMenuAction(), layoutMenu);
+
+	QAction *incrementalAction = layoutMenu->addAction(tr("Incremental Layout"), this, SLOT(doIncrementalLayout()));
+	incrementalAction->setStatusTip(tr("Places the new and the selected nodes, their neighborhood is adjusted, the rest stays in place"));
+
+	layoutMenu->addSeparator();
+
+	QAction *layeredAction = layoutMenu->addAction(tr("Layered Layout (Sugiyama)"), this, SLOT(doLayeredLayout()));
+	layeredAction->setStatusTip(tr("Hierarchical layout of the directed graph, computed on all the CPU cores"));
+
+	layoutMenu->addSeparator();
+
+	QAction *generateAction = layoutMenu->addAction(tr("Generate Graph..."), this, SLOT(generateGraph()));
+	generateAction->setStatusTip(tr("Replaces the document by a synthetic graph (grid, random, scale-free, tree, planted partition)"));
+
+	// new nodes for the incremental layout
+	connect(m_scene, &CEditorScene::itemAdded, this, &CLayoutUIController::onItemAdded);
+	connect(m_scene, &CEditorScene::itemDestroyed, this, &CLayoutUIController::onItemDestroyed);
+}
+
+
+void CLayoutUIController::markLaidOut()
+{
+	m_newNodes.clear();
+}
+
+
+void CLayoutUIController::onItemAdded(CItem* item)
+{
+	if (auto node = dynamic_cast<CNode*>(item))
+		m_newNodes[item] = node;
+}
+
+
+void CLayoutUIController::onItemDestroyed(CItem* item)
+{
+	// the item is being destroyed: no casts, the key only
+	m_newNodes.remove(item);
+}
+
+
+void CLayoutUIController::doIncrementalLayout()
+{
+	// dirty: selected + added after the last layout
+	QSet<CNode*> dirtyNodes;
+
+	for (CNode* node : m_scene->getSelectedNodes())
+		dirtyNodes.insert(node);
+
+	for (CNode* node : m_newNodes)
+	{
+		// could be taken off the scene meanwhile
+		if (node->scene() == m_scene)
+			dirtyNodes.insert(node);
+	}
+
+	if (dirtyNodes.isEmpty())
+	{
+		m_parent->statusBar()->showMessage(tr("Nothing to lay out: add new nodes or select some"), 3000);
+		return;
+	}
+
+	QApplication::setOverrideCursor(Qt::WaitCursor);
+
+	int moved = CIncrementalLayout::run(dirtyNodes, *m_scene);
+
+	QApplication::restoreOverrideCursor();
+
+	if (moved)
+		m_scene->addUndoState();
+
+	markLaidOut();
+
+	m_parent->statusBar()->showMessage(tr("Incremental layout: %1 node(s) moved").arg(moved), 3000);
+
+	Q_EMIT layoutFinished();
+}
+
+
+void CLayoutUIController::doLayeredLayout()
+{
+	PERF_SCOPE("layout.layered");
+
+	QApplication::setOverrideCursor(Qt::WaitCursor);
+
+	// same graph: replay the previous result
+	QByteArray cacheKey = CLayoutCache::topologyKey(*m_scene, "native.layered");
+	if (m_layoutCache.restore(cacheKey, *m_scene))
+	{
+		m_scene->addUndoState();
+
+		QApplication::restoreOverrideCursor();
+
+		Q_EMIT layoutFinished();
+		return;
+	}
+
+	// topology & sizes only
+	Graph graph;
+	QList<CNode*> nodes = m_scene->getItems<CNode>();
+
+	for (const CNode* node : nodes)
+	{
+		Node n;
+		n.id = node->getId().toUtf8();
+		n.attrs["width"] = node->getSize().width();
+		n.attrs["height"] = node->getSize().height();
+		graph.nodes << n;
+	}
+
+	for (const CEdge* edge : m_scene->getItems<CEdge>())
+	{
+		Edge e;
+		e.startNodeId = edge->firstNode()->getId().toUtf8();
+		e.endNodeId = edge->lastNode()->getId().toUtf8();
+		graph.edges << e;
+	}
+
+	CLayeredLayout layout;
+	QString lastError;
+	if (!layout.run(graph, &lastError))
+	{
+		QApplication::restoreOverrideCursor();
+
+		QMessageBox::critical(m_parent, tr("Layout failed"), lastError);
+		return;
+	}
+
+	// the nodes are in the same order
+	for (int i = 0; i < nodes.size(); ++i)
+	{
+		const GraphAttributes& attrs = graph.nodes.at(i).attrs;
+		nodes[i]->setPos(attrs["x"].toDouble(), attrs["y"].toDouble());
+	}
+
+	// old bend points do not fit the new positions: straight edges
+	for (CPolyEdge* edge : m_scene->getItems<CPolyEdge>())
+	{
+		if (edge->getPoints().size())
+			edge->setPoints(QList<QPointF>());
+	}
+
+	m_layoutCache.store(cacheKey, *m_scene);
+
+	m_scene->addUndoState();
+
+	QApplication::restoreOverrideCursor();
+
+	m_parent->statusBar()->showMessage(tr("Layered layout: %1 layer(s), %2 crossing(s)").arg(layout.layerCount()).arg(layout.crossingCount()), 3000);
+
+	Q_EMIT layoutFinished();
+}
+
+
+void CLayoutUIController::generateGraph()
+{
+	CGraphGeneratorDialog dialog(m_parent);
+	if (dialog.exec() == QDialog::Rejected)
+		return;
+
+	CGraphGeneratorDialog::Generator generator = dialog.generator();
+	if (!generator)
+		return;
+
+	// generated by a worker thread, the items are created in slices as by the loading
+	CAsyncGraphLoader loader(*m_scene);
+
+	// modal from the start: the window may not be used while the scene is built
+	QProgressDialog progressDialog(tr("Generating..."), tr("Cancel"), 0, 0, m_parent);
+	progressDialog.setWindowTitle(tr("Generate Graph"));
+	progressDialog.setWindowModality(Qt::WindowModal);
+	progressDialog.setMinimumDuration(0);
+	progressDialog.setAutoClose(false);
+	progressDialog.setAutoReset(false);
+	progressDialog.show();
+
+	connect(&progressDialog, &QProgressDialog::canceled, &loader, &CAsyncGraphLoader::cancel);
+
+	connect(&loader, &CAsyncGraphLoader::progress, &progressDialog, [&](int done, int total)
+	{
+		if (total > 0 && progressDialog.maximum() == 0)
+		{
+			progressDialog.setLabelText(tr("Creating %1 items...").arg(total));
+			progressDialog.setMaximum(total);
+		}
+
+		progressDialog.setValue(done);
+	});
+
+	QEventLoop loop;
+	bool ok = false;
+	QString lastError;
+
+	connect(&loader, &CAsyncGraphLoader::finished, &loop, [&](bool result, const QString& error)
+	{
+		ok = result;
+		lastError = error;
+
+		loop.quit();
+	});
+
+	loader.start([generator](Graph& graph, QString*)
+	{
+		PERF_SCOPE("generate.graph");
+
+		generator(graph);
+		return true;
+	});
+
+	if (loader.isRunning())
+		loop.exec();
+
+	if (!ok)
+	{
+		if (!loader.isCanceled())
+			QMessageBox::critical(m_parent, tr("Generate Graph"), tr("Graph could not be generated: %1").arg(lastError));
+		return;
+	}
+
+	m_parent->statusBar()->showMessage(tr("Generated %1 node(s), %2 edge(s)")
+		.arg(m_scene->getItems<CNode>().size()).arg(m_scene->getItems<CEdge>().size()), 3000);
+
+	Q_EMIT layoutFinished();
+}
@@ -0,0 +1,55 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#pragma once
+
+#include <QObject>
+#include <QHash>
+
+#include <qvgelib/CLayoutCache.h>
+
+class CMainWindow;
+class CNodeEditorScene;
+class CNode;
+class CItem;
+
+
+// Built-in layouts & graph generators (no external engines needed)
+
+class CLayoutUIController : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit CLayoutUIController(CMainWindow *parent, CNodeEditorScene *scene);
+
+Q_SIGNALS:
+	void layoutFinished();
+
+public Q_SLOTS:
+	// the current nodes are not new anymore for the incremental layout
+	void markLaidOut();
+
+private Q_SLOTS:
+	void doIncrementalLayout();
+	void doLayeredLayout();
+	void generateGraph();
+
+	void onItemAdded(CItem* item);
+	void onItemDestroyed(CItem* item);
+
+private:
+	CMainWindow *m_parent = nullptr;
+	CNodeEditorScene *m_scene = nullptr;
+
+	// nodes added after the last layout, tracked by the scene signals (keyed by the items as signaled)
+	QHash<CItem*, CNode*> m_newNodes;
+
+	CLayoutCache m_layoutCache;
+};
@@ -0,0 +1,92 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#include "CLiveUpdateUIController.h"
+
+#include <appbase/CMainWindow.h>
+
+#include <qvgelib/CNodeEditorScene.h>
+#include <qvgelib/CLiveUpdateServer.h>
+
+#include <QMenu>
+#include <QStatusBar>
+#include <QMessageBox>
+#include <QInputDialog>
+
+
+CLiveUpdateUIController::CLiveUpdateUIController(CMainWindow *parent, CNodeEditorScene *scene) :
+	QObject(parent),
+	m_parent(parent),
+	m_server(new CLiveUpdateServer(*scene, this))
+{
+	connect(m_server, &CLiveUpdateServer::clientsChanged, this, &CLiveUpdateUIController::onClientsChanged);
+	connect(m_server, &CLiveUpdateServer::protocolError, this, &CLiveUpdateUIController::onProtocolError);
+
+	// after the export actions
+	QMenu *fileMenu = m_parent->getFileMenu();
+	QList<QAction*> fileActions = fileMenu->actions();
+	QAction *nextAction = fileActions.value(fileActions.indexOf(m_parent->getFileExportAction()) + 1);
+
+	m_serverAction = new QAction(tr("Live &Updates Server"), this);
+	m_serverAction->setCheckable(true);
+	m_serverAction->setStatusTip(tr("Accepts the graph changes streamed by other processes over a local socket"));
+	connect(m_serverAction, &QAction::toggled, this, &CLiveUpdateUIController::onServerToggled);
+
+	fileMenu->insertAction(nextAction, m_serverAction);
+	fileMenu->insertSeparator(m_serverAction);
+}
+
+
+void CLiveUpdateUIController::setPaused(bool on)
+{
+	m_server->setPaused(on);
+}
+
+
+void CLiveUpdateUIController::onServerToggled(bool on)
+{
+	if (!on)
+	{
+		m_server->stop();
+
+		m_parent->statusBar()->showMessage(tr("Live updates stopped"), 3000);
+		return;
+	}
+
+	bool ok = false;
+	QString name = QInputDialog::getText(m_parent, tr("Live Updates Server"), tr("Socket name:"), QLineEdit::Normal, m_serverName, &ok);
+
+	QString lastError;
+	if (ok && !name.isEmpty() && m_server->start(name, &lastError))
+	{
+		m_serverName = name;
+
+		m_parent->statusBar()->showMessage(tr("Live updates: listening at %1").arg(m_server->serverName()), 3000);
+		return;
+	}
+
+	if (ok)
+		QMessageBox::critical(m_parent, tr("Live Updates Server"), tr("Server could not be started: %1").arg(lastError));
+
+	QSignalBlocker blocker(m_serverAction);
+	m_serverAction->setChecked(false);
+}
+
+
+void CLiveUpdateUIController::onClientsChanged(int count)
+{
+	m_parent->statusBar()->showMessage(tr("Live updates: %1 client(s) connected, %2 operation(s) applied")
+		.arg(count).arg(m_server->appliedCount()), 3000);
+}
+
+
+void CLiveUpdateUIController::onProtocolError(const QString& message)
+{
+	m_parent->statusBar()->showMessage(tr("Live updates: %1").arg(message), 3000);
+}
@@ -0,0 +1,43 @@
+/*
+This file is a part of
+QVGE - Qt Visual Graph Editor
+
+(c) 2016-2021 Ars L. Masiuk (ars.masiuk@gmail.com)
+
+It can be used freely, maintaining the information above.
+*/
+
+#pragma once
+
+#include <QObject>
+
+class QAction;
+class CMainWindow;
+class CNodeEditorScene;
+class CLiveUpdateServer;
+
+
+// File menu switch of the live update server: other processes stream the graph changes into the document
+
+class CLiveUpdateUIController : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit CLiveUpdateUIController(CMainWindow *parent, CNodeEditorScene *scene);
+
+	// the received changes wait meanwhile
+	void setPaused(bool on);
+
+private Q_SLOTS:
+	void onServerToggled(bool on);
+	void onClientsChanged(int count);
+	void onProtocolError(const QString& message);
+
+private:
+	CMainWindow *m_parent = nullptr;
+	CLiveUpdateServer *m_server = nullptr;
+	QAction *m_serverAction = nullptr;
+
+	QString m_serverName = "qvge-live";
+};
@@ -142,7 +142,7 @@ void CNodeEdgePropertiesUI::setScene(CNodeEditorScene* scene)
 void CNodeEdgePropertiesUI::connectSignals(CEditorScene* scene)
 {
     connect(scene, SIGNAL(sceneChanged()), this, SLOT(onSceneChanged()));
-    connect(scene, SIGNAL(selectionChanged()), this, SLOT(onSelectionChanged()));
+    connect(scene, SIGNAL(selectionUpdated(const QList<CItem*>&, const QList<CItem*>&)), this, SLOT(onSelectionChanged(const QList<CItem*>&, const QList<CItem*>&)));
 }
 
 
@@ -200,28 +200,125 @@ void CNodeEdgePropertiesUI::onSceneDetached(CEditorScene* scene)
 
 void CNodeEdgePropertiesUI::onSceneChanged()
 {
-    // update active selections if any
-    onSelectionChanged();
+    // update active selections if any (values could be changed)
+	m_addedNodes.clear();
+	m_addedEdges.clear();
+	m_removedNodes.clear();
+	m_removedEdges.clear();
+
+    updateSelection(true);
 }
 
 
-void CNodeEdgePropertiesUI::onSelectionChanged()
+void CNodeEdgePropertiesUI::onSelectionChanged(const QList<CItem*>& added, const QList<CItem*>& removed)
 {
-    if (m_updateLock || m_scene == NULL)
-        return;
+	// only the selection delta has to be taken into account.
+	// it is accumulated until applied, so an item added & removed in between is never shown
+	for (auto item : added)
+	{
+		if (dynamic_cast<CNode*>(item))
+		{
+			if (!m_removedNodes.removeOne(item))
+				m_addedNodes << item;
+
+			m_shownNodes.insert(item);
+		}
+		else if (dynamic_cast<CEdge*>(item))
+		{
+			if (!m_removedEdges.removeOne(item))
+				m_addedEdges << item;
+
+			m_shownEdges.insert(item);
+		}
+	}
+
+	// removed items could be already deleted
+	for (auto item : removed)
+	{
+		if (m_shownNodes.remove(item))
+		{
+			if (!m_addedNodes.removeOne(item))
+				m_removedNodes << item;
+
+			if (m_nodeRep == item)
+				m_nodeRep = nullptr;
+		}
+		else if (m_shownEdges.remove(item))
+		{
+			if (!m_addedEdges.removeOne(item))
+				m_removedEdges << item;
+
+			if (m_edgeRep == item)
+				m_edgeRep = nullptr;
+		}
+	}
+
+    updateSelection(false);
+}
+
+
+static CItem* pickShown(const QSet<CItem*>& shown, CItem* current, const QList<CItem*>& added)
+{
+	if (current)
+		return current;
+
+	if (added.size())
+		return added.first();
+
+	return shown.isEmpty() ? nullptr : *shown.constBegin();
+}
+
+
+void CNodeEdgePropertiesUI::updateSelection(bool fullUpdate)
+{
+	if (m_scene == NULL)
+		return;
+
+	// keep the delta queued (it is not cleared until applied)
+	if (m_updateLock)
+	{
+		m_fullUpdatePending |= fullUpdate;
+		return;
+	}
 
     m_updateLock = true;
 
-    QList<CEdge*> edges = m_scene->getSelectedEdges();
-    QList<CNode*> nodes = m_scene->getSelectedNodes();
+	fullUpdate |= m_fullUpdatePending;
+	m_fullUpdatePending = false;
+
+	QList<CItem*> addedNodes, addedEdges, removedNodes, removedEdges;
+	addedNodes.swap(m_addedNodes);
+	addedEdges.swap(m_addedEdges);
+	removedNodes.swap(m_removedNodes);
+	removedEdges.swap(m_removedEdges);
+
+	int attrCount;
+
+	if (fullUpdate)
+	{
+		QList<CItem*> nodeItems;
+		for (auto item : m_scene->getSelectedNodes()) nodeItems << item;
+
+		m_shownNodes = nodeItems.toSet();
+		m_nodeRep = nodeItems.isEmpty() ? nullptr : nodeItems.first();
+		attrCount = ui->NodeAttrEditor->setupFromItems(*m_scene, nodeItems);
+	}
+	else
+	{
+		// O(delta): the selection itself is not walked
+		m_nodeRep = pickShown(m_shownNodes, m_nodeRep, addedNodes);
+		attrCount = ui->NodeAttrEditor->updateFromItems(*m_scene, addedNodes, removedNodes);
+	}
+
+	ui->NodeAttrBox->setTitle(tr("Custom Attributes: %1").arg(attrCount));
 
 
     // nodes
-    ui->NodesBox->setTitle(tr("Nodes: %1").arg(nodes.count()));
+    ui->NodesBox->setTitle(tr("Nodes: %1").arg(m_shownNodes.size()));
 
-    if (nodes.count())
+    if (m_nodeRep)
     {
-        auto node = nodes.first();
+        auto node = m_nodeRep;
 
         ui->NodeColor->setColor(node->getAttribute("color").value<QColor>());
         ui->NodeShape->selectAction(node->getAttribute("shape"));
@@ -237,18 +334,30 @@ void CNodeEdgePropertiesUI::onSelectionChanged()
 		ui->StrokeSize->setValue(node->getAttribute("stroke.size").toDouble());
     }
 
-    QList<CItem*> nodeItems;
-    for (auto item: nodes) nodeItems << item;
-    int attrCount = ui->NodeAttrEditor->setupFromItems(*m_scene, nodeItems);
-	ui->NodeAttrBox->setTitle(tr("Custom Attributes: %1").arg(attrCount));
-
 
     // edges
-    ui->EdgesBox->setTitle(tr("Edges: %1").arg(edges.count()));
+	if (fullUpdate)
+	{
+		QList<CItem*> edgeItems;
+		for (auto item : m_scene->getSelectedEdges()) edgeItems << item;
+
+		m_shownEdges = edgeItems.toSet();
+		m_edgeRep = edgeItems.isEmpty() ? nullptr : edgeItems.first();
+		attrCount = ui->EdgeAttrEditor->setupFromItems(*m_scene, edgeItems);
+	}
+	else
+	{
+		m_edgeRep = pickShown(m_shownEdges, m_edgeRep, addedEdges);
+		attrCount = ui->EdgeAttrEditor->updateFromItems(*m_scene, addedEdges, removedEdges);
+	}
+
+	ui->EdgeAttrBox->setTitle(tr("Custom Attributes: %1").arg(attrCount));
+
+    ui->EdgesBox->setTitle(tr("Edges: %1").arg(m_shownEdges.size()));
 
-    if (edges.count())
+    if (m_edgeRep)
     {
-        auto edge = edges.first();
+        auto edge = m_edgeRep;
 
         ui->EdgeColor->setColor(edge->getAttribute("color").value<QColor>());
         ui->EdgeWeight->setValue(edge->getAttribute("weight").toDouble());
@@ -256,16 +365,9 @@ void CNodeEdgePropertiesUI::onSelectionChanged()
 		ui->EdgeDirection->selectAction(edge->getAttribute("direction"));
     }
 
-    QList<CItem*> edgeItems;
-    for (auto item: edges) edgeItems << item;
-	attrCount = ui->EdgeAttrEditor->setupFromItems(*m_scene, edgeItems);
-	ui->EdgeAttrBox->setTitle(tr("Custom Attributes: %1").arg(attrCount));
-
 
     // labels
-	CItem* item = nullptr;
-	if (edgeItems.size()) item = edgeItems.first();
-	else if (nodeItems.size()) item = nodeItems.first();
+	CItem* item = m_edgeRep ? m_edgeRep : m_nodeRep;
     if (item) 
 	{
 		QFont f(item->getAttribute(attr_label_font).value<QFont>());
@@ -278,11 +380,15 @@ void CNodeEdgePropertiesUI::onSelectionChanged()
 		ui->LabelFontUnderline->setChecked(f.underline());
 		ui->LabelColor->setColor(item->getAttribute(attr_label_color).value<QColor>());
 		ui->LabelPosition->selectAction(item->getAttribute(attr_label_position).toUInt());
-		ui->LabelPosition->setEnabled(nodes.count());
+		ui->LabelPosition->setEnabled(m_shownNodes.size());
     }
 
     // allow updates
     m_updateLock = false;
+
+	// apply what has been queued meanwhile
+	if (m_fullUpdatePending || m_addedNodes.size() || m_addedEdges.size() || m_removedNodes.size() || m_removedEdges.size())
+		updateSelection(m_fullUpdatePending);
 }
 
 
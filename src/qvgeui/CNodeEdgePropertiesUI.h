@@ -13,6 +13,7 @@ It can be used freely, maintaining the information above.
 #include <QWidget>
 #include <QVariant>
 #include <QSettings>
+#include <QSet>
 
 #include <qvgelib/CNodeEditorScene.h>
 
@@ -20,6 +21,7 @@ class CEditorScene;
 //class CNodeEditorScene;
 class CNode;
 class CEdge;
+class CItem;
 
 
 namespace Ui {
@@ -49,7 +51,7 @@ protected:
 
 protected Q_SLOTS:
     void onSceneChanged();
-    void onSelectionChanged();
+    void onSelectionChanged(const QList<CItem*>& added, const QList<CItem*>& removed);
 
     void on_NodeColor_activated(const QColor &color);
     void on_NodeShape_activated(QVariant data);
@@ -76,12 +78,22 @@ protected Q_SLOTS:
 	void on_LabelPosition_activated(QVariant data);
 
 private:
+	void updateSelection(bool fullUpdate);
+
 	void setNodesAttribute(const QByteArray& attrId, const QVariant& v);
 	void setEdgesAttribute(const QByteArray& attrId, const QVariant& v);
 
     CNodeEditorScene *m_scene;
     bool m_updateLock;
 
+	// items shown in the attribute editors & the selection delta not applied yet
+	QSet<CItem*> m_shownNodes, m_shownEdges;
+	QList<CItem*> m_addedNodes, m_addedEdges, m_removedNodes, m_removedEdges;
+	bool m_fullUpdatePending = false;
+
+	// shown items whose values are put into the widgets
+	CItem *m_nodeRep = nullptr, *m_edgeRep = nullptr;
+
 	CNode *m_nodeFactory;
 	CEdge *m_edgeFactory;
 
@@ -10,6 +10,11 @@ It can be used freely, maintaining the information above.
 #include <CNodeEditorUIController.h>
 #include <CColorSchemesUIController.h>
 #include <CSceneMenuUIController.h>
+#include <CLayoutUIController.h>
+#include <CAnalyticsUIController.h>
+#include <CLiveUpdateUIController.h>
+#include <CFileWatchUIController.h>
+#include <CGraphCompareUIController.h>
 #include <CCommutationTable.h>
 #include <CNodeEdgePropertiesUI.h>
 #include <CClassAttributesEditorUI.h>
@@ -38,11 +43,14 @@ It can be used freely, maintaining the information above.
 #include <qvgelib/CImageExport.h>
 #include <qvgelib/CPDFExport.h>
 #include <qvgelib/CFileSerializerXGR.h>
+#include <qvgelib/CSceneBackup.h>
 #include <qvgelib/CNodeEditorScene.h>
 #include <qvgelib/CNodeSceneActions.h>
 #include <qvgelib/CEditorSceneDefines.h>
 #include <qvgelib/CEditorView.h>
 #include <qvgelib/ISceneItemFactory.h>
+#include <qvgelib/CPerfTrace.h>
+#include <qvgelib/CStallWatchdog.h>
 
 #include <QMenuBar>
 #include <QStatusBar>
@@ -54,7 +62,10 @@ It can be used freely, maintaining the information above.
 #include <QDebug>
 #include <QPixmapCache>
 #include <QFileDialog>
+#include <QDir>
+#include <QMessageBox>
 #include <QTimer>
+#include <QStandardPaths>
 
 
 CNodeEditorUIController::CNodeEditorUIController(CMainWindow *parent) :
@@ -69,7 +80,7 @@ CNodeEditorUIController::CNodeEditorUIController(CMainWindow *parent) :
     // connect scene
     connect(m_editorScene, &CEditorScene::sceneChanged, parent, &CMainWindow::onDocumentChanged);
     connect(m_editorScene, &CEditorScene::sceneChanged, this, &CNodeEditorUIController::onSceneChanged);
-    connect(m_editorScene, &CEditorScene::selectionChanged, this, &CNodeEditorUIController::onSelectionChanged);
+    connect(m_editorScene, &CEditorScene::selectionUpdated, this, &CNodeEditorUIController::onSelectionChanged);
 
     connect(m_editorScene, &CEditorScene::infoStatusChanged, this, &CNodeEditorUIController::onSceneStatusChanged);
     connect(m_editorScene, &CNodeEditorScene::editModeChanged, this, &CNodeEditorUIController::onEditModeChanged);
@@ -109,6 +120,23 @@ CNodeEditorUIController::CNodeEditorUIController(CMainWindow *parent) :
 	m_ioController = new CImportExportUIController(parent);
 
 
+	// built-in layouts
+	m_layoutController = new CLayoutUIController(parent, m_editorScene);
+	connect(m_layoutController, SIGNAL(layoutFinished()), this, SLOT(onLayoutFinished()));
+
+	// built-in analytics
+	m_analyticsController = new CAnalyticsUIController(parent, m_editorScene);
+
+	// streamed changes from other processes
+	m_liveUpdateController = new CLiveUpdateUIController(parent, m_editorScene);
+
+	// reload of the document file changed by other programs
+	m_fileWatchController = new CFileWatchUIController(parent, m_editorScene);
+
+	// comparison with another version of the document
+	m_compareController = new CGraphCompareUIController(parent, m_editorScene);
+
+
     // OGDF
 #ifdef USE_OGDF
     m_ogdfController = new COGDFLayoutUIController(parent, m_editorScene);
@@ -148,6 +176,18 @@ CNodeEditorUIController::CNodeEditorUIController(CMainWindow *parent) :
 
 	// backup timer
 	connect(&m_backupTimer, &QTimer::timeout, this, &CNodeEditorUIController::doBackup);
+
+	m_backup = new CSceneBackup(*m_editorScene, this);
+	connect(m_backup, &CSceneBackup::backupFinished, this, &CNodeEditorUIController::onBackupFinished);
+
+	// normal exit: backup is not needed anymore
+	connect(qApp, &QCoreApplication::aboutToQuit, m_backup, &CSceneBackup::discard);
+
+	// stalls of the GUI are logged locally if enabled, see Help
+	m_watchdog = new CStallWatchdog(this);
+	m_watchdog->setLogFile(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/stalls.log");
+	connect(m_watchdog, &CStallWatchdog::stallDetected, this, &CNodeEditorUIController::onStallDetected);
+	connect(qApp, &QCoreApplication::aboutToQuit, m_watchdog, &CStallWatchdog::stopWatching);
 }
 
 
@@ -160,19 +200,44 @@ CNodeEditorUIController::~CNodeEditorUIController()
 
 bool CNodeEditorUIController::loadFromFile(const QString &format, const QString &fileName, QString* lastError)
 {
-	if (m_ioController)
-		return m_ioController->loadFromFile(format, fileName, *m_editorScene, lastError);
-	else
+	if (!m_ioController)
 		return false;
+
+	// the GUI keeps running while loading: nothing else may touch the half-built scene
+	m_backupTimer.stop();
+	m_liveUpdateController->setPaused(true);
+	m_fileWatchController->setFile(QString(), QString());
+
+	bool ok = m_ioController->loadFromFile(format, fileName, *m_editorScene, lastError);
+
+	m_liveUpdateController->setPaused(false);
+
+	if (m_optionsData.backupPeriod > 0)
+		m_backupTimer.start();
+
+	return ok;
+}
+
+
+bool CNodeEditorUIController::isLoadCanceled() const
+{
+	return m_ioController && m_ioController->isLoadCanceled();
 }
 
 
 bool CNodeEditorUIController::saveToFile(const QString &format, const QString &fileName, QString* lastError)
 {
-	if (m_ioController)
-		return m_ioController->saveToFile(format, fileName, *m_editorScene, lastError);
-	else
-		return false;
+	if (m_ioController && m_ioController->saveToFile(format, fileName, *m_editorScene, lastError))
+	{
+		// saved: backup is not needed anymore
+		m_backup->discard();
+
+		// not to be reloaded
+		m_fileWatchController->setFile(format, fileName);
+		return true;
+	}
+
+	return false;
 }
 
 
@@ -390,6 +455,36 @@ void CNodeEditorUIController::createSelectMenu()
 		auto edges = m_editorScene->getItems<CItem, CEdge>();
 		m_editorScene->selectItems(edges);
 	});
+
+
+	// topology: from the selected nodes
+	selectMenu->addSeparator();
+
+	auto sceneActions = m_editorScene->getActions();
+
+	QAction *selNeighborsAction = selectMenu->addAction(tr("Neighbors"), sceneActions, SLOT(onActionSelectNeighbors()));
+	selNeighborsAction->setStatusTip(tr("Add the adjacent nodes to the selected ones"));
+
+	QAction *selInNeighborsAction = selectMenu->addAction(tr("Incoming Neighbors"), sceneActions, SLOT(onActionSelectInNeighbors()));
+	selInNeighborsAction->setStatusTip(tr("Add the nodes having edges to the selected ones"));
+
+	QAction *selOutNeighborsAction = selectMenu->addAction(tr("Outgoing Neighbors"), sceneActions, SLOT(onActionSelectOutNeighbors()));
+	selOutNeighborsAction->setStatusTip(tr("Add the nodes having edges from the selected ones"));
+
+	QAction *selExpandAction = selectMenu->addAction(tr("Expand by Hops..."), sceneActions, SLOT(onActionExpandSelection()));
+	selExpandAction->setStatusTip(tr("Add the nodes within given number of edges from the selected ones"));
+
+	QAction *selComponentAction = selectMenu->addAction(tr("Connected Component"), sceneActions, SLOT(onActionSelectComponent()));
+	selComponentAction->setStatusTip(tr("Select everything connected to the selected nodes"));
+
+	QAction *selAncestorsAction = selectMenu->addAction(tr("Ancestors"), sceneActions, SLOT(onActionSelectAncestors()));
+	selAncestorsAction->setStatusTip(tr("Select the nodes from which the selected ones can be reached"));
+
+	QAction *selDescendantsAction = selectMenu->addAction(tr("Descendants"), sceneActions, SLOT(onActionSelectDescendants()));
+	selDescendantsAction->setStatusTip(tr("Select the nodes reachable from the selected ones"));
+
+	QAction *selPathAction = selectMenu->addAction(tr("Shortest Path"), sceneActions, SLOT(onActionSelectShortestPath()));
+	selPathAction->setStatusTip(tr("Select the shortest path between two selected nodes"));
 }
 
 
@@ -423,6 +518,12 @@ void CNodeEditorUIController::createViewMenu()
 	m_actionShowEdgeIds->setChecked(m_editorScene->isClassAttributeVisible(class_edge, attr_id));
 	connect(m_actionShowEdgeIds, SIGNAL(toggled(bool)), this, SLOT(showEdgeIds(bool)));
 
+	m_actionShowHUD = m_viewMenu->addAction(tr("Show Performance HUD"));
+	m_actionShowHUD->setCheckable(true);
+	m_actionShowHUD->setStatusTip(tr("Show/hide painting statistics over the scene"));
+	m_actionShowHUD->setChecked(m_editorView->isPerformanceHUDVisible());
+	connect(m_actionShowHUD, &QAction::toggled, m_editorView, &CEditorView::setPerformanceHUDVisible);
+
 	m_viewMenu->addSeparator();
 
 	zoomAction = m_viewMenu->addAction(QIcon(":/Icons/ZoomIn"), tr("&Zoom"));
@@ -472,12 +573,42 @@ void CNodeEditorUIController::createViewMenu()
 }
 
 
+void CNodeEditorUIController::createHelpMenu()
+{
+	QMenu *helpMenu = m_parent->getHelpMenu();
+	QAction *firstAction = helpMenu->actions().first();
+
+	m_traceAction = new QAction(tr("Record Performance &Trace"), helpMenu);
+	m_traceAction->setCheckable(true);
+	m_traceAction->setStatusTip(tr("Record timings of the editor operations and save them for chrome://tracing or Perfetto"));
+	connect(m_traceAction, &QAction::toggled, this, &CNodeEditorUIController::recordTrace);
+
+	helpMenu->insertAction(firstAction, m_traceAction);
+
+	// off by default: the scopes of the GUI thread are tracked while watching
+	m_watchStallsAction = new QAction(tr("&Watch for Stalls"), helpMenu);
+	m_watchStallsAction->setCheckable(true);
+	m_watchStallsAction->setStatusTip(tr("Log the operations which block the editor for too long"));
+	connect(m_watchStallsAction, &QAction::toggled, this, &CNodeEditorUIController::watchStalls);
+
+	helpMenu->insertAction(firstAction, m_watchStallsAction);
+
+	QAction *stallsAction = new QAction(tr("Last &Stalls..."), helpMenu);
+	stallsAction->setStatusTip(tr("Show the operations which blocked the editor recently"));
+	connect(stallsAction, &QAction::triggered, this, &CNodeEditorUIController::showStalls);
+	helpMenu->insertAction(firstAction, stallsAction);
+
+	helpMenu->insertSeparator(firstAction);
+}
+
+
 void CNodeEditorUIController::createMenus()
 {
 	createFileMenu();
 	createEditMenu();
 	createSelectMenu();
 	createViewMenu();
+	createHelpMenu();
 }
 
 
@@ -577,7 +708,7 @@ void CNodeEditorUIController::onNavigatorShown()
 
 void CNodeEditorUIController::onSelectionChanged()
 {
-    int selectionCount = m_editorScene->selectedItems().size();
+    int selectionCount = m_editorScene->getSelectedNodesEdges().size();
 
     fitZoomSelectedAction->setEnabled(selectionCount > 0);
 }
@@ -588,12 +719,108 @@ void CNodeEditorUIController::onSceneChanged()
     auto nodes = m_editorScene->getItems<CNode>();
     auto edges = m_editorScene->getItems<CEdge>();
 
-    m_statusLabel->setText(tr("Nodes: %1 | Edges: %2").arg(nodes.size()).arg(edges.size()));
+    double undoMB = m_editorScene->getUndoMemoryUsage() / (1024.0 * 1024.0);
+
+    m_statusLabel->setText(tr("Nodes: %1 | Edges: %2 | Undo: %3 MB").arg(nodes.size()).arg(edges.size()).arg(undoMB, 0, 'f', 1));
+
+	if (m_watchdog)
+		m_watchdog->setContext(QString("nodes: %1, edges: %2, undo: %3 MB").arg(nodes.size()).arg(edges.size()).arg(undoMB, 0, 'f', 1));
 
 	updateActions();
 }
 
 
+// tracing
+
+void CNodeEditorUIController::recordTrace(bool on)
+{
+	if (on)
+	{
+		CPerfTrace::startTracing();
+
+		m_parent->statusBar()->showMessage(tr("Recording performance trace..."));
+		return;
+	}
+
+	CPerfTrace::stopTracing();
+
+	m_parent->statusBar()->clearMessage();
+
+	QString fileName = QFileDialog::getSaveFileName(m_parent,
+		tr("Save Performance Trace"),
+		QDir::home().filePath("qvge-trace.json"),
+		tr("Trace Event Files (*.json)"));
+
+	if (fileName.isEmpty())
+		return;
+
+	QString lastError;
+	if (!CPerfTrace::writeChromeTrace(fileName, &lastError))
+	{
+		QMessageBox::critical(m_parent, tr("Cannot save trace"), lastError);
+		return;
+	}
+
+	m_parent->statusBar()->showMessage(tr("Trace saved: %1 events").arg(CPerfTrace::eventCount()), 5000);
+}
+
+
+void CNodeEditorUIController::watchStalls(bool on)
+{
+	if (!m_watchdog)
+		return;
+
+	if (on)
+		m_watchdog->startWatching();
+	else
+		m_watchdog->stopWatching();
+}
+
+
+void CNodeEditorUIController::showStalls()
+{
+	QList<CStallWatchdog::Stall> stalls = m_watchdog->lastStalls(50);
+
+	QMessageBox box(QMessageBox::Information, tr("Last Stalls"), QString(), QMessageBox::Ok, m_parent);
+
+	if (stalls.isEmpty())
+	{
+		box.setText(tr("No stalls longer than %1 ms have been detected.").arg(m_watchdog->getThreshold()));
+	}
+	else
+	{
+		const CStallWatchdog::Stall& last = stalls.first();
+		box.setText(tr("%1 stalls (longer than %2 ms) have been logged.\nThe last one: %3 ms in %4 at %5.")
+			.arg(stalls.size())
+			.arg(m_watchdog->getThreshold())
+			.arg(last.duration)
+			.arg(last.operation)
+			.arg(last.time.toString(Qt::DefaultLocaleShortDate)));
+
+		QString details;
+		for (const auto& stall : stalls)
+		{
+			details += QString("%1  %2 ms  %3  [%4]\n")
+				.arg(stall.time.toString(Qt::ISODate))
+				.arg(stall.duration)
+				.arg(stall.operation)
+				.arg(stall.context);
+		}
+
+		box.setDetailedText(details);
+	}
+
+	box.setInformativeText(tr("Log file: %1").arg(QDir::toNativeSeparators(m_watchdog->getLogFile())));
+	box.exec();
+}
+
+
+void CNodeEditorUIController::onStallDetected(int duration, const QString& operation)
+{
+	m_parent->statusBar()->showMessage(tr("The editor was not responding for %1 ms (%2)").arg(duration).arg(operation), 3000);
+}
+
+
 // scene
 
 void CNodeEditorUIController::onSceneHint(const QString& text)
@@ -664,22 +891,33 @@ void CNodeEditorUIController::onEditModeChanged(int mode)
 
 // documents
 
+QString CNodeEditorUIController::getBackupFileName(const QString &fileName) const
+{
+	return CUtils::cutLastSuffix(fileName) + ".bak.xgrj";
+}
+
+
 void CNodeEditorUIController::doBackup()
 {
-	QString backupFileName = m_parent->getCurrentFileName();
-	if (backupFileName.isEmpty()) {
+	// not a half-built scene
+	if (m_editorScene->isBuildingFromGraph())
+		return;
+
+	QString fileName = m_parent->getCurrentFileName();
+	if (fileName.isEmpty()) {
 		m_parent->statusBar()->showMessage(tr("Cannot backup non-saved document"), 2000);
 		return;
 	}
-	else {
-		backupFileName = CUtils::cutLastSuffix(backupFileName) + ".bak.xgr";
-	}
 
-	m_parent->statusBar()->showMessage(tr("Running backup... (%1)").arg(backupFileName));
-	qApp->processEvents();
+	// written in background: only the changes since the last backup are appended
+	m_backup->setFileName(getBackupFileName(fileName));
+	m_backup->backup();
+}
+
 
-	CFileSerializerXGR writer;
-	if (writer.save(backupFileName, *m_editorScene)) {
+void CNodeEditorUIController::onBackupFinished(bool ok, const QString &backupFileName, qint64 /*bytesWritten*/)
+{
+	if (ok) {
 		m_parent->statusBar()->showMessage(tr("Backup done (%1)").arg(backupFileName), 2000);
 	}
 	else {
@@ -688,6 +926,40 @@ void CNodeEditorUIController::doBackup()
 }
 
 
+void CNodeEditorUIController::restoreBackup(const QString &fileName)
+{
+	QString backupFileName = getBackupFileName(fileName);
+	if (!CSceneBackup::hasBackup(backupFileName, fileName))
+		return;
+
+	int r = QMessageBox::question(NULL,
+		tr("Restore Backup"),
+		tr("There are unsaved changes of %1 left from the previous session.\nRestore them?").arg(QFileInfo(fileName).fileName()),
+		QMessageBox::Yes, QMessageBox::No);
+
+	if (r == QMessageBox::No)
+	{
+		QFile::remove(backupFileName);
+		return;
+	}
+
+	QString lastError;
+	if (!CSceneBackup::restore(backupFileName, *m_editorScene, &lastError))
+	{
+		QMessageBox::warning(NULL, tr("Restore Backup"), tr("Backup cannot be restored: %1").arg(lastError));
+		return;
+	}
+
+	// continue the journal from the restored state
+	m_backup->setFileName(backupFileName);
+
+	// restored changes are not saved yet (the document state is reset after loading)
+	QMetaObject::invokeMethod(m_parent, "onDocumentChanged", Qt::QueuedConnection);
+
+	m_parent->statusBar()->showMessage(tr("Backup restored (%1)").arg(backupFileName), 2000);
+}
+
+
 void CNodeEditorUIController::onNewDocumentCreated()
 {
 	readDefaultSceneSettings();
@@ -698,11 +970,15 @@ void CNodeEditorUIController::onNewDocumentCreated()
 
     // store newly created state
     m_editorScene->addUndoState();
+
+	m_layoutController->markLaidOut();
 }
 
 
 void CNodeEditorUIController::onDocumentLoaded(const QString &fileName)
 {
+	m_fileWatchController->setFile(QFileInfo(fileName).suffix().toLower(), fileName);
+
 	QSettings& settings = m_parent->getApplicationSettings();
 
 	// read custom topology of the current document
@@ -730,6 +1006,12 @@ void CNodeEditorUIController::onDocumentLoaded(const QString &fileName)
 	// store newly created state
 	m_editorScene->setInitialState();
 
+	// crash recovery
+	restoreBackup(fileName);
+
+	// positions of the loaded nodes are kept by the incremental layout
+	m_layoutController->markLaidOut();
+
 	// center scene contents
 	m_editorView->centerContent();
 }
@@ -756,6 +1038,9 @@ void CNodeEditorUIController::doReadSettings(QSettings& settings)
 	m_editorScene->setFontAntialiased(isAA);
 
 	m_optionsData.backupPeriod = settings.value("backupPeriod", m_optionsData.backupPeriod).toInt();
+	m_optionsData.undoMemoryBudget = settings.value("undoMemoryBudget", m_optionsData.undoMemoryBudget).toInt();
+
+	m_watchStallsAction->setChecked(settings.value("watchStalls", false).toBool());
 
 	settings.beginGroup("GraphViz");
 	m_optionsData.graphvizPath = settings.value("path", m_optionsData.graphvizPath).toString();
@@ -795,6 +1080,9 @@ void CNodeEditorUIController::doWriteSettings(QSettings& settings)
 	settings.setValue("cacheRam", cacheRam);
 
 	settings.setValue("backupPeriod", m_optionsData.backupPeriod);
+	settings.setValue("undoMemoryBudget", m_optionsData.undoMemoryBudget);
+
+	settings.setValue("watchStalls", m_watchStallsAction->isChecked());
 
 
 	// Graphviz
@@ -933,6 +1221,8 @@ void CNodeEditorUIController::updateSceneOptions()
 	else
 		m_backupTimer.stop();
 
+	m_editorScene->setUndoMemoryBudget(qint64(m_optionsData.undoMemoryBudget) * 1024 * 1024);
+
 	updateActions();
 }
 
@@ -964,6 +1254,8 @@ void CNodeEditorUIController::onLayoutFinished()
 {
 	m_editorScene->crop();
 
+	m_layoutController->markLaidOut();
+
 	// make an option??
 	//m_editorView->fitToView();
 }
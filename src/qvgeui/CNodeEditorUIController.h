@@ -43,6 +43,7 @@ public:
 	void doWriteSettings(QSettings& settings);
 
 	bool loadFromFile(const QString &format, const QString &fileName, QString* lastError);
+	bool isLoadCanceled() const;
 	bool saveToFile(const QString &format, const QString &fileName, QString* lastError);
 
     // callbacks
@@ -64,6 +65,7 @@ private Q_SLOTS:
 	bool importCSV(const QString &fileName, QString* lastError);
 
 	void doBackup();
+	void onBackupFinished(bool ok, const QString &backupFileName, qint64 bytesWritten);
 
 	void onNavigatorShown();
 
@@ -102,12 +104,18 @@ private Q_SLOTS:
 
 	void onLayoutFinished();
 
+	void recordTrace(bool on);
+	void watchStalls(bool on);
+	void showStalls();
+	void onStallDetected(int duration, const QString& operation);
+
 private:
 	void createMenus();
 	void createFileMenu();
 	void createEditMenu();
 	void createSelectMenu();
 	void createViewMenu();
+	void createHelpMenu();
 
 	void createPanels();
     void createNavigator();
@@ -122,6 +130,9 @@ private:
 
 	void editNodePort(CNodePort &port);
 
+	QString getBackupFileName(const QString &fileName) const;
+	void restoreBackup(const QString &fileName);
+
 private:
     CMainWindow *m_parent = nullptr;
 	CNodeEditorScene *m_editorScene = nullptr;
@@ -154,10 +165,23 @@ private:
     QAction *actionShowLabels;
 	QAction *m_actionShowNodeIds;
 	QAction *m_actionShowEdgeIds;
+	QAction *m_actionShowHUD = nullptr;
+
+	QAction *m_traceAction = nullptr;
+	QAction *m_watchStallsAction = nullptr;
 
 	OptionsData m_optionsData;
 
 	QTimer m_backupTimer;
+	class CSceneBackup *m_backup = nullptr;
+
+	class CStallWatchdog *m_watchdog = nullptr;
+
+	class CLayoutUIController *m_layoutController = nullptr;
+	class CAnalyticsUIController *m_analyticsController = nullptr;
+	class CLiveUpdateUIController *m_liveUpdateController = nullptr;
+	class CFileWatchUIController *m_fileWatchController = nullptr;
+	class CGraphCompareUIController *m_compareController = nullptr;
 
 #ifdef USE_OGDF
 	class COGDFLayoutUIController *m_ogdfController = nullptr;
@@ -78,6 +78,19 @@ void CSceneMenuUIController::fillMenu(QMenu &menu, CEditorScene *scene, QGraphic
 	QAction *nodeColorAction = menu.addAction(tr("Node(s) Color..."), sceneActions, SLOT(onActionNodeColor()));
 	nodeColorAction->setEnabled(nodesSelected);
 
+	QMenu *selectMenu = menu.addMenu(tr("Select"));
+	selectMenu->setEnabled(nodesSelected);
+	selectMenu->addAction(tr("Neighbors"), sceneActions, SLOT(onActionSelectNeighbors()));
+	selectMenu->addAction(tr("Incoming Neighbors"), sceneActions, SLOT(onActionSelectInNeighbors()));
+	selectMenu->addAction(tr("Outgoing Neighbors"), sceneActions, SLOT(onActionSelectOutNeighbors()));
+	selectMenu->addAction(tr("Expand by Hops..."), sceneActions, SLOT(onActionExpandSelection()));
+	selectMenu->addSeparator();
+	selectMenu->addAction(tr("Connected Component"), sceneActions, SLOT(onActionSelectComponent()));
+	selectMenu->addAction(tr("Ancestors"), sceneActions, SLOT(onActionSelectAncestors()));
+	selectMenu->addAction(tr("Descendants"), sceneActions, SLOT(onActionSelectDescendants()));
+	QAction *pathAction = selectMenu->addAction(tr("Shortest Path"), sceneActions, SLOT(onActionSelectShortestPath()));
+	pathAction->setEnabled(nodesCount == 2);
+
 	//menu.addSeparator();
 
 	QAction *addPortAction = menu.addAction(tr("Add Port..."), parent(), SLOT(addNodePort()));
@@ -53,6 +53,9 @@ int CSceneOptionsDialog::exec(CEditorScene &scene, CEditorView &view, OptionsDat
 	ui->EnableBackups->setChecked(data.backupPeriod > 0);
 	ui->BackupPeriod->setValue(data.backupPeriod);
 
+	ui->EnableUndoBudget->setChecked(data.undoMemoryBudget > 0);
+	ui->UndoMemoryBudget->setValue(data.undoMemoryBudget > 0 ? data.undoMemoryBudget : 256);
+
 #ifdef USE_GVGRAPH
 	ui->ExtraSection->setVisible(true);
 	ui->GraphvizPath->setObjectsToPick(QSint::PathPicker::PF_EXISTING_DIR);
@@ -83,6 +86,7 @@ int CSceneOptionsDialog::exec(CEditorScene &scene, CEditorView &view, OptionsDat
 	QPixmapCache::setCacheLimit(ui->CacheSlider->value() * 1024);
 
 	data.backupPeriod = ui->EnableBackups->isChecked() ? ui->BackupPeriod->value() : 0;
+	data.undoMemoryBudget = ui->EnableUndoBudget->isChecked() ? ui->UndoMemoryBudget->value() : 0;
 
 #ifdef USE_GVGRAPH
 	data.graphvizPath = ui->GraphvizPath->currentPath();
@@ -24,6 +24,7 @@ class CSceneOptionsDialog;
 struct OptionsData
 {
 	int backupPeriod = 10;
+	int undoMemoryBudget = 256;	// MB, 0: unlimited
 
 	QString graphvizPath;
 	//QStringList graphvizEngines;
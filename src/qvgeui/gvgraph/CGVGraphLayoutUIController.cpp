@@ -6,17 +6,14 @@
 #include <qvgelib/CNode.h>
 #include <qvgelib/CEdge.h>
 #include <qvgelib/CFileSerializerDOT.h>
-#include <qvgelib/CFileSerializerPlainDOT.h>
+#include <qvgelib/CPerfTrace.h>
 #include <qvgeio/CFormatPlainDOT.h>
 
+#include <commonui/CGraphVizProcess.h>
+
 #include <QMenuBar>
 #include <QMenu>
-#include <QProcess>
-#include <QTemporaryFile>
-#include <QCoreApplication>
-#include <QDir>
 #include <QMessageBox>
-#include <QProgressDialog>
 
 
 CGVGraphLayoutUIController::CGVGraphLayoutUIController(CMainWindow *parent, CEditorScene *scene) :
@@ -49,130 +46,59 @@ void CGVGraphLayoutUIController::setDefaultEngine(const QString &engine)
 }
 
 
-QString CGVGraphLayoutUIController::errorNotWritable(const QString &path) const
-{
-	return QObject::tr("Cannot create GraphViz output in %1. Check if the directory is writable.").arg(path);
-}
-
-
-QString CGVGraphLayoutUIController::errorCannotRun(const QString &path) const
-{
-	return QObject::tr("Cannot run %1. Check if GraphViz has been correctly installed.").arg(path);
-}
-
-
-QString CGVGraphLayoutUIController::errorCannotFinish(const QString &path) const
-{
-	return QObject::tr("Execution of %1 took too long and has been therefore cancelled by user.").arg(path);
-}
-
-
-bool CGVGraphLayoutUIController::doRunDOT(const QString &engine, const QString &dotFilePath, QString &plainFilePath, QString* lastError /*= nullptr*/)
+bool CGVGraphLayoutUIController::loadGraph(const QString &filename, CEditorScene &scene, QString* lastError /*= nullptr*/)
 {
-	// run dot to convert filename.dot -> filename.temp.plain	
-	QTemporaryFile tempFile(QDir::tempPath() + "/qvge-XXXXXX.plain");
-	if (!tempFile.open())
-	{
-		if (lastError)
-			*lastError = errorNotWritable(QDir::tempPath());
-
-		return false;
-	}
-
-	plainFilePath = tempFile.fileName();
-	tempFile.setAutoRemove(false);
-
-	QString pathToDot = "dot";
-	if (m_pathToGraphviz.size())
-		pathToDot = m_pathToGraphviz + "/dot";
-
-	QString cmd = QString("\"%1\" -K\"%2\" -Tplain-ext \"%3\" -o\"%4\"").arg(pathToDot, engine).arg(dotFilePath).arg(plainFilePath);
-
-	QProgressDialog progressDialog(tr("Running dot takes longer than expected.\n\nAbort execution?"), tr("Abort"), 0, 100);
-	progressDialog.setWindowModality(Qt::ApplicationModal);
-	progressDialog.setAutoReset(false);
-	progressDialog.setMinimumDuration(1000);
-
-	QProcess process;
-	process.setWorkingDirectory(m_pathToGraphviz);
-	process.start(cmd);
-	process.waitForStarted(1000);
-	while (process.state() != QProcess::NotRunning)
+	// run dot to convert filename.dot -> plain text
+	QByteArray plainText;
 	{
-		process.waitForFinished(100);
-		qApp->processEvents();
-
-		if (progressDialog.wasCanceled())
-		{
-			if (lastError)
-				*lastError = errorCannotFinish(pathToDot);
+		PERF_SCOPE("layout.graphviz.run");
 
+		if (!CGraphVizProcess(m_pathToGraphviz).run(m_defaultEngine, "plain-ext", filename, plainText, lastError))
 			return false;
-		}
-
-		if (progressDialog.isVisible()) {
-			progressDialog.setValue(progressDialog.value() + 1);
-			if (progressDialog.value() > 30)
-				progressDialog.setMaximum(progressDialog.maximum() + 1);
-		}
 	}
 
-	if (process.exitCode() != 0)
-	{
-		if (lastError)
-			*lastError = errorCannotRun(pathToDot);
-
-		return false;
-	}
-
-	// run successful
-	return true;
-}
-
-
-bool CGVGraphLayoutUIController::loadGraph(const QString &filename, CEditorScene &scene, QString* lastError /*= nullptr*/)
-{
-	// run dot to convert filename.dot -> filename.temp.plain	
-	QString plainFilePath;
-	if (!doRunDOT(m_defaultEngine, filename, plainFilePath, lastError))
-		return false;
-
 	// import generated plain text
-	bool ok = CFileSerializerPlainDOT().load(plainFilePath, scene, lastError);
+	Graph graphModel;
+	bool ok = CFormatPlainDOT().parse(plainText.constData(), plainText.size(), graphModel, lastError) && scene.fromGraph(graphModel);
 	if (ok)
 		Q_EMIT loadFinished();
 	else
 		if (lastError)
 			*lastError = tr("Cannot load file content");
 
-	QFile::remove(plainFilePath);
 	return ok;
 }
 
 
 bool CGVGraphLayoutUIController::doLayout(const QString &engine, CEditorScene &scene)
 {
-	QString lastError;
-	QString plainFilePath;
+	PERF_SCOPE("layout.graphviz");
 
-	// export to dot
-	QTemporaryFile tempFile(QDir::tempPath() + "/qvge-XXXXXX.dot");
-	if (!tempFile.open())
+	// same graph & engine: replay the previous result
+	QByteArray cacheKey = CLayoutCache::topologyKey(scene, "graphviz." + engine);
+	if (m_layoutCache.restore(cacheKey, scene))
 	{
-		lastError = errorNotWritable(QDir::tempPath());
-		QMessageBox::critical(m_parent, tr("Layout failed"), lastError);
-		return false;
+		Q_EMIT layoutFinished();
+		return true;
 	}
 
-	bool ok = CFileSerializerDOT().save(tempFile.fileName(), scene, &lastError);
-	if (!ok)
+	QString lastError;
+
+	// export to dot -> convert to plain
+	auto writer = [&scene](QIODevice& input, QString* writeError)
 	{
-		QMessageBox::critical(m_parent, tr("Layout failed"), lastError);
-		return false;
+		return CFileSerializerDOT().write(input, scene, "qvge", writeError);
+	};
+
+	QByteArray plainText;
+	bool ok = false;
+	{
+		PERF_SCOPE("layout.graphviz.run");
+
+		ok = CGraphVizProcess(m_pathToGraphviz).run(engine, "plain-ext", writer, plainText, &lastError);
 	}
 
-	// convert dot -> plain
-	if (!doRunDOT(engine, tempFile.fileName(), plainFilePath, &lastError))
+	if (!ok)
 	{
 		QMessageBox::critical(m_parent, tr("Layout failed"), lastError);
 		return false;
@@ -181,10 +107,8 @@ bool CGVGraphLayoutUIController::doLayout(const QString &engine, CEditorScene &s
 	// import layout only
 	CFormatPlainDOT graphFormat;
 	Graph graphModel;
-	if (!graphFormat.load(plainFilePath, graphModel, &lastError))
+	if (!graphFormat.parse(plainText.constData(), plainText.size(), graphModel, &lastError))
 	{
-		QFile::remove(plainFilePath);
-
 		QMessageBox::critical(m_parent, tr("Layout failed"), lastError);
 		return false;
 	}
@@ -202,9 +126,9 @@ bool CGVGraphLayoutUIController::doLayout(const QString &engine, CEditorScene &s
 		}
 	}
 
-	Q_EMIT layoutFinished();
+	m_layoutCache.store(cacheKey, scene);
 
-	QFile::remove(plainFilePath);
+	Q_EMIT layoutFinished();
 
 	return true;
 }
@@ -212,22 +136,11 @@ bool CGVGraphLayoutUIController::doLayout(const QString &engine, CEditorScene &s
 
 void CGVGraphLayoutUIController::runGraphvizTest(const QString &graphvizPath)
 {
-	QString pathToDot = "dot";
-	if (graphvizPath.size())
-		pathToDot = graphvizPath + "/dot";
-
-	QString cmd = QString("\"%1\" -V").arg(pathToDot);
-
-	QProcess process;
-	process.setProcessChannelMode(QProcess::MergedChannels);
-	process.setWorkingDirectory(graphvizPath);
-	process.start(cmd);
-	bool done = process.waitForFinished(5000);
-	if (done) {
-		QString outputText = process.readAll();
+	QString outputText, lastError;
+	if (CGraphVizProcess(graphvizPath).version(outputText, &lastError)) {
 		QMessageBox::information(nullptr, tr("Test passed"), outputText);
 	}
 	else {
-		QMessageBox::critical(nullptr, tr("Test failed"), tr("Was not able to run %1").arg(cmd));
+		QMessageBox::critical(nullptr, tr("Test failed"), lastError);
 	}
 }
@@ -2,6 +2,8 @@
 
 #include <QObject>
 
+#include <qvgelib/CLayoutCache.h>
+
 class CMainWindow;
 class CEditorScene;
 
@@ -36,14 +38,12 @@ private Q_SLOTS:
 
 private:
 	bool doLayout(const QString &engine, CEditorScene &scene);
-	bool doRunDOT(const QString &engine, const QString &dotFilePath, QString &plainFilePath, QString* lastError /*= nullptr*/);
-	QString errorNotWritable(const QString &path) const;
-	QString errorCannotRun(const QString &path) const;
-	QString errorCannotFinish(const QString &path) const;
 
     CMainWindow *m_parent = nullptr;
     CEditorScene *m_scene = nullptr;
 
 	QString m_pathToGraphviz;
 	QString m_defaultEngine;
+
+	CLayoutCache m_layoutCache;
 };
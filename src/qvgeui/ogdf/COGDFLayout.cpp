@@ -3,6 +3,7 @@
 #include <qvgelib/CNodeEditorScene.h>
 #include <qvgelib/CNode.h>
 #include <qvgelib/CDirectEdge.h>
+#include <qvgelib/CPerfTrace.h>
 
 #include <ogdf/fileformats/GraphIO.h>
 
@@ -71,6 +72,8 @@ static QVariant toVariant(ogdf::StrokeType stroke)
 
 void COGDFLayout::doLayout(ogdf::LayoutModule &layout, CNodeEditorScene &scene)
 {
+	PERF_SCOPE("layout.ogdf");
+
 	QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
 
     ogdf::Graph G;
@@ -46,6 +46,25 @@ COGDFLayoutUIController::COGDFLayoutUIController(CMainWindow *parent, CNodeEdito
 }
 
 
+void COGDFLayoutUIController::runLayout(ogdf::LayoutModule& layout, const QString& layoutName)
+{
+	// same graph & layout: replay the previous result
+	QByteArray cacheKey = CLayoutCache::topologyKey(*m_scene, "ogdf." + layoutName);
+	if (m_layoutCache.restore(cacheKey, *m_scene))
+	{
+		m_scene->setSceneRect(m_scene->itemsBoundingRect());
+		m_scene->addUndoState();
+	}
+	else
+	{
+		COGDFLayout::doLayout(layout, *m_scene);
+		m_layoutCache.store(cacheKey, *m_scene);
+	}
+
+	Q_EMIT layoutFinished();
+}
+
+
 void COGDFLayoutUIController::createNewGraph()
 {
 	COGDFNewGraphDialog dialog;
@@ -56,48 +75,42 @@ void COGDFLayoutUIController::createNewGraph()
 void COGDFLayoutUIController::doPlanarLayout()
 {
     ogdf::PlanarizationLayout layout;
-    COGDFLayout::doLayout(layout, *m_scene);
-    Q_EMIT layoutFinished();
+    runLayout(layout, "planar");
 }
 
 
 void COGDFLayoutUIController::doLinearLayout()
 {
     ogdf::LinearLayout layout;
-    COGDFLayout::doLayout(layout, *m_scene);
-    Q_EMIT layoutFinished();
+    runLayout(layout, "linear");
 }
 
 
 void COGDFLayoutUIController::doBalloonLayout()
 {
     ogdf::BalloonLayout layout;
-    COGDFLayout::doLayout(layout, *m_scene);
-    Q_EMIT layoutFinished();
+    runLayout(layout, "balloon");
 }
 
 
 void COGDFLayoutUIController::doCircularLayout()
 {
     ogdf::CircularLayout layout;
-    COGDFLayout::doLayout(layout, *m_scene);
-    Q_EMIT layoutFinished();
+    runLayout(layout, "circular");
 }
 
 
 void COGDFLayoutUIController::doFMMMLayout()
 {
 	ogdf::FMMMLayout layout;
-    COGDFLayout::doLayout(layout, *m_scene);
-    Q_EMIT layoutFinished();
+    runLayout(layout, "fmmm");
 }
 
 
 void COGDFLayoutUIController::doTreeLayout()
 {
 	ogdf::RadialTreeLayout layout;	// crashing
-	COGDFLayout::doLayout(layout, *m_scene);
-    Q_EMIT layoutFinished();
+	runLayout(layout, "radialtree");
 }
 
 
@@ -106,14 +119,12 @@ void COGDFLayoutUIController::doDHLayout()
 	ogdf::DavidsonHarelLayout layout;
 	//layout.setSpeed(ogdf::DavidsonHarelLayout::SpeedParameter::Fast);
 	//layout.fixSettings(ogdf::DavidsonHarelLayout::SettingsParameter::Repulse);
-	COGDFLayout::doLayout(layout, *m_scene);
-    Q_EMIT layoutFinished();
+	runLayout(layout, "davidsonharel");
 }
 
 
 void COGDFLayoutUIController::doSugiyamaLayout()
 {
 	ogdf::SugiyamaLayout layout;
-	COGDFLayout::doLayout(layout, *m_scene);
-    Q_EMIT layoutFinished();
+	runLayout(layout, "sugiyama");
 }
@@ -3,9 +3,16 @@
 
 #include <QObject>
 
+#include <qvgelib/CLayoutCache.h>
+
 class CMainWindow;
 class CNodeEditorScene;
 
+namespace ogdf
+{
+class LayoutModule;
+}
+
 
 class COGDFLayoutUIController : public QObject
 {
@@ -30,8 +37,12 @@ private Q_SLOTS:
 	void createNewGraph();
 
 private:
+	void runLayout(ogdf::LayoutModule& layout, const QString& layoutName);
+
     CMainWindow *m_parent;
     CNodeEditorScene *m_scene;
+
+	CLayoutCache m_layoutCache;
 };
 
 #endif // COGDFLAYOUTUICONTROLLER_H
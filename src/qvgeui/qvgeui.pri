@@ -28,10 +28,6 @@ message($$OGDF_INCLUDE_PATH)
     FORMS += $$files($$PWD/ogdf/*.ui)
 }
 
-USE_BOOST{
-    INCLUDEPATH += $$BOOST_INCLUDE_PATH
-}
-
 USE_GVGRAPH{
     SOURCES += $$files($$PWD/gvgraph/*.cpp)
     HEADERS += $$files($$PWD/gvgraph/*.h)